@@ -23,6 +23,11 @@
                                 // If your RS485 module has DE/RE pins, 
                                 // change this to the connected GPIO pin number
 
+// Second RS485 transceiver for the Modbus gateway (UART1)
+#define GATEWAY_RX_PIN  25      // GPIO25 - Connect to RXD of the gateway module
+#define GATEWAY_TX_PIN  26      // GPIO26 - Connect to TXD of the gateway module
+#define GATEWAY_DE_PIN  -1      // Direction control pin (-1 = auto control)
+
 // I2C OLED Display Pins
 #define OLED_SDA_PIN    21      // GPIO21 - OLED SDA (data line)
 #define OLED_SCL_PIN    22      // GPIO22 - OLED SCL (clock line)
@@ -34,19 +39,213 @@
 #define SCREEN_HEIGHT   64      // Display height in pixels
 #define OLED_RESET      -1      // Reset pin (-1 = shared with ESP32 reset)
 #define SCREEN_ADDRESS  0x3C    // I2C address (0x3C or 0x3D typically)
+#define OLED_I2C_CLOCK  400000  // I2C clock during display flushes (Hz)
+#define OLED_I2C_CHUNK  127     // Max display data bytes per I2C transaction
+                                // (ESP32 Wire buffer is 128 incl. control byte)
 
 // ==================== SENSOR CONFIGURATION ====================
 
 // XY-MD02 Temperature/Humidity Sensor Settings
-#define SENSOR_ADDRESS      0x01    // Modbus device address (default: 0x01)
-#define SENSOR_BAUD_RATE    9600    // Communication baud rate
-#define SENSOR_TIMEOUT      1000    // Response timeout in milliseconds
+#define SENSOR_ADDRESSES    { 0x01 } // Modbus addresses of all sensors on the
+                                     // RS485 bus, e.g. { 0x01, 0x02, 0x03 }
+#define SENSOR_BAUD_RATE    9600    // Baud rate sensors use out of the box
+#define SENSOR_BAUD_RATES   { 9600, 14400, 19200 } // Rates selectable through the
+                                    // XY-MD02 baud register, indexed by its code;
+                                    // { 9600 } alone disables negotiation
+#define SENSOR_BAUD_PROBE_BURST  8  // Clean polls needed before and after a switch
+#define SENSOR_BAUD_SCAN_AFTER   3  // Consecutive failures before scanning rates
+#define SENSOR_BAUD_RETRY_INTERVAL 3600000 // Retry a failed upshift after an hour
+#define SENSOR_TIMEOUT      1000    // Initial/maximum response timeout in milliseconds
+#define SENSOR_TIMEOUT_MIN  50      // Lower bound for the learned per-sensor timeout
+#define SENSOR_STALE_TIMEOUT 10000  // Readings older than this are treated as lost
+#define SENSOR_FAST_RETRIES  2      // Immediate retries after a corrupted reply
+#define SENSOR_RETRY_INTERVAL     2000  // Retry delay after a failed poll, doubling
+#define SENSOR_RETRY_INTERVAL_MAX 30000 // up to this while failures continue
+#define SENSOR_OFFLINE_AFTER 6      // Failed polls in a row before a sensor is
+                                    // parked as offline (circuit open)
+#define SENSOR_PROBE_INTERVAL 60000 // Time between probes of an offline sensor
+#define SENSOR_READ_MAX_GAP 0       // Unused registers a read may span to merge
+                                    // two ranges into one request; 0 because the
+                                    // XY-MD02 rejects reads of unmapped addresses
+
+// ==================== MODBUS GATEWAY CONFIGURATION ====================
+
+// Answer Modbus RTU reads (0x03 and 0x04 alike) on UART1 from the cached
+// readings, so a PLC can share the data without polling the sensors.
+// Sensor n (in SENSOR_ADDRESSES order) occupies registers n*8 .. n*8+7:
+// temperature, humidity, dew point, heat index, absolute humidity (all
+// 0.1 units, signed), status (bit 0 connected, bit 1 comfort alert),
+// sensor address, age of the reading in seconds
+#define GATEWAY_ENABLED         true
+#define GATEWAY_ADDRESS         0x10    // This monitor's address on the PLC bus
+#define GATEWAY_BAUD_RATE       19200
+#define GATEWAY_RX_TIMEOUT_SYMBOLS 4   // UART idle characters that end a request
+                                        // (at least the 3.5-character frame gap)
+
+// ==================== HTTP STATUS CONFIGURATION ====================
+
+// JSON documents on port HTTP_PORT: /status (current readings), /history
+// (last hour and day per sensor) and /health (counters and link state).
+// Served from buffers serialized once per new sample, never per request
+#define HTTP_ENABLED            true
+#define WIFI_SSID               ""      // Network to join; empty = no WiFi
+#define WIFI_PASSWORD           ""
+#ifndef HTTP_PORT
+#define HTTP_PORT               80      // env:native overrides this
+#endif
+#ifndef HTTP_BIND_LOOPBACK
+#define HTTP_BIND_LOOPBACK      false   // Listen on 127.0.0.1 only (env:native)
+#endif
+#define HTTP_POLL_INTERVAL_MS   50      // Longest socket wait before checking
+                                        // for a new sample to serialize
+#define HTTP_HEALTH_INTERVAL    1000    // Health document refresh (milliseconds)
+
+// ==================== MQTT CONFIGURATION ====================
+
+// Publish the samples of each MQTT_PUBLISH_INTERVAL as one QoS 1 message
+// on MQTT_TOPIC. The payload is a run of COBS telemetry frames (same
+// format as binary mode, decode with tools/telemetry_decode.cpp).
+// Batches wait in a RAM queue while the broker is unreachable; when it
+// fills up the oldest batches are dropped. After a reconnect the backlog
+// is sent at most MQTT_DRAIN_RATE batches per second
+#define MQTT_ENABLED            true
+#ifndef MQTT_BROKER
+#define MQTT_BROKER             ""      // Broker IPv4 address; empty = no MQTT
+#endif
+#ifndef MQTT_PORT
+#define MQTT_PORT               1883
+#endif
+#define MQTT_CLIENT_ID          "room-monitor"
+#define MQTT_TOPIC              "room-monitor/samples"
+#define MQTT_KEEPALIVE          60      // Seconds
+#define MQTT_PUBLISH_INTERVAL   10000   // Batch period (milliseconds)
+#define MQTT_QUEUE_LENGTH       64      // Records between batches (power of two)
+#define MQTT_OUTBOX_BYTES       8192    // Store-and-forward queue (~25 minutes
+                                        // of one sensor at the base rate)
+#define MQTT_DRAIN_RATE         5       // Batches per second after an outage
+#define MQTT_RETRY_MIN          1000    // Reconnect delay, doubling up to
+#define MQTT_RETRY_MAX          60000   // this (milliseconds)
+#define MQTT_POLL_INTERVAL_MS   50      // Longest socket wait
 
 // ==================== TIMING CONFIGURATION ====================
 
 // System Update Intervals (in milliseconds)
-#define SENSOR_READ_INTERVAL     2000   // Read sensor every 2 seconds
+#define SENSOR_READ_INTERVAL     2000   // Read each sensor every 2 seconds while
+                                        // readings change (0 = poll back-to-back)
+#define SENSOR_READ_INTERVAL_MAX 32000  // Back-off ceiling while readings are flat
+                                        // (= SENSOR_READ_INTERVAL: fixed rate)
+
+// Adaptive sampling: a move beyond the deadband, or a reading within the
+// margin of a comfort threshold, returns to SENSOR_READ_INTERVAL; flat
+// readings double the interval up to SENSOR_READ_INTERVAL_MAX
+#define SENSOR_DEADBAND_TEMP        0.2 // °C
+#define SENSOR_DEADBAND_HUMIDITY    1.0 // %RH
+#define SENSOR_MARGIN_TEMP          0.5 // °C from TEMP_MIN/TEMP_MAX
+#define SENSOR_MARGIN_HUMIDITY      2.0 // %RH from HUMIDITY_MIN/HUMIDITY_MAX
 #define DISPLAY_UPDATE_INTERVAL  1000   // Update display every 1 second
+#define DISPLAY_ROTATE_INTERVAL  5000   // Show the next sensor every 5 seconds
+#define DISPLAY_STATS_INTERVAL   60000  // Report display flush statistics every minute
+#define DISPLAY_SPLASH_TIME      2000   // Startup screen stays up at most this long
+                                        // while waiting for the first reading
+#define DISPLAY_SPLASH_POLL_MS   20     // First-reading check interval meanwhile
+
+// ==================== FILTER CONFIGURATION ====================
+
+// Stages each reading passes between decoding and publishing, in this
+// order; OR together the ones to use (0 = publish raw readings)
+#define FILTER_SPIKE    0x01    // Reject implausibly fast changes
+#define FILTER_MEDIAN   0x02    // Sliding median of FILTER_MEDIAN_WINDOW readings
+#define FILTER_EMA      0x04    // Exponential moving average
+#define FILTER_KALMAN   0x08    // Kalman filter (use instead of the EMA)
+#define FILTER_STAGES   (FILTER_SPIKE | FILTER_MEDIAN | FILTER_KALMAN)
+
+#define FILTER_MEDIAN_WINDOW        3   // Readings (odd)
+#define FILTER_EMA_SHIFT            2   // alpha = 1/4
+#define FILTER_SPIKE_CONFIRM        3   // Agreeing outliers accepted as a real step
+
+// Largest plausible change per second, plus a change always allowed
+// regardless of the time step (sensor noise and resolution)
+#define FILTER_SPIKE_RATE_TEMP      0.1 // °C/s
+#define FILTER_SPIKE_RATE_HUMIDITY  1.0 // %RH/s
+#define FILTER_SPIKE_SLACK_TEMP     1.0 // °C
+#define FILTER_SPIKE_SLACK_HUMIDITY 5.0 // %RH
+
+// Kalman tuning: noise of one reading, and how far the true value may
+// drift per square-root second (standard deviations)
+#define FILTER_KALMAN_NOISE_TEMP      0.1  // °C
+#define FILTER_KALMAN_DRIFT_TEMP      0.02 // °C
+#define FILTER_KALMAN_NOISE_HUMIDITY  0.3  // %RH
+#define FILTER_KALMAN_DRIFT_HUMIDITY  0.1  // %RH
+
+// ==================== TASK CONFIGURATION ====================
+
+// FreeRTOS tasks: RS485 acquisition and OLED rendering run on separate cores
+#define ACQUISITION_TASK_CORE       0     // Core for sensor polling
+#define ACQUISITION_TASK_PRIORITY   3     // Above rendering so polls are never delayed
+#define ACQUISITION_TASK_STACK      4096  // Stack size in bytes
+#define RENDER_TASK_CORE            1     // Core for display updates
+#define RENDER_TASK_PRIORITY        1
+#define RENDER_TASK_STACK           4096
+#define GATEWAY_TASK_CORE           1
+#define GATEWAY_TASK_PRIORITY       2     // Above rendering: clients wait on answers
+#define GATEWAY_TASK_STACK          3072
+#define HTTP_TASK_CORE              1
+#define HTTP_TASK_PRIORITY          1     // Same as rendering; clients can wait
+#define HTTP_TASK_STACK             4096
+#define MQTT_TASK_CORE              1
+#define MQTT_TASK_PRIORITY          1     // Never above acquisition: a slow
+#define MQTT_TASK_STACK             4096  // broker only delays publishing
+
+// Tasks sleep until their next job deadline; report how late jobs ran
+#define TIMING_REPORT_INTERVAL      60000 // Milliseconds between timing reports
+
+// Let the idle task enter light sleep between deadlines; the sensor bus
+// is kept awake only while a transaction is in flight (UART2 RX cannot
+// wake the chip). Needs an sdkconfig with CONFIG_PM_ENABLE and
+// CONFIG_FREERTOS_USE_TICKLESS_IDLE; other builds ignore it.
+// The Modbus gateway must hear the first byte of every PLC request and
+// holds the chip awake for good: with GATEWAY_ENABLED it never sleeps.
+#define ENABLE_LIGHT_SLEEP          true
+
+// ==================== LOGGING CONFIGURATION ====================
+
+// Serial log messages are queued and printed by a low-priority task
+// (see lib/Logging/Logger.h). Levels above LOG_LEVEL are compiled out:
+// LOG_LEVEL_NONE, LOG_LEVEL_ERROR, LOG_LEVEL_WARN, LOG_LEVEL_INFO, LOG_LEVEL_DEBUG
+#define LOG_LEVEL               LOG_LEVEL_INFO  // LOG_LEVEL_DEBUG adds Modbus hex dumps
+#define LOG_DRAIN_INTERVAL_MS   20     // Log task wake-up period
+#define LOG_TASK_CORE           1
+#define LOG_TASK_PRIORITY       0      // Idle priority: printing never delays other tasks
+#define LOG_TASK_STACK          3072
+
+// ==================== TELEMETRY CONFIGURATION ====================
+
+// Binary mode replaces the text console with COBS-framed sample records
+// for tools/telemetry_decode.cpp (see lib/Telemetry/TelemetryFrame.h).
+// The "telemetry binary" and "telemetry text" console commands switch
+// modes at runtime
+#define TELEMETRY_BINARY          false
+#define TELEMETRY_QUEUE_LENGTH    64     // Records between flushes (power of two)
+#define TELEMETRY_LOG_LEVEL       LOG_LEVEL_WARN  // Log lines still sent in binary mode
+
+// ==================== HISTORY CONFIGURATION ====================
+
+// In-RAM time series per sensor (see lib/History/SampleHistory.h)
+#define HISTORY_RAW_BYTES       2048   // Encoded raw samples (~4 bytes each),
+                                       // printed by the "history raw" command
+#define HISTORY_MINUTE_SLOTS    120    // Per-minute min/max/avg (2 hours)
+#define HISTORY_HOUR_SLOTS      48     // Per-hour min/max/avg (2 days)
+#define HISTORY_MEMORY_BUDGET   32768  // Upper limit for all sensors (bytes)
+
+// ==================== SAMPLE LOG CONFIGURATION ====================
+
+// Persistent sample log in a flash data partition (see lib/SampleLog/SampleLog.h)
+#define SAMPLE_LOG_PARTITION       "spiffs"  // Data partition label
+#define SAMPLE_LOG_FLUSH_INTERVAL  60000     // Write a partial batch at least every minute
+#define SAMPLE_LOG_QUEUE_LENGTH    64        // Samples buffered between acquisition and storage
+#define STORAGE_TASK_CORE          1         // Flash writes run beside rendering
+#define STORAGE_TASK_PRIORITY      1
+#define STORAGE_TASK_STACK         4096
 
 // ==================== COMFORT ZONE THRESHOLDS ====================
 
@@ -58,6 +257,18 @@
 #define HUMIDITY_MIN    30.0    // Minimum comfortable humidity (%)
 #define HUMIDITY_MAX    60.0    // Maximum comfortable humidity (%)
 
+// Moisture felt regardless of temperature: above this dew point the air
+// is muggy even inside the humidity range; heat index (apparent
+// temperature) above TEMP_MAX counts as too hot
+#define DEW_POINT_MAX   16.0    // Maximum comfortable dew point (°C)
+
+// Comfort states change only once a value has been beyond a limit (or
+// back inside it by the hysteresis band) for COMFORT_MIN_DURATION, so
+// readings hovering on a limit do not make the status flap
+#define COMFORT_HYSTERESIS_TEMP      0.3     // °C (temperature, heat index, dew point)
+#define COMFORT_HYSTERESIS_HUMIDITY  2.0     // %RH
+#define COMFORT_MIN_DURATION         10000   // Milliseconds
+
 // ==================== END OF CONFIGURATION ====================
 
 #endif // CONFIG_H
@@ -0,0 +1,101 @@
+/**
+ * ESP32 Room Climate Monitor - Bounded Multi-producer Ring Buffer
+ *
+ * Lock-free fixed-capacity queue for handing small records from any task
+ * to a single consumer. Producers claim a slot with one compare-and-swap
+ * on the enqueue counter; each slot carries its own sequence number, so
+ * a consumer never reads a slot a producer is still filling and a full
+ * ring is detected without locking (push() fails instead of waiting).
+ *
+ * Based on Dmitry Vyukov's bounded queue. Capacity must be a power of
+ * two. T must be trivially copyable.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+template <typename T, size_t Capacity>
+class MpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "MpscRing capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "MpscRing payload must be trivially copyable");
+
+public:
+  MpscRing() : _enqueuePos(0), _dequeuePos(0) {
+    for (size_t i = 0; i < Capacity; i++) {
+      _slots[i].sequence.store((uint32_t)i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Append a value (any number of producers)
+   *
+   * @return false if the ring is full; the value is not stored
+   */
+  bool push(const T &value) {
+    uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+      slot = &_slots[pos & (Capacity - 1)];
+      uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+      int32_t diff = (int32_t)(sequence - pos);
+      if (diff == 0) {
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // Consumer has not freed this slot yet
+      } else {
+        pos = _enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->value = value;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Remove the oldest value (single consumer only)
+   *
+   * @return false if the ring is empty
+   */
+  bool pop(T &value) {
+    uint32_t pos = _dequeuePos;
+    Slot &slot = _slots[pos & (Capacity - 1)];
+    uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if ((int32_t)(sequence - (pos + 1)) < 0) {
+      return false; // Empty, or the producer is still writing this slot
+    }
+
+    value = slot.value;
+    slot.sequence.store(pos + Capacity, std::memory_order_release);
+    _dequeuePos = pos + 1;
+    return true;
+  }
+
+  static constexpr size_t capacity() { return Capacity; }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> sequence;
+    T value;
+  };
+
+  Slot _slots[Capacity];
+  std::atomic<uint32_t> _enqueuePos;
+  uint32_t _dequeuePos;          // Only touched by the consumer
+};
+
+#endif // MPSC_RING_H
@@ -0,0 +1,74 @@
+/**
+ * ESP32 Room Climate Monitor - Sequence Lock
+ *
+ * Lock-free single-writer / multi-reader snapshot of a small struct.
+ * The writer never blocks or waits for readers; a reader that overlaps
+ * a write sees an odd or changed sequence number and simply retries,
+ * so it can never observe a torn value (e.g. a temperature from one
+ * sample paired with the humidity of another).
+ *
+ * Intended for handing readings from the acquisition task on one core
+ * to the render task on the other. T must be trivially copyable.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock payload must be trivially copyable");
+
+public:
+  SeqLock() : _sequence(0), _value() {}
+
+  /**
+   * Publish a new value (single writer only)
+   */
+  void write(const T &value) {
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed); // Odd: writing
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy((void *)&_value, &value, sizeof(T));
+
+    _sequence.store(sequence + 2, std::memory_order_release); // Even: stable
+  }
+
+  /**
+   * Copy out a consistent value, retrying while a write is in progress
+   */
+  T read() const {
+    T value;
+    uint32_t before, after;
+    do {
+      before = _sequence.load(std::memory_order_acquire);
+      memcpy(&value, (const void *)&_value, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = _sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return value;
+  }
+
+  /**
+   * @return Number of completed writes, usable as a change counter
+   */
+  uint32_t version() const {
+    return _sequence.load(std::memory_order_acquire) >> 1;
+  }
+
+private:
+  std::atomic<uint32_t> _sequence;
+  volatile T _value;
+};
+
+#endif // SEQ_LOCK_H
@@ -0,0 +1,43 @@
+/**
+ * ESP32 Room Climate Monitor - Streaming Filter Pipeline
+ *
+ * See FilterChain.h for how stages are combined.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "FilterChain.h"
+
+FilterChain::FilterChain()
+  : _stages(),
+    _stageCount(0),
+    _accepted(0),
+    _rejected(0) {
+}
+
+bool FilterChain::add(FilterStage *stage) {
+  if (stage == nullptr || _stageCount >= FILTER_CHAIN_MAX_STAGES) {
+    return false;
+  }
+  _stages[_stageCount++] = stage;
+  return true;
+}
+
+bool FilterChain::apply(int16_t &value, uint32_t timestampMs) {
+  for (size_t i = 0; i < _stageCount; i++) {
+    if (!_stages[i]->apply(value, timestampMs)) {
+      _rejected++;
+      return false;
+    }
+  }
+  _accepted++;
+  return true;
+}
+
+void FilterChain::reset() {
+  for (size_t i = 0; i < _stageCount; i++) {
+    _stages[i]->reset();
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * ESP32 Room Climate Monitor - Streaming Filter Pipeline
+ *
+ * A FilterChain runs one channel's readings through a fixed list of
+ * stages between decoding and publishing. Stages are plain objects the
+ * caller owns (no heap), so which filters run, and in what order, is
+ * decided where the chain is built:
+ *
+ *   decoded -> SpikeRejector -> SlidingMedian -> EmaFilter/KalmanFilter
+ *           -> published
+ *
+ * A stage may rewrite the value or reject the sample; a rejected sample
+ * stops at that stage, so later stages only ever see plausible input.
+ * Every stage costs a bounded amount of integer work per sample, so the
+ * chain can run for each reading of each slave on the acquisition task.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FILTER_CHAIN_MAX_STAGES  4
+
+// One step of a chain; values are fixed-point integers (e.g. deci-units)
+class FilterStage {
+public:
+  virtual ~FilterStage() {}
+
+  /**
+   * Process the next reading
+   *
+   * @param value Reading in, filtered reading out
+   * @param timestampMs millis() of the reading
+   * @return false to reject the sample
+   */
+  virtual bool apply(int16_t &value, uint32_t timestampMs) = 0;
+
+  // Forget all history; the next reading starts afresh
+  virtual void reset() = 0;
+};
+
+class FilterChain {
+public:
+  FilterChain();
+
+  /**
+   * Append a stage (at most FILTER_CHAIN_MAX_STAGES)
+   *
+   * @return false if the chain is full
+   */
+  bool add(FilterStage *stage);
+
+  /**
+   * Run a reading through every stage in order
+   *
+   * @return false if a stage rejected it; value is then unspecified
+   */
+  bool apply(int16_t &value, uint32_t timestampMs);
+
+  void reset();
+
+  size_t stageCount() const { return _stageCount; }
+  uint32_t accepted() const { return _accepted; }
+  uint32_t rejected() const { return _rejected; }
+
+private:
+  FilterStage *_stages[FILTER_CHAIN_MAX_STAGES];
+  size_t _stageCount;
+  uint32_t _accepted;
+  uint32_t _rejected;
+};
+
+#endif // FILTER_CHAIN_H
@@ -0,0 +1,166 @@
+/**
+ * ESP32 Room Climate Monitor - Reading Filter Stages
+ *
+ * See ReadingFilters.h for what each stage does.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ReadingFilters.h"
+
+// Cap on the Kalman estimate variance so the gain arithmetic cannot
+// overflow after a long gap (any value this large means "trust the
+// next reading completely" anyway)
+#define KALMAN_MAX_VARIANCE  0x7FFFFFFFUL
+
+// Rounded conversion from 8 fractional bits back to a reading
+static int16_t fromQ8(int32_t value) {
+  return (int16_t)((value + 128) >> 8);
+}
+
+// ==================== SPIKE REJECTOR ====================
+
+SpikeRejector::SpikeRejector()
+  : _maxRatePerSecond(0),
+    _slack(0),
+    _confirmCount(0),
+    _primed(false),
+    _reference(0),
+    _referenceMs(0),
+    _candidate(0),
+    _outliers(0),
+    _rejectedCount(0) {
+}
+
+void SpikeRejector::begin(int16_t maxRatePerSecond, int16_t slack,
+                          uint8_t confirmCount) {
+  _maxRatePerSecond = maxRatePerSecond < 0 ? 0 : maxRatePerSecond;
+  _slack = slack < 0 ? 0 : slack;
+  _confirmCount = confirmCount;
+  _rejectedCount = 0;
+  reset();
+}
+
+bool SpikeRejector::apply(int16_t &value, uint32_t timestampMs) {
+  if (!_primed) {
+    _primed = true;
+    _reference = value;
+    _referenceMs = timestampMs;
+    _outliers = 0;
+    return true;
+  }
+
+  // The allowance grows with the time since the last accepted reading,
+  // so a run of rejections or failed polls cannot lock the filter out
+  uint32_t elapsedMs = timestampMs - _referenceMs;
+  uint64_t allowed = (uint64_t)_maxRatePerSecond * elapsedMs / 1000 + _slack;
+  int32_t change = (int32_t)value - _reference;
+  if (change < 0) {
+    change = -change;
+  }
+
+  if ((uint64_t)change <= allowed) {
+    _reference = value;
+    _referenceMs = timestampMs;
+    _outliers = 0;
+    return true;
+  }
+
+  // Outliers that agree with each other are a real step, not a glitch
+  int32_t spread = (int32_t)value - _candidate;
+  if (_outliers > 0 && spread >= -_slack && spread <= _slack) {
+    _outliers++;
+  } else {
+    _candidate = value;
+    _outliers = 1;
+  }
+  if (_confirmCount > 0 && _outliers >= _confirmCount) {
+    _reference = value;
+    _referenceMs = timestampMs;
+    _outliers = 0;
+    return true;
+  }
+
+  _rejectedCount++;
+  return false;
+}
+
+void SpikeRejector::reset() {
+  _primed = false;
+  _outliers = 0;
+}
+
+// ==================== EMA ====================
+
+EmaFilter::EmaFilter()
+  : _shift(0),
+    _primed(false),
+    _average(0) {
+}
+
+void EmaFilter::begin(uint8_t shift) {
+  _shift = shift > 15 ? 15 : shift;
+  _primed = false;
+}
+
+bool EmaFilter::apply(int16_t &value, uint32_t timestampMs) {
+  (void)timestampMs;
+  int32_t sample = (int32_t)value * 256;
+  if (!_primed) {
+    _primed = true;
+    _average = sample;
+  } else {
+    _average += (sample - _average) >> _shift;
+  }
+  value = fromQ8(_average);
+  return true;
+}
+
+// ==================== KALMAN ====================
+
+KalmanFilter::KalmanFilter()
+  : _processNoise(0),
+    _measurementNoise(0),
+    _primed(false),
+    _estimate(0),
+    _variance(0),
+    _lastMs(0) {
+}
+
+void KalmanFilter::begin(uint32_t processNoisePerSecond,
+                         uint32_t measurementNoise) {
+  _processNoise = processNoisePerSecond;
+  _measurementNoise = measurementNoise;
+  _primed = false;
+}
+
+bool KalmanFilter::apply(int16_t &value, uint32_t timestampMs) {
+  int32_t measurement = (int32_t)value * 256;
+  if (!_primed) {
+    _primed = true;
+    _estimate = measurement;
+    _variance = _measurementNoise;
+    _lastMs = timestampMs;
+    return true;
+  }
+
+  // Predict: the true value may have drifted since the last reading
+  uint32_t elapsedMs = timestampMs - _lastMs;
+  _lastMs = timestampMs;
+  uint64_t variance = _variance + (uint64_t)_processNoise * elapsedMs / 1000;
+  if (variance > KALMAN_MAX_VARIANCE) {
+    variance = KALMAN_MAX_VARIANCE;
+  }
+
+  // Update: gain = P / (P + R), 16 fractional bits
+  uint64_t total = variance + _measurementNoise;
+  uint32_t gain = total == 0 ? 65536 : (uint32_t)((variance << 16) / total);
+  int64_t innovation = (int64_t)measurement - _estimate;
+  _estimate += (int32_t)((innovation * gain) >> 16);
+  _variance = (uint32_t)(variance - ((variance * gain) >> 16));
+
+  value = fromQ8(_estimate);
+  return true;
+}
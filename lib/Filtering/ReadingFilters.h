@@ -0,0 +1,173 @@
+/**
+ * ESP32 Room Climate Monitor - Reading Filter Stages
+ *
+ * FilterStage implementations for slowly varying physical quantities,
+ * all in integer fixed-point with their state held inline:
+ *
+ * - SpikeRejector: drops readings that moved further from the last
+ *   accepted one than the quantity can physically change in the time
+ *   between them (a CRC-valid but garbled frame). A genuine step is
+ *   accepted once confirmCount outliers in a row agree with each other.
+ * - SlidingMedian<N>: median of the last N readings; removes isolated
+ *   outliers that slipped past the rate limit without blurring steps
+ * - EmaFilter: exponential moving average with alpha = 1 / 2^shift
+ * - KalmanFilter: scalar random-walk Kalman filter whose process noise
+ *   grows with the time between readings, so it smooths hard while
+ *   readings arrive quickly and trusts each one more at long intervals
+ *
+ * Internal state uses 8 fractional bits (values) and 16 fractional bits
+ * (variances and gains) so repeated small corrections are not lost to
+ * rounding; readings in and out are plain fixed-point integers.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef READING_FILTERS_H
+#define READING_FILTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FilterChain.h"
+
+/**
+ * Convert a standard deviation in whole units (e.g. 0.1 °C) to the
+ * KalmanFilter's variance format: squared deci-units, 16 fractional bits
+ */
+constexpr uint32_t toDeciVariance(double stdDev) {
+  return (uint32_t)(stdDev * 10 * stdDev * 10 * 65536.0 + 0.5);
+}
+
+class SpikeRejector : public FilterStage {
+public:
+  SpikeRejector();
+
+  /**
+   * @param maxRatePerSecond Largest plausible change per second
+   * @param slack Change always allowed, whatever the time step (noise)
+   * @param confirmCount Agreeing outliers in a row accepted as a real
+   *        step (0 = never)
+   */
+  void begin(int16_t maxRatePerSecond, int16_t slack, uint8_t confirmCount);
+
+  bool apply(int16_t &value, uint32_t timestampMs) override;
+  void reset() override;
+
+  uint32_t rejectedCount() const { return _rejectedCount; }
+
+private:
+  int16_t _maxRatePerSecond;
+  int16_t _slack;
+  uint8_t _confirmCount;
+  bool _primed;                  // _reference holds an accepted reading
+  int16_t _reference;            // Last accepted reading
+  uint32_t _referenceMs;
+  int16_t _candidate;            // Outlier the current streak agrees with
+  uint8_t _outliers;             // Length of that streak
+  uint32_t _rejectedCount;
+};
+
+/**
+ * Median of the last N readings (N odd)
+ * Keeps the window in arrival order and a sorted copy; each reading
+ * costs at most 2N element moves, constant however long the stream
+ * runs and faster than heap-based schemes for the small windows used
+ * to clean up sensor readings.
+ */
+template <size_t N>
+class SlidingMedian : public FilterStage {
+  static_assert(N % 2 == 1, "SlidingMedian needs an odd window");
+
+public:
+  SlidingMedian() : _window(), _sorted(), _count(0), _next(0) {}
+
+  bool apply(int16_t &value, uint32_t timestampMs) override {
+    (void)timestampMs;
+    if (_count == N) {
+      // Drop the reading about to leave the window from the sorted copy
+      size_t i = 0;
+      while (_sorted[i] != _window[_next]) {
+        i++;
+      }
+      for (; i + 1 < _count; i++) {
+        _sorted[i] = _sorted[i + 1];
+      }
+      _count--;
+    }
+
+    size_t j = _count;
+    while (j > 0 && _sorted[j - 1] > value) {
+      _sorted[j] = _sorted[j - 1];
+      j--;
+    }
+    _sorted[j] = value;
+    _count++;
+    _window[_next] = value;
+    _next = (_next + 1) % N;
+
+    // Until the window fills, an even count averages the middle pair
+    if (_count % 2 == 1) {
+      value = _sorted[_count / 2];
+    } else {
+      value = (int16_t)(((int32_t)_sorted[_count / 2 - 1] +
+                         _sorted[_count / 2]) / 2);
+    }
+    return true;
+  }
+
+  void reset() override {
+    _count = 0;
+    _next = 0;
+  }
+
+private:
+  int16_t _window[N];            // Readings in arrival order (ring)
+  int16_t _sorted[N];            // The same readings, ascending
+  size_t _count;
+  size_t _next;                  // Ring slot of the next reading
+};
+
+class EmaFilter : public FilterStage {
+public:
+  EmaFilter();
+
+  /**
+   * @param shift Smoothing: alpha = 1 / 2^shift (0 = pass through)
+   */
+  void begin(uint8_t shift);
+
+  bool apply(int16_t &value, uint32_t timestampMs) override;
+  void reset() override { _primed = false; }
+
+private:
+  uint8_t _shift;
+  bool _primed;
+  int32_t _average;              // 8 fractional bits
+};
+
+class KalmanFilter : public FilterStage {
+public:
+  KalmanFilter();
+
+  /**
+   * Both noise figures are variances from toDeciVariance()
+   *
+   * @param processNoisePerSecond Variance the true value drifts by per second
+   * @param measurementNoise Variance of one reading
+   */
+  void begin(uint32_t processNoisePerSecond, uint32_t measurementNoise);
+
+  bool apply(int16_t &value, uint32_t timestampMs) override;
+  void reset() override { _primed = false; }
+
+private:
+  uint32_t _processNoise;
+  uint32_t _measurementNoise;
+  bool _primed;
+  int32_t _estimate;             // 8 fractional bits
+  uint32_t _variance;            // Estimate variance, 16 fractional bits
+  uint32_t _lastMs;
+};
+
+#endif // READING_FILTERS_H
@@ -0,0 +1,206 @@
+/**
+ * ESP32 Room Climate Monitor - Fixed-point Readings and Text Formatting
+ *
+ * Sensor values are carried end-to-end as signed deci-units (0.1 steps),
+ * exactly as the XY-MD02 reports them: 235 = 23.5 °C, -52 = -5.2 °C.
+ * The formatters below turn integers into text in caller-provided
+ * buffers without heap allocation or the printf float machinery.
+ * All functions are constexpr so they can also run at compile time.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Convert a configuration constant (e.g. TEMP_MIN) to deci-units
+ * Rounds half away from zero; intended for compile-time use
+ */
+constexpr int16_t toDeci(double value) {
+  return (int16_t)(value >= 0 ? value * 10 + 0.5 : value * 10 - 0.5);
+}
+
+/**
+ * Write an unsigned decimal number
+ *
+ * @param out Destination buffer, always NUL-terminated if size > 0
+ * @param size Size of out in bytes
+ * @return Characters written (excluding NUL), 0 if the buffer is too small
+ */
+constexpr size_t formatUnsigned(char *out, size_t size, uint32_t value) {
+  char digits[10] = {};
+  size_t count = 0;
+  do {
+    digits[count++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  if (count + 1 > size) {
+    if (size > 0) {
+      out[0] = '\0';
+    }
+    return 0;
+  }
+  for (size_t i = 0; i < count; i++) {
+    out[i] = digits[count - 1 - i];
+  }
+  out[count] = '\0';
+  return count;
+}
+
+/**
+ * Write a signed decimal number
+ */
+constexpr size_t formatSigned(char *out, size_t size, int32_t value) {
+  if (value >= 0) {
+    return formatUnsigned(out, size, (uint32_t)value);
+  }
+  if (size < 2) {
+    if (size > 0) {
+      out[0] = '\0';
+    }
+    return 0;
+  }
+  out[0] = '-';
+  size_t length = formatUnsigned(out + 1, size - 1, 0u - (uint32_t)value);
+  if (length == 0) {
+    out[0] = '\0';
+    return 0;
+  }
+  return length + 1;
+}
+
+/**
+ * Write a deci-unit value with one decimal place (e.g. -52 -> "-5.2")
+ */
+constexpr size_t formatDeci(char *out, size_t size, int32_t deci) {
+  uint32_t magnitude = deci < 0 ? 0u - (uint32_t)deci : (uint32_t)deci;
+  size_t sign = deci < 0 ? 1 : 0;
+
+  // Integer part, then ".d"
+  char whole[12] = {};
+  size_t length = formatUnsigned(whole, sizeof(whole), magnitude / 10);
+  if (sign + length + 3 > size) {
+    if (size > 0) {
+      out[0] = '\0';
+    }
+    return 0;
+  }
+
+  size_t position = 0;
+  if (sign) {
+    out[position++] = '-';
+  }
+  for (size_t i = 0; i < length; i++) {
+    out[position++] = whole[i];
+  }
+  out[position++] = '.';
+  out[position++] = (char)('0' + magnitude % 10);
+  out[position] = '\0';
+  return position;
+}
+
+/**
+ * Write a byte as two uppercase hex digits
+ */
+constexpr size_t formatHex8(char *out, size_t size, uint8_t value) {
+  const char hexDigits[] = "0123456789ABCDEF";
+  if (size < 3) {
+    if (size > 0) {
+      out[0] = '\0';
+    }
+    return 0;
+  }
+  out[0] = hexDigits[value >> 4];
+  out[1] = hexDigits[value & 0x0F];
+  out[2] = '\0';
+  return 2;
+}
+
+/**
+ * Chainable line builder over a caller-provided buffer
+ * Output that does not fit is dropped and flagged; the text stays
+ * NUL-terminated
+ *
+ *   char line[32];
+ *   TextBuilder(line, sizeof(line)).text("Temp: ").deci(235).text(" C");
+ */
+class TextBuilder {
+public:
+  constexpr TextBuilder(char *buffer, size_t size)
+    : _buffer(buffer), _size(size), _length(0), _overflowed(false) {
+    if (_size > 0) {
+      _buffer[0] = '\0';
+    }
+  }
+
+  constexpr TextBuilder &text(const char *value) {
+    while (*value != '\0' && _length + 1 < _size) {
+      _buffer[_length++] = *value++;
+    }
+    _overflowed = _overflowed || *value != '\0';
+    terminate();
+    return *this;
+  }
+
+  constexpr TextBuilder &character(char value) {
+    if (_length + 1 < _size) {
+      _buffer[_length++] = value;
+    } else {
+      _overflowed = true;
+    }
+    terminate();
+    return *this;
+  }
+
+  constexpr TextBuilder &number(int32_t value) {
+    append(formatSigned(_buffer + _length, remaining(), value));
+    return *this;
+  }
+
+  constexpr TextBuilder &unsignedNumber(uint32_t value) {
+    append(formatUnsigned(_buffer + _length, remaining(), value));
+    return *this;
+  }
+
+  constexpr TextBuilder &deci(int32_t value) {
+    append(formatDeci(_buffer + _length, remaining(), value));
+    return *this;
+  }
+
+  constexpr TextBuilder &hex(uint8_t value) {
+    append(formatHex8(_buffer + _length, remaining(), value));
+    return *this;
+  }
+
+  constexpr const char *c_str() const { return _buffer; }
+  constexpr size_t length() const { return _length; }
+  // Something was dropped because the buffer was full
+  constexpr bool overflowed() const { return _overflowed; }
+
+private:
+  constexpr size_t remaining() const { return _size - _length; }
+  // Formatters write nothing (0) when the value does not fit
+  constexpr void append(size_t written) {
+    _length += written;
+    _overflowed = _overflowed || written == 0;
+  }
+  constexpr void terminate() {
+    if (_size > 0) {
+      _buffer[_length] = '\0';
+    }
+  }
+
+  char *_buffer;
+  size_t _size;
+  size_t _length;
+  bool _overflowed;
+};
+
+#endif // FIXED_POINT_H
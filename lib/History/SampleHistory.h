@@ -0,0 +1,327 @@
+/**
+ * ESP32 Room Climate Monitor - Multi-resolution Sample History
+ *
+ * Fixed-size, allocation-free time series store for one sensor:
+ *
+ * - Raw tier:    every sample, delta + zigzag-varint encoded in a byte
+ *                ring. A typical 2 s sample with small changes costs
+ *                4 bytes instead of 8; the oldest samples are evicted
+ *                when the ring is full.
+ * - Minute tier: min/max/avg per minute, rolled up as samples arrive
+ * - Hour tier:   min/max/avg per hour, also rolled up as samples arrive
+ *                (independently of the minute tier, so it stays exact
+ *                when minute buckets have already been evicted)
+ *
+ * Aggregate queries ("last N minutes") walk only the matching tier, so
+ * they cost O(tier size) regardless of the raw sample rate.
+ *
+ * Timestamps are millis() values; all comparisons use unsigned
+ * differences so the 49-day wrap is harmless.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SAMPLE_HISTORY_H
+#define SAMPLE_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HISTORY_MS_PER_MINUTE  60000UL
+#define HISTORY_MS_PER_HOUR    3600000UL
+
+// One decoded raw sample (values in deci-units)
+struct HistorySample {
+  uint32_t timestampMs;
+  int16_t temperature;
+  int16_t humidity;
+};
+
+// Min/max/sum over a time bucket (values in deci-units)
+struct HistoryAggregate {
+  uint32_t startMs;
+  uint32_t count;
+  int16_t temperatureMin;
+  int16_t temperatureMax;
+  int32_t temperatureSum;
+  int16_t humidityMin;
+  int16_t humidityMax;
+  int32_t humiditySum;
+
+  void clear(uint32_t start) {
+    startMs = start;
+    count = 0;
+    temperatureSum = 0;
+    humiditySum = 0;
+  }
+
+  void add(int16_t temperature, int16_t humidity) {
+    if (count == 0 || temperature < temperatureMin) temperatureMin = temperature;
+    if (count == 0 || temperature > temperatureMax) temperatureMax = temperature;
+    if (count == 0 || humidity < humidityMin) humidityMin = humidity;
+    if (count == 0 || humidity > humidityMax) humidityMax = humidity;
+    temperatureSum += temperature;
+    humiditySum += humidity;
+    count++;
+  }
+
+  void merge(const HistoryAggregate &other) {
+    if (other.count == 0) {
+      return;
+    }
+    if (count == 0 || other.temperatureMin < temperatureMin) temperatureMin = other.temperatureMin;
+    if (count == 0 || other.temperatureMax > temperatureMax) temperatureMax = other.temperatureMax;
+    if (count == 0 || other.humidityMin < humidityMin) humidityMin = other.humidityMin;
+    if (count == 0 || other.humidityMax > humidityMax) humidityMax = other.humidityMax;
+    temperatureSum += other.temperatureSum;
+    humiditySum += other.humiditySum;
+    count += other.count;
+  }
+
+  int16_t temperatureAverage() const {
+    return count ? (int16_t)(temperatureSum / (int32_t)count) : 0;
+  }
+  int16_t humidityAverage() const {
+    return count ? (int16_t)(humiditySum / (int32_t)count) : 0;
+  }
+};
+
+/**
+ * Fixed-capacity ring of closed aggregates, newest last
+ */
+template <size_t Capacity>
+class AggregateRing {
+public:
+  AggregateRing() : _next(0), _count(0) {}
+
+  void push(const HistoryAggregate &aggregate) {
+    _slots[_next] = aggregate;
+    _next = (_next + 1) % Capacity;
+    if (_count < Capacity) {
+      _count++;
+    }
+  }
+
+  size_t size() const { return _count; }
+
+  // age 0 is the newest entry
+  const HistoryAggregate &newest(size_t age) const {
+    return _slots[(_next + Capacity - 1 - age) % Capacity];
+  }
+
+private:
+  HistoryAggregate _slots[Capacity];
+  size_t _next;
+  size_t _count;
+};
+
+/**
+ * History for one sensor
+ *
+ * @tparam RawBytes Size of the encoded raw sample ring
+ * @tparam MinuteSlots Closed minutes kept
+ * @tparam HourSlots Closed hours kept
+ */
+template <size_t RawBytes, size_t MinuteSlots, size_t HourSlots>
+class SampleHistory {
+public:
+  SampleHistory() : _rawHead(0), _rawTail(0), _rawUsed(0), _rawCount(0) {
+    _minute.clear(0);
+    _hour.clear(0);
+  }
+
+  /**
+   * Record a new sample and roll it into the minute and hour tiers
+   */
+  void add(uint32_t timestampMs, int16_t temperature, int16_t humidity) {
+    HistorySample sample = {timestampMs, temperature, humidity};
+    appendRaw(sample);
+    rollUp(timestampMs);
+    _minute.add(temperature, humidity);
+    _hour.add(temperature, humidity);
+  }
+
+  /**
+   * Aggregate of all samples within the last `minutes` minutes
+   * Walks at most MinuteSlots closed buckets plus the open one
+   */
+  HistoryAggregate summarizeMinutes(uint32_t minutes, uint32_t nowMs) const {
+    return summarize(_minutes, _minute, minutes * HISTORY_MS_PER_MINUTE, nowMs);
+  }
+
+  /**
+   * Aggregate of all samples within the last `hours` hours
+   */
+  HistoryAggregate summarizeHours(uint32_t hours, uint32_t nowMs) const {
+    return summarize(_hours, _hour, hours * HISTORY_MS_PER_HOUR, nowMs);
+  }
+
+  const AggregateRing<MinuteSlots> &minutes() const { return _minutes; }
+  const AggregateRing<HourSlots> &hours() const { return _hours; }
+
+  size_t rawCount() const { return _rawCount; }
+  size_t rawBytesUsed() const { return _rawUsed; }
+
+  /**
+   * Decode raw samples oldest first
+   *
+   * @param visit Callable taking const HistorySample &
+   */
+  template <typename Visitor>
+  void forEachRaw(Visitor visit) const {
+    if (_rawCount == 0) {
+      return;
+    }
+    HistorySample sample = _oldest;
+    visit(sample);
+    size_t position = _rawTail;
+    for (size_t i = 1; i < _rawCount; i++) {
+      position = decodeDelta(position, sample);
+      visit(sample);
+    }
+  }
+
+private:
+  // ---------- Raw tier ----------
+
+  static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  }
+
+  static int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+  }
+
+  static size_t putVarint(uint8_t *out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+      out[length++] = (uint8_t)(value | 0x80);
+      value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+  }
+
+  size_t getVarint(size_t position, uint32_t &value) const {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+      uint8_t byte = _raw[position];
+      position = (position + 1) % RawBytes;
+      value |= (uint32_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    return position;
+  }
+
+  /**
+   * Decode one delta record at position and apply it to sample
+   * @return Position of the next record
+   */
+  size_t decodeDelta(size_t position, HistorySample &sample) const {
+    uint32_t value;
+    position = getVarint(position, value);
+    sample.timestampMs += value;
+    position = getVarint(position, value);
+    sample.temperature = (int16_t)(sample.temperature + unzigzag(value));
+    position = getVarint(position, value);
+    sample.humidity = (int16_t)(sample.humidity + unzigzag(value));
+    return position;
+  }
+
+  void appendRaw(const HistorySample &sample) {
+    if (_rawCount == 0) {
+      // The oldest sample is kept unencoded as the base for the deltas
+      _oldest = sample;
+      _newest = sample;
+      _rawCount = 1;
+      return;
+    }
+
+    uint8_t record[15];
+    size_t length = putVarint(record, sample.timestampMs - _newest.timestampMs);
+    length += putVarint(record + length,
+                        zigzag(sample.temperature - _newest.temperature));
+    length += putVarint(record + length,
+                        zigzag(sample.humidity - _newest.humidity));
+
+    // Evict the oldest samples until the new record fits
+    while (RawBytes - _rawUsed < length && _rawCount > 1) {
+      size_t next = decodeDelta(_rawTail, _oldest);
+      _rawUsed -= (next + RawBytes - _rawTail) % RawBytes;
+      _rawTail = next;
+      _rawCount--;
+    }
+    if (RawBytes - _rawUsed < length) {
+      return; // Ring smaller than a single record
+    }
+
+    for (size_t i = 0; i < length; i++) {
+      _raw[_rawHead] = record[i];
+      _rawHead = (_rawHead + 1) % RawBytes;
+    }
+    _rawUsed += length;
+    _rawCount++;
+    _newest = sample;
+  }
+
+  // ---------- Aggregate tiers ----------
+
+  /**
+   * Close the open minute/hour buckets once their period has elapsed
+   */
+  void rollUp(uint32_t nowMs) {
+    if (_minute.count == 0) {
+      _minute.clear(nowMs);
+    } else if (nowMs - _minute.startMs >= HISTORY_MS_PER_MINUTE) {
+      _minutes.push(_minute);
+      _minute.clear(nowMs);
+    }
+
+    if (_hour.count == 0) {
+      _hour.clear(nowMs);
+    } else if (nowMs - _hour.startMs >= HISTORY_MS_PER_HOUR) {
+      _hours.push(_hour);
+      _hour.clear(nowMs);
+    }
+  }
+
+  template <size_t Capacity>
+  static HistoryAggregate summarize(const AggregateRing<Capacity> &ring,
+                                    const HistoryAggregate &open,
+                                    uint32_t windowMs, uint32_t nowMs) {
+    HistoryAggregate result;
+    result.clear(nowMs);
+    if (open.count > 0 && nowMs - open.startMs < windowMs) {
+      result.merge(open);
+      result.startMs = open.startMs;
+    }
+    for (size_t age = 0; age < ring.size(); age++) {
+      const HistoryAggregate &bucket = ring.newest(age);
+      if (nowMs - bucket.startMs >= windowMs) {
+        break; // Older buckets are all outside the window
+      }
+      result.merge(bucket);
+      result.startMs = bucket.startMs;
+    }
+    return result;
+  }
+
+  uint8_t _raw[RawBytes];
+  size_t _rawHead;           // Next byte to write
+  size_t _rawTail;           // First delta record (the one after _oldest)
+  size_t _rawUsed;
+  size_t _rawCount;          // Samples including _oldest
+  HistorySample _oldest;
+  HistorySample _newest;
+
+  HistoryAggregate _minute;  // Open minute bucket
+  HistoryAggregate _hour;    // Open hour bucket
+  AggregateRing<MinuteSlots> _minutes;
+  AggregateRing<HourSlots> _hours;
+};
+
+#endif // SAMPLE_HISTORY_H
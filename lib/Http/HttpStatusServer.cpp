@@ -0,0 +1,400 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking HTTP Status Server
+ *
+ * See HttpStatusServer.h for the caching scheme.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "HttpStatusServer.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include "FixedPoint.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Fixed error responses; the connection is closed after each
+static const char RESPONSE_BAD_REQUEST[] =
+  "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\n"
+  "Content-Length: 12\r\nConnection: close\r\n\r\nBad request\n";
+static const char RESPONSE_NOT_FOUND[] =
+  "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n"
+  "Content-Length: 10\r\nConnection: close\r\n\r\nNot found\n";
+static const char RESPONSE_NOT_ALLOWED[] =
+  "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET\r\n"
+  "Content-Type: text/plain\r\nContent-Length: 19\r\n"
+  "Connection: close\r\n\r\nMethod not allowed\n";
+static const char RESPONSE_UNAVAILABLE[] =
+  "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\n"
+  "Content-Type: text/plain\r\nContent-Length: 12\r\n"
+  "Connection: close\r\n\r\nNo data yet\n";
+
+static bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
+
+/**
+ * Position of the blank line ending the headers, or 0 if not received yet
+ */
+static size_t findHeaderEnd(const char *data, size_t length) {
+  for (size_t i = 3; i < length; i++) {
+    if (data[i] == '\n' && data[i - 1] == '\r' && data[i - 2] == '\n' &&
+        data[i - 3] == '\r') {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Case-insensitive search for a lowercase needle
+ */
+static bool containsIgnoreCase(const char *data, size_t length,
+                               const char *needle) {
+  size_t needleLength = strlen(needle);
+  for (size_t i = 0; i + needleLength <= length; i++) {
+    size_t j = 0;
+    while (j < needleLength) {
+      char c = data[i + j];
+      if (c >= 'A' && c <= 'Z') {
+        c = (char)(c - 'A' + 'a');
+      }
+      if (c != needle[j]) {
+        break;
+      }
+      j++;
+    }
+    if (j == needleLength) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ==================== RESPONSE CACHE ====================
+
+HttpResponseCache::HttpResponseCache() : _current(-1), _versions(0) {
+  for (Buffer &buffer : _buffers) {
+    buffer.offset = 0;
+    buffer.length = 0;
+    buffer.readers = 0;
+  }
+}
+
+char *HttpResponseCache::draft() {
+  Buffer &spare = _buffers[_current == 0 ? 1 : 0];
+  return spare.readers == 0 ? spare.bytes + HTTP_HEADER_RESERVE : nullptr;
+}
+
+void HttpResponseCache::publish(size_t bodyLength) {
+  int index = _current == 0 ? 1 : 0;
+  Buffer &spare = _buffers[index];
+
+  char header[HTTP_HEADER_RESERVE];
+  TextBuilder text(header, sizeof(header));
+  text.text("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+            "Content-Length: ")
+      .unsignedNumber((uint32_t)bodyLength)
+      .text("\r\nCache-Control: no-cache\r\n\r\n");
+
+  // The header ends exactly where the body starts
+  spare.offset = HTTP_HEADER_RESERVE - text.length();
+  memcpy(spare.bytes + spare.offset, header, text.length());
+  spare.length = text.length() + bodyLength;
+  _current = index;
+  _versions++;
+}
+
+int HttpResponseCache::acquire() {
+  if (_current >= 0) {
+    _buffers[_current].readers++;
+  }
+  return _current;
+}
+
+// ==================== SERVER ====================
+
+HttpStatusServer::HttpStatusServer()
+  : _listenFd(-1),
+    _port(0),
+    _paths(),
+    _caches(),
+    _routeCount(0),
+    _clients(),
+    _stats() {
+  for (Client &client : _clients) {
+    client.fd = -1;
+    client.state = CLIENT_FREE;
+  }
+}
+
+bool HttpStatusServer::begin(uint16_t port, bool loopbackOnly) {
+  _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (_listenFd < 0) {
+    return false;
+  }
+  int reuse = 1;
+  setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+  socklen_t addressLength = sizeof(address);
+  if (bind(_listenFd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+      listen(_listenFd, HTTP_MAX_CLIENTS) < 0 ||
+      !setNonBlocking(_listenFd) ||
+      getsockname(_listenFd, (struct sockaddr *)&address,
+                  &addressLength) < 0) {
+    close(_listenFd);
+    _listenFd = -1;
+    return false;
+  }
+  _port = ntohs(address.sin_port);
+  return true;
+}
+
+bool HttpStatusServer::route(const char *path, HttpResponseCache *cache) {
+  if (_routeCount >= HTTP_MAX_ROUTES) {
+    return false;
+  }
+  _paths[_routeCount] = path;
+  _caches[_routeCount] = cache;
+  _routeCount++;
+  return true;
+}
+
+uint8_t HttpStatusServer::activeClients() const {
+  uint8_t count = 0;
+  for (const Client &client : _clients) {
+    if (client.state != CLIENT_FREE) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void HttpStatusServer::poll(uint32_t nowMs, uint32_t waitMs) {
+  if (_listenFd < 0) {
+    return;
+  }
+
+  fd_set readable;
+  fd_set writable;
+  FD_ZERO(&readable);
+  FD_ZERO(&writable);
+  int maxFd = -1;
+
+  // Leave new connections in the backlog while every slot is taken
+  if (activeClients() < HTTP_MAX_CLIENTS) {
+    FD_SET(_listenFd, &readable);
+    maxFd = _listenFd;
+  }
+  for (Client &client : _clients) {
+    if (client.state == CLIENT_READING) {
+      FD_SET(client.fd, &readable);
+    } else if (client.state == CLIENT_SENDING) {
+      FD_SET(client.fd, &writable);
+    } else {
+      continue;
+    }
+    if (client.fd > maxFd) {
+      maxFd = client.fd;
+    }
+  }
+  if (maxFd < 0) {
+    return;
+  }
+
+  struct timeval timeout;
+  timeout.tv_sec = waitMs / 1000;
+  timeout.tv_usec = (waitMs % 1000) * 1000;
+  int ready = select(maxFd + 1, &readable, &writable, nullptr, &timeout);
+  if (ready < 0) {
+    return; // Interrupted; try again on the next pass
+  }
+
+  for (Client &client : _clients) {
+    if (client.state == CLIENT_READING && FD_ISSET(client.fd, &readable)) {
+      receive(client, nowMs);
+    } else if (client.state == CLIENT_SENDING &&
+               FD_ISSET(client.fd, &writable)) {
+      transmit(client, nowMs);
+    } else if (client.state != CLIENT_FREE &&
+               nowMs - client.lastActivityMs > HTTP_IDLE_TIMEOUT_MS) {
+      _stats.timeouts++;
+      closeClient(client);
+    }
+  }
+  if (FD_ISSET(_listenFd, &readable)) {
+    acceptClients(nowMs);
+  }
+}
+
+void HttpStatusServer::acceptClients(uint32_t nowMs) {
+  for (Client &client : _clients) {
+    if (client.state != CLIENT_FREE) {
+      continue;
+    }
+    int fd = accept(_listenFd, nullptr, nullptr);
+    if (fd < 0) {
+      return; // Backlog empty
+    }
+    if (!setNonBlocking(fd)) {
+      close(fd);
+      continue;
+    }
+    client.fd = fd;
+    client.state = CLIENT_READING;
+    client.closeAfter = false;
+    client.cache = nullptr;
+    client.requestLength = 0;
+    client.lastActivityMs = nowMs;
+    _stats.connections++;
+  }
+}
+
+void HttpStatusServer::receive(Client &client, uint32_t nowMs) {
+  ssize_t received = recv(client.fd, client.request + client.requestLength,
+                          HTTP_REQUEST_MAX - client.requestLength, 0);
+  if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return;
+  }
+  if (received <= 0) {
+    closeClient(client); // Closed by the peer, or reset
+    return;
+  }
+  client.requestLength += (size_t)received;
+  client.lastActivityMs = nowMs;
+
+  if (!startResponse(client) && client.requestLength == HTTP_REQUEST_MAX) {
+    respondStatic(client, RESPONSE_BAD_REQUEST); // Headers too long
+  }
+  if (client.state == CLIENT_SENDING) {
+    transmit(client, nowMs); // The socket is almost always writable
+  }
+}
+
+/**
+ * Route the first complete request in the client's buffer
+ *
+ * @return false if no complete request has arrived yet
+ */
+bool HttpStatusServer::startResponse(Client &client) {
+  size_t headerEnd = findHeaderEnd(client.request, client.requestLength);
+  if (headerEnd == 0) {
+    return false;
+  }
+  _stats.requests++;
+
+  // Request line: METHOD SP PATH SP VERSION
+  const char *line = client.request;
+  const char *pathStart = (const char *)memchr(line, ' ', headerEnd);
+  const char *pathEnd = pathStart == nullptr ? nullptr :
+    (const char *)memchr(pathStart + 1, ' ', headerEnd - (pathStart + 1 - line));
+  bool get = pathStart == line + 3 && memcmp(line, "GET", 3) == 0;
+  client.closeAfter =
+    pathEnd == nullptr || pathEnd + 9 > line + headerEnd ||
+    memcmp(pathEnd + 1, "HTTP/1.1", 8) != 0 ||
+    containsIgnoreCase(line, headerEnd, "\nconnection: close");
+
+  HttpResponseCache *cache = nullptr;
+  const char *error = nullptr;
+  if (pathEnd == nullptr) {
+    error = RESPONSE_BAD_REQUEST;
+  } else if (!get) {
+    error = RESPONSE_NOT_ALLOWED;
+  } else {
+    const char *query = (const char *)memchr(pathStart + 1, '?',
+                                             pathEnd - (pathStart + 1));
+    size_t pathLength = (query != nullptr ? query : pathEnd) - (pathStart + 1);
+    for (size_t i = 0; i < _routeCount && cache == nullptr; i++) {
+      if (strlen(_paths[i]) == pathLength &&
+          memcmp(_paths[i], pathStart + 1, pathLength) == 0) {
+        cache = _caches[i];
+      }
+    }
+    error = cache == nullptr ? RESPONSE_NOT_FOUND :
+            !cache->ready() ? RESPONSE_UNAVAILABLE : nullptr;
+  }
+
+  // Keep any pipelined request that followed this one
+  client.requestLength -= headerEnd;
+  memmove(client.request, client.request + headerEnd, client.requestLength);
+
+  if (error != nullptr) {
+    respondStatic(client, error);
+    return true;
+  }
+  client.cache = cache;
+  client.buffer = cache->acquire();
+  const HttpResponseCache::Buffer &buffer = cache->_buffers[client.buffer];
+  client.out = buffer.bytes + buffer.offset;
+  client.outLength = buffer.length;
+  client.sent = 0;
+  client.state = CLIENT_SENDING;
+  return true;
+}
+
+void HttpStatusServer::respondStatic(Client &client, const char *response) {
+  _stats.errors++;
+  client.cache = nullptr;
+  client.out = response;
+  client.outLength = strlen(response);
+  client.sent = 0;
+  client.closeAfter = true;
+  client.state = CLIENT_SENDING;
+}
+
+void HttpStatusServer::transmit(Client &client, uint32_t nowMs) {
+  ssize_t sent = send(client.fd, client.out + client.sent,
+                      client.outLength - client.sent, MSG_NOSIGNAL);
+  if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return;
+  }
+  if (sent <= 0) {
+    closeClient(client);
+    return;
+  }
+  client.sent += (size_t)sent;
+  client.lastActivityMs = nowMs;
+  _stats.bytesSent += (uint32_t)sent;
+  if (client.sent == client.outLength) {
+    finishResponse(client);
+  }
+}
+
+void HttpStatusServer::finishResponse(Client &client) {
+  if (client.cache != nullptr) {
+    client.cache->release(client.buffer);
+    client.cache = nullptr;
+  }
+  if (client.closeAfter) {
+    closeClient(client);
+    return;
+  }
+  client.state = CLIENT_READING;
+  startResponse(client); // A pipelined request may already be waiting
+}
+
+void HttpStatusServer::closeClient(Client &client) {
+  if (client.cache != nullptr) {
+    client.cache->release(client.buffer);
+    client.cache = nullptr;
+  }
+  close(client.fd);
+  client.fd = -1;
+  client.state = CLIENT_FREE;
+  client.requestLength = 0;
+}
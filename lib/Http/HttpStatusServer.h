@@ -0,0 +1,164 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking HTTP Status Server
+ *
+ * Serves a few fixed JSON documents (current readings, history
+ * aggregates, health) to any number of polling clients at almost no cost
+ * per request:
+ * - Each document lives in an HttpResponseCache: the application
+ *   serializes it once per change into a spare buffer, and publish() puts
+ *   the status line and headers in front of the body, so the cached bytes
+ *   are the complete response
+ * - A request is routed by path to a cache and answered by sending those
+ *   bytes straight from the buffer; nothing is formatted or copied per hit
+ * - Two buffers per document: a new version is written into the one no
+ *   client is still sending from, so slow clients never see a torn body
+ *   and never hold up an update for long
+ *
+ * The server runs on BSD sockets (lwIP on the ESP32, the host stack in
+ * native builds) in non-blocking mode. poll() waits in select() for up to
+ * the given time, then accepts, reads and sends whatever is ready, so one
+ * slow or idle client can never stall another or the caller's task.
+ * HTTP/1.1 keep-alive and pipelined GETs are supported; query strings are
+ * ignored; anything but GET gets 405, unknown paths 404. When all client
+ * slots are busy new connections wait in the listen backlog.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef HTTP_STATUS_SERVER_H
+#define HTTP_STATUS_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HTTP_RESPONSE_CAPACITY  2048  // Per buffer: headers plus JSON body
+#define HTTP_HEADER_RESERVE     128   // Room kept in front of the body
+#define HTTP_MAX_CLIENTS        4     // Connections served at once
+#define HTTP_MAX_ROUTES         4
+#define HTTP_REQUEST_MAX        512   // Request line and headers
+#define HTTP_IDLE_TIMEOUT_MS    5000  // Keep-alive connections closed after
+
+/**
+ * Double-buffered, pre-serialized response for one path
+ */
+class HttpResponseCache {
+public:
+  HttpResponseCache();
+
+  /**
+   * Buffer to serialize the next version of the body into
+   *
+   * @return draftCapacity() bytes, or nullptr while clients are still
+   *         sending both versions (try again on the next pass)
+   */
+  char *draft();
+  size_t draftCapacity() const {
+    return HTTP_RESPONSE_CAPACITY - HTTP_HEADER_RESERVE;
+  }
+
+  /**
+   * Add the headers to the draft and serve it from now on
+   *
+   * @param bodyLength Bytes written to draft()
+   */
+  void publish(size_t bodyLength);
+
+  bool ready() const { return _current >= 0; }
+  uint32_t versions() const { return _versions; }
+
+private:
+  friend class HttpStatusServer;
+
+  struct Buffer {
+    char bytes[HTTP_RESPONSE_CAPACITY];
+    size_t offset;           // Start of the status line
+    size_t length;           // Whole response
+    uint16_t readers;        // Clients sending from this buffer
+  };
+
+  // Pin the current version for a client, or -1 if none is published
+  int acquire();
+  void release(int index) { _buffers[index].readers--; }
+
+  Buffer _buffers[2];
+  int _current;
+  uint32_t _versions;
+};
+
+// Counters since begin()
+struct HttpServerStats {
+  uint32_t connections;
+  uint32_t requests;
+  uint32_t errors;           // 400, 404, 405, 503 responses
+  uint32_t timeouts;         // Idle keep-alive connections closed
+  uint32_t bytesSent;
+};
+
+class HttpStatusServer {
+public:
+  HttpStatusServer();
+
+  /**
+   * Start listening
+   *
+   * @param port TCP port, or 0 for any free port (see port())
+   * @param loopbackOnly Bind to 127.0.0.1 instead of all interfaces
+   * @return false if the socket could not be set up
+   */
+  bool begin(uint16_t port, bool loopbackOnly);
+
+  /**
+   * Serve a cache at an exact path (e.g. "/status")
+   *
+   * @return false if the route table is full
+   */
+  bool route(const char *path, HttpResponseCache *cache);
+
+  /**
+   * Wait up to waitMs for socket activity, then service every client
+   * that is ready; never blocks on a single client
+   */
+  void poll(uint32_t nowMs, uint32_t waitMs);
+
+  bool listening() const { return _listenFd >= 0; }
+  uint16_t port() const { return _port; }
+  uint8_t activeClients() const;
+  const HttpServerStats &stats() const { return _stats; }
+
+private:
+  enum ClientState : uint8_t { CLIENT_FREE, CLIENT_READING, CLIENT_SENDING };
+
+  struct Client {
+    int fd;
+    ClientState state;
+    bool closeAfter;         // Connection ends once the response is sent
+    HttpResponseCache *cache; // Pinned buffer's owner, or nullptr
+    int buffer;
+    const char *out;
+    size_t outLength;
+    size_t sent;
+    size_t requestLength;
+    uint32_t lastActivityMs;
+    char request[HTTP_REQUEST_MAX];
+  };
+
+  void acceptClients(uint32_t nowMs);
+  void receive(Client &client, uint32_t nowMs);
+  bool startResponse(Client &client);
+  void respondStatic(Client &client, const char *response);
+  void transmit(Client &client, uint32_t nowMs);
+  void finishResponse(Client &client);
+  void closeClient(Client &client);
+
+  int _listenFd;
+  uint16_t _port;
+  const char *_paths[HTTP_MAX_ROUTES];
+  HttpResponseCache *_caches[HTTP_MAX_ROUTES];
+  size_t _routeCount;
+  Client _clients[HTTP_MAX_CLIENTS];
+  HttpServerStats _stats;
+};
+
+#endif // HTTP_STATUS_SERVER_H
@@ -0,0 +1,143 @@
+/**
+ * ESP32 Room Climate Monitor - Asynchronous Logger
+ *
+ * See Logger.h for the record format and the supported conversions.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "Logger.h"
+#include <atomic>
+#include <string.h>
+#include "FixedPoint.h"
+#include "MpscRing.h"
+
+static MpscRing<LogRecord, LOG_RING_RECORDS> logRing;
+static std::atomic<uint32_t> logWritten(0);
+static std::atomic<uint32_t> logDropped(0);
+static uint32_t logDroppedReported = 0;   // Drain task only
+static LogClock logClock = nullptr;
+
+static const char *const LEVEL_NAMES[] = {"", "ERROR", "WARN", "INFO", "DEBUG"};
+
+void Logger::begin(LogClock clock) {
+  logClock = clock;
+}
+
+void Logger::write(uint8_t level, const char *format, const int32_t *args,
+                   uint8_t argCount, const uint8_t *data, size_t length) {
+  LogRecord record;
+  record.timestampMs = logClock != nullptr ? logClock() : 0;
+  record.format = format;
+  record.level = level;
+  record.argCount = argCount > LOG_MAX_ARGS ? LOG_MAX_ARGS : argCount;
+  record.dataLength = (uint8_t)(length > LOG_MAX_DATA ? LOG_MAX_DATA : length);
+  record.truncated = length > LOG_MAX_DATA;
+  if (record.argCount > 0) {
+    memcpy(record.args, args, record.argCount * sizeof(int32_t));
+  }
+  if (record.dataLength > 0) {
+    memcpy(record.data, data, record.dataLength);
+  }
+
+  if (logRing.push(record)) {
+    logWritten.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    logDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+size_t Logger::drain(LogSink sink, size_t maxRecords, uint8_t maxLevel) {
+  char line[LOG_LINE_LENGTH];
+  size_t emitted = 0;
+  LogRecord record;
+
+  while (emitted < maxRecords && logRing.pop(record)) {
+    emitted++;
+    if (record.level > maxLevel) {
+      continue;
+    }
+    size_t length = format(record, line, sizeof(line));
+    sink(line, length);
+  }
+
+  // Report losses once the ring has room again so the report itself fits
+  uint32_t dropped = logDropped.load(std::memory_order_relaxed);
+  if (dropped != logDroppedReported) {
+    TextBuilder(line, sizeof(line))
+      .text("WARN: Log ring full, ").unsignedNumber(dropped - logDroppedReported)
+      .text(" record(s) dropped");
+    logDroppedReported = dropped;
+    sink(line, strlen(line));
+  }
+
+  return emitted;
+}
+
+/**
+ * Write a 16-bit value as four uppercase hex digits
+ */
+static void appendHex16(TextBuilder &out, uint32_t value) {
+  out.hex((uint8_t)(value >> 8)).hex((uint8_t)value);
+}
+
+size_t Logger::format(const LogRecord &record, char *out, size_t size) {
+  TextBuilder text(out, size);
+
+  // Timestamp as seconds.milliseconds
+  uint32_t ms = record.timestampMs % 1000;
+  text.character('[').unsignedNumber(record.timestampMs / 1000).character('.')
+      .character((char)('0' + ms / 100))
+      .character((char)('0' + ms / 10 % 10))
+      .character((char)('0' + ms % 10)).text("] ");
+
+  if (record.level >= LOG_LEVEL_ERROR && record.level <= LOG_LEVEL_DEBUG) {
+    text.text(LEVEL_NAMES[record.level]).text(": ");
+  }
+
+  uint8_t arg = 0;
+  for (const char *p = record.format; *p != '\0'; p++) {
+    if (*p != '%' || p[1] == '\0') {
+      text.character(*p);
+      continue;
+    }
+
+    char conversion = *++p;
+    if (conversion == '%') {
+      text.character('%');
+      continue;
+    }
+
+    int32_t value = arg < record.argCount ? record.args[arg++] : 0;
+    switch (conversion) {
+      case 'd': text.number(value); break;
+      case 'u': text.unsignedNumber((uint32_t)value); break;
+      case 'x': text.hex((uint8_t)value); break;
+      case 'X': appendHex16(text, (uint32_t)value); break;
+      case 'D': text.deci(value); break;
+      default:
+        // Unknown conversion: show it verbatim rather than guessing
+        text.character('%').character(conversion);
+        break;
+    }
+  }
+
+  for (uint8_t i = 0; i < record.dataLength; i++) {
+    text.character(' ').hex(record.data[i]);
+  }
+  if (record.truncated) {
+    text.text(" ...");
+  }
+
+  return text.length();
+}
+
+uint32_t Logger::written() {
+  return logWritten.load(std::memory_order_relaxed);
+}
+
+uint32_t Logger::dropped() {
+  return logDropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,161 @@
+/**
+ * ESP32 Room Climate Monitor - Asynchronous Logger
+ *
+ * Keeps UART printing off the hot path:
+ * - LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG expand to nothing when their
+ *   level is above LOG_LEVEL, so disabled messages cost no code, no
+ *   string storage and no argument evaluation.
+ * - Enabled messages store a compact binary record (timestamp, level,
+ *   pointer to the constant format string, up to LOG_MAX_ARGS integer
+ *   arguments and up to LOG_MAX_DATA raw bytes) in a lock-free ring.
+ *   Nothing is formatted and nothing waits on the UART.
+ * - A low-priority task calls Logger::drain(), which formats records
+ *   into text and hands them to a sink (e.g. Serial).
+ * - When the ring is full new records are dropped and counted; drain()
+ *   reports the number of lost records so lossy logging is visible.
+ *
+ * Format strings must be literals and support a small, integer-only set
+ * of conversions:
+ *   %d signed   %u unsigned   %x hex byte (2 digits)
+ *   %X hex word (4 digits)    %D deci-units (235 -> 23.5)   %% percent
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+// Most verbose level compiled in
+#ifndef LOG_LEVEL
+#define LOG_LEVEL  LOG_LEVEL_INFO
+#endif
+
+// Records buffered between producers and the drain (power of two)
+#ifndef LOG_RING_RECORDS
+#define LOG_RING_RECORDS  64
+#endif
+
+#define LOG_MAX_ARGS  4
+#define LOG_MAX_DATA  16
+
+// Longest formatted line passed to the sink
+#define LOG_LINE_LENGTH  128
+
+// One queued log message (44 bytes on the ESP32)
+struct LogRecord {
+  uint32_t timestampMs;
+  const char *format;        // Constant string, not copied
+  uint8_t level;
+  uint8_t argCount;
+  uint8_t dataLength;        // Raw bytes stored in data
+  bool truncated;            // More raw bytes were supplied than stored
+  int32_t args[LOG_MAX_ARGS];
+  uint8_t data[LOG_MAX_DATA];
+};
+
+typedef uint32_t (*LogClock)();
+typedef void (*LogSink)(const char *line, size_t length);
+
+class Logger {
+public:
+  /**
+   * Set the millisecond clock used to timestamp records
+   */
+  static void begin(LogClock clock);
+
+  /**
+   * Queue a message with integer arguments (any task, never blocks)
+   */
+  template <typename... Args>
+  static void message(uint8_t level, const char *format, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS,
+                  "Too many log arguments; see LOG_MAX_ARGS");
+    const int32_t values[sizeof...(Args) + 1] = {(int32_t)args...};
+    write(level, format, values, sizeof...(Args), nullptr, 0);
+  }
+
+  /**
+   * Queue a message followed by a hex dump of data
+   */
+  static void hex(uint8_t level, const char *format, const uint8_t *data,
+                  size_t length) {
+    write(level, format, nullptr, 0, data, length);
+  }
+
+  static void write(uint8_t level, const char *format, const int32_t *args,
+                    uint8_t argCount, const uint8_t *data, size_t length);
+
+  /**
+   * Format and emit queued records (single consumer only)
+   *
+   * @param maxRecords Upper bound on records taken by this call
+   * @param maxLevel Records above this level are discarded unformatted
+   * @return Number of records taken
+   */
+  static size_t drain(LogSink sink, size_t maxRecords,
+                      uint8_t maxLevel = LOG_LEVEL_DEBUG);
+
+  /**
+   * Render one record as a line of text without a trailing newline
+   *
+   * @return Characters written (excluding NUL)
+   */
+  static size_t format(const LogRecord &record, char *out, size_t size);
+
+  // Records queued and records lost to a full ring since boot
+  static uint32_t written();
+  static uint32_t dropped();
+};
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) \
+  Logger::message(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_ERROR_HEX(format, data, length) \
+  Logger::hex(LOG_LEVEL_ERROR, format, data, length)
+#else
+#define LOG_ERROR(format, ...) do {} while (0)
+#define LOG_ERROR_HEX(format, data, length) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) \
+  Logger::message(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#define LOG_WARN_HEX(format, data, length) \
+  Logger::hex(LOG_LEVEL_WARN, format, data, length)
+#else
+#define LOG_WARN(format, ...) do {} while (0)
+#define LOG_WARN_HEX(format, data, length) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) \
+  Logger::message(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define LOG_INFO_HEX(format, data, length) \
+  Logger::hex(LOG_LEVEL_INFO, format, data, length)
+#else
+#define LOG_INFO(format, ...) do {} while (0)
+#define LOG_INFO_HEX(format, data, length) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) \
+  Logger::message(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define LOG_DEBUG_HEX(format, data, length) \
+  Logger::hex(LOG_LEVEL_DEBUG, format, data, length)
+#else
+#define LOG_DEBUG(format, ...) do {} while (0)
+#define LOG_DEBUG_HEX(format, data, length) do {} while (0)
+#endif
+
+#endif // LOGGER_H
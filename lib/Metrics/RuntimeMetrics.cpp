@@ -0,0 +1,59 @@
+/**
+ * ESP32 Room Climate Monitor - Runtime Performance Counters and Histograms
+ *
+ * See RuntimeMetrics.h for the bucket layout.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "RuntimeMetrics.h"
+
+LatencyHistogram::LatencyHistogram() : _maxUs(0) {
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    _buckets[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+LatencySnapshot LatencyHistogram::snapshot(bool clear) {
+  LatencySnapshot result;
+  result.count = 0;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    result.buckets[i] = clear ?
+      _buckets[i].exchange(0, std::memory_order_relaxed) :
+      _buckets[i].load(std::memory_order_relaxed);
+    result.count += result.buckets[i];
+  }
+  result.maxUs = clear ? _maxUs.exchange(0, std::memory_order_relaxed) :
+                         _maxUs.load(std::memory_order_relaxed);
+  return result;
+}
+
+uint32_t LatencyHistogram::bucketLimit(size_t bucket) {
+  if (bucket >= LATENCY_HISTOGRAM_BUCKETS - 1) {
+    return UINT32_MAX;
+  }
+  return (1UL << bucket) - 1;
+}
+
+uint32_t LatencySnapshot::percentile(uint8_t percent) const {
+  if (count == 0) {
+    return 0;
+  }
+  // Rank of the sample at this percentile, rounded up
+  uint32_t rank = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  uint32_t seen = 0;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      uint32_t limit = LatencyHistogram::bucketLimit(i);
+      return limit < maxUs ? limit : maxUs;
+    }
+  }
+  return maxUs;
+}
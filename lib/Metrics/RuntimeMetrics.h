@@ -0,0 +1,107 @@
+/**
+ * ESP32 Room Climate Monitor - Runtime Performance Counters and Histograms
+ *
+ * Event counters and log2-bucketed latency histograms that any task can
+ * update without locks: every update is a single relaxed atomic add (the
+ * histogram maximum a compare-and-swap loop), so recording from the
+ * Modbus or display path costs a few instructions and never blocks.
+ *
+ * A histogram sorts microsecond values into buckets by their bit length:
+ *
+ *   bucket 0: 0     bucket k: 2^(k-1) .. 2^k - 1     last bucket: above
+ *
+ * so LATENCY_HISTOGRAM_BUCKETS buckets cover 1 us to several seconds
+ * with a relative resolution of 2x. Percentiles are reported as the
+ * upper edge of the bucket they fall in (capped at the maximum seen).
+ *
+ * Readers take a snapshot, optionally clearing the histogram in the same
+ * pass; each bucket is swapped out atomically, so a record racing with a
+ * snapshot lands in either this one or the next, never in neither.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef RUNTIME_METRICS_H
+#define RUNTIME_METRICS_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// 24 buckets: 0 us, then powers of two up to 2^22 us (4.2 s), then above
+#define LATENCY_HISTOGRAM_BUCKETS  24
+
+class MetricCounter {
+public:
+  MetricCounter() : _value(0) {}
+
+  void increment(uint32_t count = 1) {
+    _value.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  uint32_t value() const { return _value.load(std::memory_order_relaxed); }
+
+  /**
+   * @return Count before clearing
+   */
+  uint32_t take() { return _value.exchange(0, std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint32_t> _value;
+};
+
+// Copy of a histogram at one point in time
+struct LatencySnapshot {
+  uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+
+  /**
+   * @param percent 1..100
+   * @return Upper edge of the bucket holding that percentile, in us
+   *         (0 if nothing was recorded)
+   */
+  uint32_t percentile(uint8_t percent) const;
+};
+
+class LatencyHistogram {
+public:
+  LatencyHistogram();
+
+  /**
+   * Count one value (any task, never blocks)
+   */
+  void record(uint32_t valueUs) {
+    _buckets[bucketFor(valueUs)].fetch_add(1, std::memory_order_relaxed);
+    uint32_t seen = _maxUs.load(std::memory_order_relaxed);
+    while (valueUs > seen &&
+           !_maxUs.compare_exchange_weak(seen, valueUs,
+                                         std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @param clear Start a new window: counts and maximum restart at zero
+   */
+  LatencySnapshot snapshot(bool clear);
+
+  static size_t bucketFor(uint32_t valueUs) {
+    if (valueUs == 0) {
+      return 0;
+    }
+    size_t bits = 32 - (size_t)__builtin_clz(valueUs);
+    return bits < LATENCY_HISTOGRAM_BUCKETS ? bits :
+                                              LATENCY_HISTOGRAM_BUCKETS - 1;
+  }
+
+  // Largest value counted in a bucket (UINT32_MAX for the last one)
+  static uint32_t bucketLimit(size_t bucket);
+
+private:
+  std::atomic<uint32_t> _buckets[LATENCY_HISTOGRAM_BUCKETS];
+  std::atomic<uint32_t> _maxUs;
+};
+
+#endif // RUNTIME_METRICS_H
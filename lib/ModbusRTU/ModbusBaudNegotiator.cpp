@@ -0,0 +1,172 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Baud Rate Negotiator
+ *
+ * See ModbusBaudNegotiator.h for the state machine overview.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusBaudNegotiator.h"
+
+ModbusBaudNegotiator::ModbusBaudNegotiator()
+  : _rates(),
+    _slaves(),
+    _rateCount(0),
+    _slaveCount(0),
+    _probeBurst(0),
+    _scanAfter(0),
+    _retryIntervalMs(0) {
+}
+
+void ModbusBaudNegotiator::begin(const uint32_t *rates, size_t rateCount,
+                                 size_t slaveCount, uint8_t initialRate,
+                                 uint8_t probeBurst, uint8_t scanAfter,
+                                 uint32_t retryIntervalMs) {
+  _rateCount = rateCount > MODBUS_BAUD_MAX_RATES ? MODBUS_BAUD_MAX_RATES :
+               rateCount;
+  _slaveCount = slaveCount > MODBUS_BUS_MAX_SLAVES ? MODBUS_BUS_MAX_SLAVES :
+                slaveCount;
+  _probeBurst = probeBurst == 0 ? 1 : probeBurst;
+  _scanAfter = scanAfter == 0 ? 1 : scanAfter;
+  _retryIntervalMs = retryIntervalMs;
+  for (size_t i = 0; i < _rateCount; i++) {
+    _rates[i] = rates[i];
+  }
+  if (initialRate >= _rateCount) {
+    initialRate = 0;
+  }
+
+  for (size_t i = 0; i < _slaveCount; i++) {
+    ModbusBaudStatus &status = _slaves[i];
+    status.state = MODBUS_BAUD_STABLE;
+    status.rate = initialRate;
+    status.target = initialRate;
+    status.previousRate = initialRate;
+    status.ceiling = (uint8_t)(_rateCount - 1);
+    status.streak = 0;
+    status.failures = 0;
+    status.ceilingSinceMs = 0;
+    status.changes = 0;
+  }
+}
+
+void ModbusBaudNegotiator::setRate(int index, uint8_t rate) {
+  if (rate < _rateCount) {
+    _slaves[index].rate = rate;
+    _slaves[index].target = rate;
+    _slaves[index].previousRate = rate;
+  }
+}
+
+uint32_t ModbusBaudNegotiator::lineBaudRate(int index) const {
+  const ModbusBaudStatus &status = _slaves[index];
+  return _rates[status.state == MODBUS_BAUD_SCANNING ? status.target :
+                status.rate];
+}
+
+bool ModbusBaudNegotiator::recordResult(int index, bool valid,
+                                        uint32_t nowMs) {
+  ModbusBaudStatus &status = _slaves[index];
+  uint8_t top = (uint8_t)(_rateCount - 1);
+
+  if (valid) {
+    status.failures = 0;
+    if (status.streak < 255) {
+      status.streak++;
+    }
+  } else {
+    status.streak = 0;
+    if (status.failures < 255) {
+      status.failures++;
+    }
+  }
+
+  switch (status.state) {
+    case MODBUS_BAUD_STABLE:
+      if (!valid) {
+        if (status.failures >= _scanAfter && _rateCount > 1) {
+          // Start with the next rate: this one has just failed repeatedly
+          status.state = MODBUS_BAUD_SCANNING;
+          status.target = (uint8_t)((status.rate + 1) % _rateCount);
+        }
+        return false;
+      }
+      if (status.ceiling < top && _retryIntervalMs > 0 &&
+          nowMs - status.ceilingSinceMs >= _retryIntervalMs) {
+        status.ceiling = top; // Conditions on the line may have improved
+      }
+      if (status.streak >= _probeBurst && status.rate != status.ceiling) {
+        // Step up one rate at a time; step straight down to the ceiling
+        status.state = MODBUS_BAUD_SWITCHING;
+        status.target = status.rate < status.ceiling ?
+                        (uint8_t)(status.rate + 1) : status.ceiling;
+        status.streak = 0;
+      }
+      return false;
+
+    case MODBUS_BAUD_SWITCHING:
+      if (!valid) {
+        // Write not acknowledged; stay put until the retry interval
+        lowerCeiling(status, status.rate, nowMs);
+        status.state = MODBUS_BAUD_STABLE;
+        return false;
+      }
+      status.previousRate = status.rate;
+      status.rate = status.target;
+      status.state = MODBUS_BAUD_PROBING;
+      status.streak = 0;
+      status.changes++;
+      return true;
+
+    case MODBUS_BAUD_PROBING:
+      if (!valid) {
+        if (status.rate > status.previousRate) {
+          lowerCeiling(status, (uint8_t)(status.rate - 1), nowMs);
+        }
+        status.state = MODBUS_BAUD_REVERTING;
+        status.target = status.previousRate;
+        return false;
+      }
+      if (status.streak >= _probeBurst) {
+        status.state = MODBUS_BAUD_STABLE;
+        status.streak = 0;
+      }
+      return false;
+
+    case MODBUS_BAUD_REVERTING:
+      if (!valid) {
+        // Slave unreachable at either rate; the old one is the best guess
+        status.state = MODBUS_BAUD_SCANNING;
+        status.target = status.previousRate;
+        status.failures = 0;
+        return false;
+      }
+      status.rate = status.target;
+      status.state = MODBUS_BAUD_STABLE;
+      status.streak = 0;
+      status.changes++;
+      return true;
+
+    case MODBUS_BAUD_SCANNING:
+      if (!valid) {
+        status.target = (uint8_t)((status.target + 1) % _rateCount);
+        return false;
+      }
+      status.state = MODBUS_BAUD_STABLE;
+      if (status.target == status.rate) {
+        return false;
+      }
+      status.rate = status.target;
+      status.changes++;
+      return true;
+  }
+  return false;
+}
+
+void ModbusBaudNegotiator::lowerCeiling(ModbusBaudStatus &status,
+                                        uint8_t ceiling, uint32_t nowMs) {
+  status.ceiling = ceiling;
+  status.ceilingSinceMs = nowMs;
+}
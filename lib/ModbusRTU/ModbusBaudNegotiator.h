@@ -0,0 +1,132 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Baud Rate Negotiator
+ *
+ * Moves each slave to the fastest line speed it handles reliably and
+ * finds it again when it stops answering:
+ *
+ *   STABLE -> SWITCHING -> PROBING -> STABLE          (upshift)
+ *                             |
+ *                             +---> REVERTING -> STABLE
+ *   any   -> SCANNING -> STABLE                       (recovery)
+ *
+ * - After probeBurst clean polls at its rate, a slave below the ceiling
+ *   is told to switch one step up (the write goes out at the old rate)
+ * - At the new rate it must then answer probeBurst polls in a row; one
+ *   failure lowers the ceiling and writes the old rate back
+ * - scanAfter consecutive failures start a scan that polls at each rate
+ *   in turn until the slave answers
+ * - A lowered ceiling is lifted again after retryIntervalMs
+ *
+ * Rates are indexed in ascending order; the caller maps an index to the
+ * device's own baud code. Like ModbusBusScheduler this class only does
+ * bookkeeping: the caller sets the UART speed, sends the poll or the
+ * rate write, and reports the outcome.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_BAUD_NEGOTIATOR_H
+#define MODBUS_BAUD_NEGOTIATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ModbusBusScheduler.h"
+
+#define MODBUS_BAUD_MAX_RATES  8
+
+enum ModbusBaudState : uint8_t {
+  MODBUS_BAUD_STABLE,      // Polling at the confirmed rate
+  MODBUS_BAUD_SWITCHING,   // Writing the next rate, still at the old one
+  MODBUS_BAUD_PROBING,     // Polling at the new rate until the burst passes
+  MODBUS_BAUD_REVERTING,   // Writing the old rate back at the new one
+  MODBUS_BAUD_SCANNING     // Slave lost; polling at each rate in turn
+};
+
+// Per-slave negotiation state
+struct ModbusBaudStatus {
+  ModbusBaudState state;
+  uint8_t rate;              // Rate index the slave is set to
+  uint8_t target;            // Rate index being written, or tried while scanning
+  uint8_t previousRate;      // Rate to return to if probing fails
+  uint8_t ceiling;           // Highest rate index worth trying
+  uint8_t streak;            // Consecutive valid replies
+  uint8_t failures;          // Consecutive failed transactions
+  uint32_t ceilingSinceMs;   // When the ceiling was last lowered
+  uint32_t changes;          // Rate changes since boot
+};
+
+class ModbusBaudNegotiator {
+public:
+  ModbusBaudNegotiator();
+
+  /**
+   * Configure the rate table and negotiation limits
+   *
+   * @param rates Baud rates in ascending order (at most MODBUS_BAUD_MAX_RATES)
+   * @param rateCount Number of rates
+   * @param slaveCount Number of slaves (at most MODBUS_BUS_MAX_SLAVES)
+   * @param initialRate Rate index every slave starts at
+   * @param probeBurst Clean polls required before and after a switch
+   * @param scanAfter Consecutive failures before scanning for a slave
+   * @param retryIntervalMs Time before a lowered ceiling is lifted (0 = never)
+   */
+  void begin(const uint32_t *rates, size_t rateCount, size_t slaveCount,
+             uint8_t initialRate, uint8_t probeBurst, uint8_t scanAfter,
+             uint32_t retryIntervalMs);
+
+  /**
+   * Set the rate a slave is known to use (e.g. restored from flash)
+   */
+  void setRate(int index, uint8_t rate);
+
+  /**
+   * @return Line speed for the next transaction with a slave
+   */
+  uint32_t lineBaudRate(int index) const;
+
+  /**
+   * @return true if the next transaction must write rateToWrite()
+   *         instead of polling
+   */
+  bool writePending(int index) const {
+    return _slaves[index].state == MODBUS_BAUD_SWITCHING ||
+           _slaves[index].state == MODBUS_BAUD_REVERTING;
+  }
+  uint8_t rateToWrite(int index) const { return _slaves[index].target; }
+
+  /**
+   * @return true while a switch is in progress and the slave should be
+   *         polled back to back rather than at its normal interval
+   */
+  bool negotiating(int index) const {
+    return writePending(index) || _slaves[index].state == MODBUS_BAUD_PROBING;
+  }
+
+  /**
+   * Feed back the outcome of a transaction started with lineBaudRate()
+   *
+   * @param valid true if the slave sent a valid reply
+   * @return true if the slave's rate changed and should be persisted
+   */
+  bool recordResult(int index, bool valid, uint32_t nowMs);
+
+  uint32_t baudRate(int index) const { return _rates[_slaves[index].rate]; }
+  uint32_t rate(size_t rateIndex) const { return _rates[rateIndex]; }
+  size_t rateCount() const { return _rateCount; }
+  const ModbusBaudStatus &slave(int index) const { return _slaves[index]; }
+
+private:
+  void lowerCeiling(ModbusBaudStatus &status, uint8_t ceiling, uint32_t nowMs);
+
+  uint32_t _rates[MODBUS_BAUD_MAX_RATES];
+  ModbusBaudStatus _slaves[MODBUS_BUS_MAX_SLAVES];
+  size_t _rateCount;
+  size_t _slaveCount;
+  uint8_t _probeBurst;
+  uint8_t _scanAfter;
+  uint32_t _retryIntervalMs;
+};
+
+#endif // MODBUS_BAUD_NEGOTIATOR_H
@@ -0,0 +1,141 @@
+/**
+ * ESP32 Room Climate Monitor - Multi-slave RS485 Bus Scheduler
+ *
+ * See ModbusBusScheduler.h for the scheduling policy.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusBusScheduler.h"
+
+ModbusBusScheduler::ModbusBusScheduler()
+  : _count(0),
+    _cursor(0),
+    _minTimeoutMs(0),
+    _maxTimeoutMs(0),
+    _gapUs(0),
+    _busIdleSinceUs(0),
+    _followUp(-1) {
+}
+
+void ModbusBusScheduler::begin(const uint8_t *addresses, size_t count,
+                               uint32_t pollIntervalMs, uint32_t minTimeoutMs,
+                               uint32_t maxTimeoutMs, uint32_t interFrameGapUs) {
+  _count = count > MODBUS_BUS_MAX_SLAVES ? MODBUS_BUS_MAX_SLAVES : count;
+  _cursor = 0;
+  _minTimeoutMs = minTimeoutMs;
+  _maxTimeoutMs = maxTimeoutMs;
+  _gapUs = interFrameGapUs;
+  _followUp = -1;
+
+  for (size_t i = 0; i < _count; i++) {
+    ModbusSlaveStatus &status = _slaves[i];
+    status.address = addresses[i];
+    status.polled = false;
+    status.pollIntervalMs = pollIntervalMs;
+    status.lastPollMs = 0;
+    status.smoothedResponseUs = 0;
+    status.responseDeviationUs = 0;
+    status.timeoutMs = maxTimeoutMs; // Unknown slaves get the full timeout
+    status.successCount = 0;
+    status.failureCount = 0;
+  }
+}
+
+int ModbusBusScheduler::nextSlave(uint32_t nowMs, uint32_t nowUs) {
+  if (_count == 0 || nowUs - _busIdleSinceUs < _gapUs) {
+    return -1;
+  }
+
+  if (_followUp >= 0) {
+    int index = _followUp;
+    _followUp = -1;
+    return index;
+  }
+
+  // Scan once around the ring starting at the slave after the last one polled
+  for (size_t n = 0; n < _count; n++) {
+    size_t index = (_cursor + n) % _count;
+    const ModbusSlaveStatus &status = _slaves[index];
+    if (!status.polled || nowMs - status.lastPollMs >= status.pollIntervalMs) {
+      _cursor = (index + 1) % _count;
+      return (int)index;
+    }
+  }
+
+  return -1;
+}
+
+uint32_t ModbusBusScheduler::timeUntilDueUs(uint32_t nowMs,
+                                            uint32_t nowUs) const {
+  if (_count == 0) {
+    return UINT32_MAX;
+  }
+
+  uint32_t waitMs = UINT32_MAX;
+  if (_followUp >= 0) {
+    waitMs = 0;
+  }
+  for (size_t i = 0; i < _count && waitMs > 0; i++) {
+    const ModbusSlaveStatus &status = _slaves[i];
+    uint32_t elapsedMs = nowMs - status.lastPollMs;
+    if (!status.polled || elapsedMs >= status.pollIntervalMs) {
+      waitMs = 0;
+    } else if (status.pollIntervalMs - elapsedMs < waitMs) {
+      waitMs = status.pollIntervalMs - elapsedMs;
+    }
+  }
+
+  uint32_t idleUs = nowUs - _busIdleSinceUs;
+  uint32_t gapWaitUs = idleUs < _gapUs ? _gapUs - idleUs : 0;
+  uint32_t waitUs = waitMs > UINT32_MAX / 1000 ? UINT32_MAX : waitMs * 1000;
+  return waitUs > gapWaitUs ? waitUs : gapWaitUs;
+}
+
+void ModbusBusScheduler::beginPoll(int index, uint32_t nowMs) {
+  _slaves[index].polled = true;
+  _slaves[index].lastPollMs = nowMs;
+}
+
+void ModbusBusScheduler::recordSuccess(int index, uint32_t responseUs,
+                                       uint32_t nowUs) {
+  ModbusSlaveStatus &status = _slaves[index];
+  status.successCount++;
+  _busIdleSinceUs = nowUs;
+
+  // Jacobson/Karels estimator: gains of 1/8 for the mean, 1/4 for deviation
+  if (status.successCount == 1) {
+    status.smoothedResponseUs = responseUs;
+    status.responseDeviationUs = responseUs / 2;
+  } else {
+    int32_t error = (int32_t)(responseUs - status.smoothedResponseUs);
+    uint32_t magnitude = error < 0 ? (uint32_t)-error : (uint32_t)error;
+    status.smoothedResponseUs += error / 8;
+    status.responseDeviationUs +=
+      ((int32_t)magnitude - (int32_t)status.responseDeviationUs) / 4;
+  }
+
+  uint32_t timeoutUs = status.smoothedResponseUs + 4 * status.responseDeviationUs;
+  uint32_t timeoutMs = (timeoutUs + 999) / 1000;
+  if (timeoutMs < _minTimeoutMs) {
+    timeoutMs = _minTimeoutMs;
+  } else if (timeoutMs > _maxTimeoutMs) {
+    timeoutMs = _maxTimeoutMs;
+  }
+  status.timeoutMs = timeoutMs;
+}
+
+void ModbusBusScheduler::recordFailure(int index, bool timedOut,
+                                       uint32_t nowUs) {
+  ModbusSlaveStatus &status = _slaves[index];
+  status.failureCount++;
+  _busIdleSinceUs = nowUs;
+
+  // A missed response may just have been slow; widen the window
+  if (timedOut) {
+    uint32_t timeoutMs = status.timeoutMs * 2;
+    status.timeoutMs = timeoutMs > _maxTimeoutMs ? _maxTimeoutMs : timeoutMs;
+  }
+}
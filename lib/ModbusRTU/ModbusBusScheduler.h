@@ -0,0 +1,123 @@
+/**
+ * ESP32 Room Climate Monitor - Multi-slave RS485 Bus Scheduler
+ *
+ * Decides which slave on a shared RS485 segment is polled next.
+ * - Round-robin over a configurable address list
+ * - Per-slave poll interval (0 = back-to-back as fast as the bus allows),
+ *   adjustable at run time
+ * - Only the Modbus inter-frame gap between consecutive transactions
+ * - Per-slave adaptive response timeout learned from observed response
+ *   times (smoothed mean + 4 x mean deviation, as for TCP RTO)
+ * - Follow-up polls for reads that span several frames
+ *
+ * The scheduler only does bookkeeping; the caller owns the transaction.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_BUS_SCHEDULER_H
+#define MODBUS_BUS_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MODBUS_BUS_MAX_SLAVES  16
+
+// Per-slave polling statistics
+struct ModbusSlaveStatus {
+  uint8_t address;
+  bool polled;               // At least one transaction attempted
+  uint32_t pollIntervalMs;   // Minimum time between polls of this slave
+  uint32_t lastPollMs;       // Start of the most recent transaction
+  uint32_t smoothedResponseUs;
+  uint32_t responseDeviationUs;
+  uint32_t timeoutMs;        // Current adaptive response timeout
+  uint32_t successCount;
+  uint32_t failureCount;
+};
+
+class ModbusBusScheduler {
+public:
+  ModbusBusScheduler();
+
+  /**
+   * Configure the slave list and timing limits
+   *
+   * @param addresses Modbus addresses to poll (at most MODBUS_BUS_MAX_SLAVES)
+   * @param count Number of addresses
+   * @param pollIntervalMs Initial minimum time between polls of a slave
+   * @param minTimeoutMs Lower bound for the adaptive timeout
+   * @param maxTimeoutMs Upper bound and initial value of the adaptive timeout
+   * @param interFrameGapUs Minimum bus silence between transactions
+   */
+  void begin(const uint8_t *addresses, size_t count, uint32_t pollIntervalMs,
+             uint32_t minTimeoutMs, uint32_t maxTimeoutMs,
+             uint32_t interFrameGapUs);
+
+  /**
+   * Pick the next slave that is due, continuing round-robin
+   *
+   * @param nowMs Current time in milliseconds
+   * @param nowUs Current time in microseconds (for the inter-frame gap)
+   * @return Slave index, or -1 if no slave is due or the bus needs to idle
+   */
+  int nextSlave(uint32_t nowMs, uint32_t nowUs);
+
+  /**
+   * Time until nextSlave() will return a slave, so the caller can sleep
+   * instead of polling the scheduler
+   *
+   * @return Microseconds until a slave is due and the bus gap has passed
+   *         (0 if one can be polled now, UINT32_MAX if none is configured)
+   */
+  uint32_t timeUntilDueUs(uint32_t nowMs, uint32_t nowUs) const;
+
+  /**
+   * Mark the start of a transaction with a slave
+   */
+  void beginPoll(int index, uint32_t nowMs);
+
+  /**
+   * Change how often a slave is polled, e.g. from an adaptive sampler;
+   * takes effect from the slave's next poll
+   */
+  void setPollInterval(int index, uint32_t intervalMs) {
+    _slaves[index].pollIntervalMs = intervalMs;
+  }
+
+  /**
+   * Make a slave the next one returned by nextSlave(), ignoring its poll
+   * interval (the inter-frame gap still applies). Used to send the
+   * remaining frames of a multi-frame read back to back.
+   */
+  void requestFollowUp(int index) { _followUp = index; }
+
+  /**
+   * Record a valid response and fold its timing into the adaptive timeout
+   *
+   * @param responseUs Time from end of request to end of response
+   */
+  void recordSuccess(int index, uint32_t responseUs, uint32_t nowUs);
+
+  /**
+   * Record a timeout or invalid response; doubles the slave's timeout
+   */
+  void recordFailure(int index, bool timedOut, uint32_t nowUs);
+
+  size_t slaveCount() const { return _count; }
+  const ModbusSlaveStatus &slave(int index) const { return _slaves[index]; }
+
+private:
+  ModbusSlaveStatus _slaves[MODBUS_BUS_MAX_SLAVES];
+  size_t _count;
+  size_t _cursor;            // Round-robin position
+  uint32_t _minTimeoutMs;
+  uint32_t _maxTimeoutMs;
+  uint32_t _gapUs;
+  uint32_t _busIdleSinceUs;  // End of the last transaction
+  int _followUp;             // Slave to poll next regardless of interval
+};
+
+#endif // MODBUS_BUS_SCHEDULER_H
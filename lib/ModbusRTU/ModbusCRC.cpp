@@ -0,0 +1,132 @@
+/**
+ * ESP32 Room Climate Monitor - CRC-16/Modbus Engine
+ *
+ * See ModbusCRC.h for the algorithm overview.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusCRC.h"
+
+#define MODBUS_CRC_POLYNOMIAL  0xA001 // Reversed representation of 0x8005
+
+namespace {
+
+/**
+ * Eight chained lookup tables for slice-by-8
+ * table[0] is the classic byte table; table[k][i] is the CRC contribution
+ * of byte i followed by k zero bytes
+ */
+struct CrcTables {
+  uint16_t table[8][256];
+};
+
+constexpr CrcTables generateTables() {
+  CrcTables tables = {};
+
+  for (uint16_t i = 0; i < 256; i++) {
+    uint16_t crc = i;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x0001) ? (crc >> 1) ^ MODBUS_CRC_POLYNOMIAL : crc >> 1;
+    }
+    tables.table[0][i] = crc;
+  }
+
+  for (uint8_t slice = 1; slice < 8; slice++) {
+    for (uint16_t i = 0; i < 256; i++) {
+      uint16_t previous = tables.table[slice - 1][i];
+      tables.table[slice][i] = (previous >> 8) ^ tables.table[0][previous & 0xFF];
+    }
+  }
+
+  return tables;
+}
+
+constexpr CrcTables CRC_TABLES = generateTables();
+
+// Spot-check the generated table against well-known CRC-16/Modbus entries
+static_assert(CRC_TABLES.table[0][0x01] == 0xC0C1, "CRC table generation error");
+static_assert(CRC_TABLES.table[0][0xFF] == 0x4040, "CRC table generation error");
+
+inline uint16_t tableStep(uint16_t crc, uint8_t value) {
+  return (crc >> 8) ^ CRC_TABLES.table[0][(crc ^ value) & 0xFF];
+}
+
+} // namespace
+
+uint16_t ModbusCRC::compute(const uint8_t *data, size_t length) {
+#if MODBUS_CRC_SLICE_BY == 8
+  return updateSlice8(MODBUS_CRC_INITIAL, data, length);
+#elif MODBUS_CRC_SLICE_BY == 4
+  return updateSlice4(MODBUS_CRC_INITIAL, data, length);
+#else
+  return update(MODBUS_CRC_INITIAL, data, length);
+#endif
+}
+
+uint16_t ModbusCRC::update(uint16_t crc, uint8_t value) {
+  return tableStep(crc, value);
+}
+
+uint16_t ModbusCRC::update(uint16_t crc, const uint8_t *data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    crc = tableStep(crc, data[i]);
+  }
+  return crc;
+}
+
+uint16_t ModbusCRC::updateBitwise(uint16_t crc, const uint8_t *data,
+                                  size_t length) {
+  // Process each byte in the data array
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i]; // XOR byte with CRC register
+
+    // Process each bit in the current byte
+    for (uint8_t j = 0; j < 8; j++) {
+      if (crc & 0x0001) {
+        // If LSB is 1, shift right and XOR with polynomial
+        crc = (crc >> 1) ^ MODBUS_CRC_POLYNOMIAL;
+      } else {
+        // If LSB is 0, just shift right
+        crc >>= 1;
+      }
+    }
+  }
+
+  return crc;
+}
+
+uint16_t ModbusCRC::updateSlice4(uint16_t crc, const uint8_t *data,
+                                 size_t length) {
+  const uint16_t (*t)[256] = CRC_TABLES.table;
+
+  while (length >= 4) {
+    // The 16-bit CRC register overlaps the first two bytes of each block
+    uint16_t low = crc ^ (data[0] | (data[1] << 8));
+    crc = t[3][low & 0xFF] ^ t[2][low >> 8] ^
+          t[1][data[2]] ^ t[0][data[3]];
+    data += 4;
+    length -= 4;
+  }
+
+  return update(crc, data, length);
+}
+
+uint16_t ModbusCRC::updateSlice8(uint16_t crc, const uint8_t *data,
+                                 size_t length) {
+  const uint16_t (*t)[256] = CRC_TABLES.table;
+
+  while (length >= 8) {
+    uint16_t low = crc ^ (data[0] | (data[1] << 8));
+    crc = t[7][low & 0xFF] ^ t[6][low >> 8] ^
+          t[5][data[2]] ^ t[4][data[3]] ^
+          t[3][data[4]] ^ t[2][data[5]] ^
+          t[1][data[6]] ^ t[0][data[7]];
+    data += 8;
+    length -= 8;
+  }
+
+  return updateSlice4(crc, data, length);
+}
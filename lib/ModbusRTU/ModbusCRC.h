@@ -0,0 +1,91 @@
+/**
+ * ESP32 Room Climate Monitor - CRC-16/Modbus Engine
+ *
+ * Shared CRC-16 implementation for Modbus RTU frames
+ * (polynomial 0xA001 reflected, initial value 0xFFFF, no final XOR).
+ *
+ * Lookup tables are generated at compile time and live in flash.
+ * Three equivalent algorithms are provided:
+ * - Bitwise:  reference implementation, no tables
+ * - Table:    one 256-entry lookup per byte (default)
+ * - Slice-N:  4 or 8 bytes per step using N chained tables
+ *
+ * The incremental API lets a receiver fold bytes into the CRC as they
+ * arrive. Running the CRC over a complete frame including its trailing
+ * CRC bytes yields MODBUS_CRC_RESIDUE (0) when the frame is intact.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_CRC_H
+#define MODBUS_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Algorithm used by ModbusCRC::compute(): 1 (table), 4 or 8 (slice-by-N)
+#ifndef MODBUS_CRC_SLICE_BY
+#define MODBUS_CRC_SLICE_BY  1
+#endif
+
+#define MODBUS_CRC_INITIAL   0xFFFF
+#define MODBUS_CRC_RESIDUE   0x0000
+
+class ModbusCRC {
+public:
+  ModbusCRC() : _crc(MODBUS_CRC_INITIAL) {}
+
+  // ---------- Incremental API ----------
+
+  void reset() { _crc = MODBUS_CRC_INITIAL; }
+  void update(uint8_t value) { _crc = update(_crc, value); }
+  void update(const uint8_t *data, size_t length) {
+    _crc = update(_crc, data, length);
+  }
+  uint16_t value() const { return _crc; }
+
+  // ---------- One-shot helpers ----------
+
+  /**
+   * Calculate the CRC of a buffer with the configured algorithm
+   *
+   * @param data Pointer to data array for CRC calculation
+   * @param length Number of bytes to include in CRC calculation
+   * @return 16-bit CRC value (transmitted low byte first)
+   */
+  static uint16_t compute(const uint8_t *data, size_t length);
+
+  /**
+   * Check a complete frame whose last two bytes are its CRC
+   *
+   * @return true if the frame is at least 3 bytes and its CRC matches
+   */
+  static bool check(const uint8_t *frame, size_t length) {
+    return length > 2 && update(MODBUS_CRC_INITIAL, frame, length) ==
+                         MODBUS_CRC_RESIDUE;
+  }
+
+  /**
+   * Append the CRC of the first length bytes at frame[length..length+1]
+   */
+  static void append(uint8_t *frame, size_t length) {
+    uint16_t crc = compute(frame, length);
+    frame[length] = crc & 0xFF;
+    frame[length + 1] = (crc >> 8) & 0xFF;
+  }
+
+  // ---------- Algorithm variants (continue from a running CRC) ----------
+
+  static uint16_t update(uint16_t crc, uint8_t value);
+  static uint16_t update(uint16_t crc, const uint8_t *data, size_t length);
+  static uint16_t updateBitwise(uint16_t crc, const uint8_t *data, size_t length);
+  static uint16_t updateSlice4(uint16_t crc, const uint8_t *data, size_t length);
+  static uint16_t updateSlice8(uint16_t crc, const uint8_t *data, size_t length);
+
+private:
+  uint16_t _crc;
+};
+
+#endif // MODBUS_CRC_H
@@ -0,0 +1,133 @@
+/**
+ * ESP32 Room Climate Monitor - Streaming Modbus RTU Frame Decoder
+ *
+ * See ModbusFrameDecoder.h for the resynchronization rules.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusFrameDecoder.h"
+#include <string.h>
+#include "ModbusCRC.h"
+
+#define MODBUS_EXCEPTION_BIT       0x80
+#define MODBUS_MAX_SLAVE_ADDRESS   247
+#define MODBUS_EXCEPTION_LENGTH    5   // Address, function, code, CRC
+#define MODBUS_ECHO_LENGTH         8   // Address, function, 2 words, CRC
+#define MODBUS_READ_OVERHEAD       5   // Address, function, count, CRC
+
+ModbusFrameDecoder::ModbusFrameDecoder()
+  : _buffer(),
+    _start(0),
+    _length(0),
+    _lineIdle(false),
+    _skipping(false),
+    _stats() {
+}
+
+void ModbusFrameDecoder::reset() {
+  _start = 0;
+  _length = 0;
+  _lineIdle = false;
+  _skipping = false;
+}
+
+size_t ModbusFrameDecoder::feed(const uint8_t *data, size_t length) {
+  if (_start > 0 && sizeof(_buffer) - _length < length) {
+    _length -= _start;
+    memmove(_buffer, _buffer + _start, _length);
+    _start = 0;
+  }
+  size_t room = sizeof(_buffer) - _length;
+  size_t taken = length < room ? length : room;
+  memcpy(_buffer + _length, data, taken);
+  _length += taken;
+  _lineIdle = false;
+  return taken;
+}
+
+size_t ModbusFrameDecoder::frameLength(const uint8_t *data, size_t available) {
+  if (available < 2) {
+    return 2;
+  }
+  if (data[0] == 0 || data[0] > MODBUS_MAX_SLAVE_ADDRESS) {
+    return 0; // Broadcasts are never answered
+  }
+  uint8_t function = data[1];
+  if (function & MODBUS_EXCEPTION_BIT) {
+    function &= (uint8_t)~MODBUS_EXCEPTION_BIT;
+    return function >= 0x01 && function <= 0x10 ? MODBUS_EXCEPTION_LENGTH : 0;
+  }
+  switch (function) {
+    case 0x01:
+    case 0x02:
+    case 0x03:
+    case 0x04: {
+      if (available < 3) {
+        return 3;
+      }
+      uint8_t count = data[2];
+      // Register reads return whole 16-bit words
+      if (count == 0 || (function >= 0x03 && (count & 1))) {
+        return 0;
+      }
+      return MODBUS_READ_OVERHEAD + count;
+    }
+    case 0x05:
+    case 0x06:
+    case 0x0F:
+    case 0x10:
+      return MODBUS_ECHO_LENGTH;
+    default:
+      return 0;
+  }
+}
+
+bool ModbusFrameDecoder::next(ModbusFrameView &frame) {
+  while (_start < _length) {
+    const uint8_t *data = _buffer + _start;
+    size_t available = _length - _start;
+    size_t length = frameLength(data, available);
+    if (length > available) {
+      if (!_lineIdle) {
+        return false; // Wait for the rest
+      }
+      skip(); // Truncated by silence
+      continue;
+    }
+    if (length == 0 || !ModbusCRC::check(data, length)) {
+      skip();
+      continue;
+    }
+
+    frame.data = data;
+    frame.length = length;
+    frame.address = data[0];
+    frame.exception = (data[1] & MODBUS_EXCEPTION_BIT) != 0;
+    frame.function = (uint8_t)(data[1] & ~MODBUS_EXCEPTION_BIT);
+    _start += length;
+    _skipping = false;
+    _stats.frames++;
+    if (frame.exception) {
+      _stats.exceptions++;
+    }
+    return true;
+  }
+  _start = 0;
+  _length = 0;
+  return false;
+}
+
+/**
+ * Drop the first buffered byte
+ */
+void ModbusFrameDecoder::skip() {
+  _start++;
+  _stats.bytesSkipped++;
+  if (!_skipping) {
+    _skipping = true;
+    _stats.resyncs++;
+  }
+}
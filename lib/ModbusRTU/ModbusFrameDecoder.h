@@ -0,0 +1,108 @@
+/**
+ * ESP32 Room Climate Monitor - Streaming Modbus RTU Frame Decoder
+ *
+ * Splits a byte stream from the master's side of the bus into response
+ * frames without relying on clean inter-frame gaps. Bytes are fed in
+ * chunks of any size (as they come out of the UART FIFO, or a capture
+ * file); next() then yields each complete frame as a view into the
+ * decoder's window, without copying it again.
+ *
+ * A frame's length follows from its first bytes: read replies (0x01 to
+ * 0x04) carry a byte count, write echoes (0x05, 0x06, 0x0F, 0x10) are 8
+ * bytes and exception replies 5. Where the bytes at the front cannot
+ * start a frame (bad address, unknown function, impossible byte count)
+ * or the frame fails its CRC, the decoder drops one byte and tries again
+ * at the next position, so it resynchronizes on the next frame after
+ * line noise, a request echo or a truncated reply, and separates frames
+ * that arrive back to back.
+ *
+ * endOfFrame() reports line silence (the 3.5-character gap): a frame
+ * still waiting for bytes then can never complete, and its first byte
+ * is skipped as well.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_FRAME_DECODER_H
+#define MODBUS_FRAME_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ModbusTransaction.h"
+
+// Bytes buffered; twice the largest frame, so a full window always
+// holds either a complete frame or bytes to skip
+#define MODBUS_DECODER_WINDOW  (2 * MODBUS_MAX_FRAME_LENGTH)
+
+// A decoded frame; data points into the decoder and stays valid until
+// the next call to feed() or reset()
+struct ModbusFrameView {
+  const uint8_t *data;       // Whole frame including the CRC
+  size_t length;
+  uint8_t address;
+  uint8_t function;          // Without the exception bit
+  bool exception;            // data[2] is the exception code
+};
+
+// Counters since construction
+struct ModbusDecoderStats {
+  uint32_t frames;           // Frames with a valid CRC, exceptions included
+  uint32_t exceptions;
+  uint32_t bytesSkipped;     // Bytes that were not part of any frame
+  uint32_t resyncs;          // Runs of skipped bytes
+};
+
+class ModbusFrameDecoder {
+public:
+  ModbusFrameDecoder();
+
+  // Drop buffered bytes (counters are kept)
+  void reset();
+
+  /**
+   * Append received bytes
+   *
+   * @return Bytes taken; less than length only if next() has not been
+   *         called to make room
+   */
+  size_t feed(const uint8_t *data, size_t length);
+
+  /**
+   * The line went silent: bytes of an incomplete frame will not be
+   * followed by the rest of it
+   */
+  void endOfFrame() { _lineIdle = true; }
+
+  /**
+   * Take the next complete frame
+   *
+   * @return false if no complete frame is buffered (more bytes needed)
+   */
+  bool next(ModbusFrameView &frame);
+
+  size_t buffered() const { return _length - _start; }
+  const ModbusDecoderStats &stats() const { return _stats; }
+
+  /**
+   * Length of the frame starting with these bytes, as far as they tell
+   *
+   * @return 0 if they cannot start a response frame; otherwise the
+   *         frame length, or the number of bytes needed to know it
+   *         (greater than available)
+   */
+  static size_t frameLength(const uint8_t *data, size_t available);
+
+private:
+  void skip();
+
+  uint8_t _buffer[MODBUS_DECODER_WINDOW];
+  size_t _start;             // First byte not yet decoded
+  size_t _length;            // End of the buffered bytes
+  bool _lineIdle;
+  bool _skipping;            // Inside a run of skipped bytes
+  ModbusDecoderStats _stats;
+};
+
+#endif // MODBUS_FRAME_DECODER_H
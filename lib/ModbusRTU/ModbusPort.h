@@ -0,0 +1,48 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Serial Port Interface
+ *
+ * Minimal byte-level view of an RS485 half-duplex link used by the
+ * Modbus RTU engine. Keeping the engine behind this interface means it
+ * never touches Serial2 directly and can run against any UART.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_PORT_H
+#define MODBUS_PORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class ModbusPort {
+public:
+  virtual ~ModbusPort() {}
+
+  /**
+   * Queue bytes for transmission without waiting for them to leave the wire
+   *
+   * @return Number of bytes accepted by the transmit buffer
+   */
+  virtual size_t write(const uint8_t *data, size_t length) = 0;
+
+  /**
+   * @return Number of received bytes ready to be read
+   */
+  virtual int available() = 0;
+
+  /**
+   * @return Next received byte, or -1 if none is pending
+   */
+  virtual int read() = 0;
+
+  /**
+   * Drive the RS485 transceiver DE/RE line (no-op for auto-direction modules)
+   *
+   * @param transmit true to enable the driver, false to listen
+   */
+  virtual void setTransmit(bool transmit) { (void)transmit; }
+};
+
+#endif // MODBUS_PORT_H
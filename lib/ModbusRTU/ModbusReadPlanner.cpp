@@ -0,0 +1,151 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Register Read Planner
+ *
+ * See ModbusReadPlanner.h for the merge policy.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusReadPlanner.h"
+#include "ModbusCRC.h"
+
+// Address + function + byte count + CRC around the register data
+#define MODBUS_READ_REPLY_OVERHEAD  5
+// Address + function + exception code + CRC
+#define MODBUS_EXCEPTION_LENGTH     5
+
+ModbusReadPlanner::ModbusReadPlanner()
+  : _requestCount(0),
+    _frameCount(0),
+    _maxGap(0),
+    _maxRegisters(MODBUS_MAX_READ_REGISTERS) {
+}
+
+void ModbusReadPlanner::begin(uint16_t maxGap, uint16_t maxRegisters) {
+  _requestCount = 0;
+  _frameCount = 0;
+  _maxGap = maxGap;
+  _maxRegisters = maxRegisters == 0 || maxRegisters > MODBUS_MAX_READ_REGISTERS ?
+                  MODBUS_MAX_READ_REGISTERS : maxRegisters;
+}
+
+bool ModbusReadPlanner::add(ModbusRegisterSpace space, uint16_t address,
+                            uint16_t count) {
+  if (_requestCount >= MODBUS_PLAN_MAX_REQUESTS || count == 0 ||
+      count > _maxRegisters || (uint32_t)address + count > 0x10000) {
+    return false;
+  }
+  _requests[_requestCount++] = {space, address, count};
+  return true;
+}
+
+size_t ModbusReadPlanner::plan() {
+  // Insertion sort by space, then start address (tables are tiny)
+  ModbusReadFrame sorted[MODBUS_PLAN_MAX_REQUESTS];
+  for (size_t i = 0; i < _requestCount; i++) {
+    ModbusReadFrame request = _requests[i];
+    size_t j = i;
+    while (j > 0 && (sorted[j - 1].space > request.space ||
+                     (sorted[j - 1].space == request.space &&
+                      sorted[j - 1].start > request.start))) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = request;
+  }
+
+  // Greedy merge: extend the current frame while the next range starts
+  // within maxGap of its end and the result still fits in one frame
+  _frameCount = 0;
+  for (size_t i = 0; i < _requestCount; i++) {
+    const ModbusReadFrame &request = sorted[i];
+    uint32_t requestEnd = (uint32_t)request.start + request.count;
+
+    if (_frameCount > 0) {
+      ModbusReadFrame &current = _frames[_frameCount - 1];
+      uint32_t currentEnd = (uint32_t)current.start + current.count;
+      uint32_t mergedEnd = requestEnd > currentEnd ? requestEnd : currentEnd;
+      if (request.space == current.space &&
+          request.start <= currentEnd + _maxGap &&
+          mergedEnd - current.start <= _maxRegisters) {
+        current.count = (uint16_t)(mergedEnd - current.start);
+        continue;
+      }
+    }
+    _frames[_frameCount++] = request;
+  }
+
+  return _frameCount;
+}
+
+size_t ModbusReadPlanner::buildRequest(const ModbusReadFrame &frame,
+                                       uint8_t slave, uint8_t *out) {
+  out[0] = slave;
+  out[1] = (uint8_t)frame.space;
+  out[2] = (uint8_t)(frame.start >> 8);
+  out[3] = (uint8_t)frame.start;
+  out[4] = (uint8_t)(frame.count >> 8);
+  out[5] = (uint8_t)frame.count;
+  ModbusCRC::append(out, 6);
+  return MODBUS_READ_REQUEST_LENGTH;
+}
+
+ModbusReadResponse ModbusReadPlanner::decode(const ModbusReadFrame &frame,
+                                             uint8_t slave,
+                                             const uint8_t *response,
+                                             size_t length) {
+  ModbusReadResponse result = {MODBUS_READ_OK, 0, nullptr, 0};
+
+  if (length < MODBUS_EXCEPTION_LENGTH) {
+    result.status = MODBUS_READ_TOO_SHORT;
+    return result;
+  }
+  if (response[0] != slave) {
+    result.status = MODBUS_READ_WRONG_ADDRESS;
+    return result;
+  }
+
+  // Exception replies have a fixed length and the function's top bit set
+  if (response[1] == (uint8_t)(frame.space | 0x80)) {
+    if (length != MODBUS_EXCEPTION_LENGTH) {
+      result.status = MODBUS_READ_WRONG_LENGTH;
+    } else if (!ModbusCRC::check(response, length)) {
+      result.status = MODBUS_READ_CRC_ERROR;
+    } else {
+      result.status = MODBUS_READ_EXCEPTION;
+      result.exceptionCode = response[2];
+    }
+    return result;
+  }
+
+  if (response[1] != (uint8_t)frame.space) {
+    result.status = MODBUS_READ_WRONG_FUNCTION;
+    return result;
+  }
+  if (response[2] != frame.count * 2 ||
+      length != MODBUS_READ_REPLY_OVERHEAD + (size_t)frame.count * 2) {
+    result.status = MODBUS_READ_WRONG_LENGTH;
+    return result;
+  }
+  if (!ModbusCRC::check(response, length)) {
+    result.status = MODBUS_READ_CRC_ERROR;
+    return result;
+  }
+
+  result.data = response + 3;
+  result.count = frame.count;
+  return result;
+}
+
+bool ModbusReadPlanner::lookup(const ModbusReadFrame &frame,
+                               const ModbusReadResponse &response,
+                               ModbusRegisterSpace space, uint16_t address,
+                               uint16_t &value) {
+  if (response.status != MODBUS_READ_OK || !frame.contains(space, address)) {
+    return false;
+  }
+  value = response.value((uint16_t)(address - frame.start));
+  return true;
+}
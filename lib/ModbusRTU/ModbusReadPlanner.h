@@ -0,0 +1,137 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Register Read Planner
+ *
+ * Callers declare the registers they need; plan() turns them into the
+ * fewest Read Holding Registers (0x03) / Read Input Registers (0x04)
+ * requests:
+ * - Requests are sorted per register space and merged when they are
+ *   adjacent, overlap, or lie at most maxGap registers apart
+ * - A frame never exceeds maxRegisters (125 by the Modbus spec)
+ *
+ * Reading a gap register costs 2 bytes on the wire while a separate
+ * transaction costs 13 bytes plus the device turnaround, so small gaps
+ * are worth bridging on devices that answer reads of unmapped addresses.
+ * Devices that reject them (exception 0x02) need maxGap = 0.
+ *
+ * decode() validates a response of any length against the frame that
+ * was sent, and lookup() extracts a declared register from it.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_READ_PLANNER_H
+#define MODBUS_READ_PLANNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MODBUS_PLAN_MAX_REQUESTS   16
+#define MODBUS_MAX_READ_REGISTERS  125
+#define MODBUS_READ_REQUEST_LENGTH 8
+
+// Register spaces, numbered by their read function code
+enum ModbusRegisterSpace : uint8_t {
+  MODBUS_HOLDING_REGISTERS = 0x03,
+  MODBUS_INPUT_REGISTERS = 0x04
+};
+
+// One planned read transaction
+struct ModbusReadFrame {
+  ModbusRegisterSpace space;
+  uint16_t start;
+  uint16_t count;
+
+  bool contains(ModbusRegisterSpace registerSpace, uint16_t address) const {
+    return registerSpace == space && address >= start &&
+           address - start < count;
+  }
+};
+
+enum ModbusReadStatus : uint8_t {
+  MODBUS_READ_OK,
+  MODBUS_READ_TOO_SHORT,       // Fewer bytes than the smallest valid reply
+  MODBUS_READ_WRONG_ADDRESS,   // Reply from another slave
+  MODBUS_READ_WRONG_FUNCTION,  // Function code does not match the request
+  MODBUS_READ_EXCEPTION,       // Slave returned an exception code
+  MODBUS_READ_WRONG_LENGTH,    // Byte count or frame length mismatch
+  MODBUS_READ_CRC_ERROR
+};
+
+// Result of decoding a read response
+struct ModbusReadResponse {
+  ModbusReadStatus status;
+  uint8_t exceptionCode;       // Valid for MODBUS_READ_EXCEPTION
+  const uint8_t *data;         // Big-endian register values (status OK)
+  uint16_t count;              // Registers in data
+
+  uint16_t value(uint16_t index) const {
+    return (uint16_t)((data[index * 2] << 8) | data[index * 2 + 1]);
+  }
+};
+
+class ModbusReadPlanner {
+public:
+  ModbusReadPlanner();
+
+  /**
+   * Clear all requests and set the merge limits
+   *
+   * @param maxGap Unrequested registers that may be read to join two ranges
+   * @param maxRegisters Upper bound on registers per frame
+   */
+  void begin(uint16_t maxGap, uint16_t maxRegisters = MODBUS_MAX_READ_REGISTERS);
+
+  /**
+   * Declare registers to read; call plan() afterwards
+   *
+   * @return false if the request table is full or the range is invalid
+   */
+  bool add(ModbusRegisterSpace space, uint16_t address, uint16_t count = 1);
+
+  /**
+   * Coalesce the declared ranges into frames
+   *
+   * @return Number of frames
+   */
+  size_t plan();
+
+  size_t frameCount() const { return _frameCount; }
+  const ModbusReadFrame &frame(size_t index) const { return _frames[index]; }
+
+  /**
+   * Build the request for a planned frame, CRC included
+   *
+   * @param out Buffer of at least MODBUS_READ_REQUEST_LENGTH bytes
+   * @return Frame length
+   */
+  static size_t buildRequest(const ModbusReadFrame &frame, uint8_t slave,
+                             uint8_t *out);
+
+  /**
+   * Validate a response to a planned frame
+   */
+  static ModbusReadResponse decode(const ModbusReadFrame &frame, uint8_t slave,
+                                   const uint8_t *response, size_t length);
+
+  /**
+   * Extract one register from a decoded response
+   *
+   * @return false if the frame does not cover the register
+   */
+  static bool lookup(const ModbusReadFrame &frame,
+                     const ModbusReadResponse &response,
+                     ModbusRegisterSpace space, uint16_t address,
+                     uint16_t &value);
+
+private:
+  ModbusReadFrame _requests[MODBUS_PLAN_MAX_REQUESTS];
+  ModbusReadFrame _frames[MODBUS_PLAN_MAX_REQUESTS];
+  size_t _requestCount;
+  size_t _frameCount;
+  uint16_t _maxGap;
+  uint16_t _maxRegisters;
+};
+
+#endif // MODBUS_READ_PLANNER_H
@@ -0,0 +1,102 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Slave Retry Policy
+ *
+ * See ModbusRetryPolicy.h for the retry and circuit breaker rules.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusRetryPolicy.h"
+
+static const char *const HEALTH_NAMES[] = {"unknown", "online", "retrying",
+                                           "offline"};
+
+ModbusRetryPolicy::ModbusRetryPolicy()
+  : _slaves(),
+    _slaveCount(0),
+    _fastRetries(0),
+    _offlineAfter(0),
+    _backoffMinMs(0),
+    _backoffMaxMs(0),
+    _probeIntervalMs(0) {
+}
+
+void ModbusRetryPolicy::begin(size_t slaveCount, uint8_t fastRetries,
+                              uint32_t backoffMinMs, uint32_t backoffMaxMs,
+                              uint8_t offlineAfter, uint32_t probeIntervalMs) {
+  _slaveCount = slaveCount > MODBUS_BUS_MAX_SLAVES ? MODBUS_BUS_MAX_SLAVES :
+                slaveCount;
+  _fastRetries = fastRetries;
+  _offlineAfter = offlineAfter == 0 ? 1 : offlineAfter;
+  _backoffMinMs = backoffMinMs;
+  _backoffMaxMs = backoffMaxMs < backoffMinMs ? backoffMinMs : backoffMaxMs;
+  _probeIntervalMs = probeIntervalMs;
+
+  for (size_t i = 0; i < _slaveCount; i++) {
+    ModbusHealthStatus &status = _slaves[i];
+    status.state = MODBUS_HEALTH_UNKNOWN;
+    status.retries = 0;
+    status.failedPolls = 0;
+    status.retryIntervalMs = backoffMinMs;
+    status.offlineSinceMs = 0;
+    status.fastRetries = 0;
+    status.trips = 0;
+  }
+}
+
+bool ModbusRetryPolicy::recordSuccess(int index) {
+  ModbusHealthStatus &status = _slaves[index];
+  bool recovered = status.state == MODBUS_HEALTH_RETRYING ||
+                   status.state == MODBUS_HEALTH_OFFLINE;
+  status.state = MODBUS_HEALTH_ONLINE;
+  status.retries = 0;
+  status.failedPolls = 0;
+  status.retryIntervalMs = _backoffMinMs;
+  return recovered;
+}
+
+bool ModbusRetryPolicy::recordFailure(int index, bool timedOut,
+                                      uint32_t nowMs) {
+  ModbusHealthStatus &status = _slaves[index];
+
+  // A garbled reply proves the slave is there; ask again straight away
+  if (!timedOut && status.retries < _fastRetries) {
+    status.retries++;
+    status.fastRetries++;
+    if (status.state != MODBUS_HEALTH_OFFLINE) {
+      status.state = MODBUS_HEALTH_RETRYING;
+    }
+    return true;
+  }
+
+  status.retries = 0;
+  if (status.failedPolls < 255) {
+    status.failedPolls++;
+  }
+  if (status.failedPolls >= _offlineAfter) {
+    if (status.state != MODBUS_HEALTH_OFFLINE) {
+      status.state = MODBUS_HEALTH_OFFLINE;
+      status.offlineSinceMs = nowMs;
+      status.trips++;
+    }
+    status.retryIntervalMs = _probeIntervalMs;
+    return false;
+  }
+
+  // Double per failed poll: backoffMinMs, 2x, 4x, ... up to backoffMaxMs
+  uint32_t intervalMs = _backoffMinMs;
+  for (uint8_t n = 1; n < status.failedPolls && intervalMs < _backoffMaxMs;
+       n++) {
+    intervalMs *= 2;
+  }
+  status.retryIntervalMs = intervalMs > _backoffMaxMs ? _backoffMaxMs :
+                           intervalMs;
+  status.state = MODBUS_HEALTH_RETRYING;
+  return false;
+}
+
+const char *ModbusRetryPolicy::stateName(ModbusHealthState state) {
+  return state <= MODBUS_HEALTH_OFFLINE ? HEALTH_NAMES[state] : "?";
+}
@@ -0,0 +1,105 @@
+/**
+ * ESP32 Room Climate Monitor - Modbus Slave Retry Policy
+ *
+ * Decides how soon a slave that stopped answering properly is tried
+ * again, so a dead slave does not keep taking bus time from the others:
+ *
+ *   UNKNOWN/ONLINE -> RETRYING -> OFFLINE (circuit open)
+ *         ^              |           |
+ *         +--------------+-----------+   first valid reply
+ *
+ * - A corrupted or invalid reply (CRC error, exception, wrong echo) is
+ *   usually line noise: it is retried at once, up to fastRetries times
+ * - A timeout, or a poll whose fast retries all failed, is a failed
+ *   poll; consecutive failed polls back off exponentially from
+ *   backoffMinMs up to backoffMaxMs
+ * - offlineAfter failed polls in a row open the circuit: the slave is
+ *   parked and only probed every probeIntervalMs until it answers
+ * - Any valid reply closes the circuit and clears the backoff
+ *
+ * Like ModbusBusScheduler this class only does bookkeeping: the caller
+ * applies the returned interval to the scheduler and sends the retries.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_RETRY_POLICY_H
+#define MODBUS_RETRY_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ModbusBusScheduler.h"
+
+enum ModbusHealthState : uint8_t {
+  MODBUS_HEALTH_UNKNOWN,   // Not polled successfully yet
+  MODBUS_HEALTH_ONLINE,    // Last poll answered
+  MODBUS_HEALTH_RETRYING,  // Failing; retried quickly, then with backoff
+  MODBUS_HEALTH_OFFLINE    // Circuit open; probed every probeIntervalMs
+};
+
+// Per-slave fault state
+struct ModbusHealthStatus {
+  ModbusHealthState state;
+  uint8_t retries;           // Fast retries used on the current poll
+  uint8_t failedPolls;       // Consecutive failed polls
+  uint32_t retryIntervalMs;  // Time until the slave is tried again
+  uint32_t offlineSinceMs;   // When the circuit last opened
+  uint32_t fastRetries;      // Immediate retries since boot
+  uint32_t trips;            // Times the circuit opened since boot
+};
+
+class ModbusRetryPolicy {
+public:
+  ModbusRetryPolicy();
+
+  /**
+   * Configure the retry limits
+   *
+   * @param slaveCount Number of slaves (at most MODBUS_BUS_MAX_SLAVES)
+   * @param fastRetries Immediate retries after an invalid reply
+   * @param backoffMinMs Retry interval after the first failed poll
+   * @param backoffMaxMs Ceiling for the doubling retry interval
+   * @param offlineAfter Consecutive failed polls that open the circuit
+   * @param probeIntervalMs Time between probes of an offline slave
+   */
+  void begin(size_t slaveCount, uint8_t fastRetries, uint32_t backoffMinMs,
+             uint32_t backoffMaxMs, uint8_t offlineAfter,
+             uint32_t probeIntervalMs);
+
+  /**
+   * Record a valid reply: the slave is online again
+   *
+   * @return true if it was retrying or offline before
+   */
+  bool recordSuccess(int index);
+
+  /**
+   * Record a timeout or invalid reply
+   *
+   * @return true if the slave should be retried immediately; otherwise
+   *         retryInterval() says when to poll it next
+   */
+  bool recordFailure(int index, bool timedOut, uint32_t nowMs);
+
+  ModbusHealthState state(int index) const { return _slaves[index].state; }
+  uint32_t retryInterval(int index) const {
+    return _slaves[index].retryIntervalMs;
+  }
+  const ModbusHealthStatus &slave(int index) const { return _slaves[index]; }
+
+  // Lower-case name for logs and JSON
+  static const char *stateName(ModbusHealthState state);
+
+private:
+  ModbusHealthStatus _slaves[MODBUS_BUS_MAX_SLAVES];
+  size_t _slaveCount;
+  uint8_t _fastRetries;
+  uint8_t _offlineAfter;
+  uint32_t _backoffMinMs;
+  uint32_t _backoffMaxMs;
+  uint32_t _probeIntervalMs;
+};
+
+#endif // MODBUS_RETRY_POLICY_H
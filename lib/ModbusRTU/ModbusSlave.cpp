@@ -0,0 +1,154 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking Modbus RTU Slave
+ *
+ * See ModbusSlave.h for the supported requests.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusSlave.h"
+#include "ModbusCRC.h"
+#include "ModbusReadPlanner.h"
+
+ModbusSlave::ModbusSlave()
+  : _port(nullptr),
+    _map(nullptr),
+    _address(0),
+    _charTimeUs(0),
+    _silenceUs(0),
+    _lastByteUs(0),
+    _txEndUs(0),
+    _lastAnswerDelayUs(0),
+    _transmitting(false),
+    _overrun(false),
+    _rxBuffer(),
+    _rxLength(0),
+    _stats() {
+}
+
+void ModbusSlave::begin(ModbusPort *port, uint32_t baudRate, uint8_t address,
+                        ModbusRegisterMap *map) {
+  _port = port;
+  _map = map;
+  _address = address;
+  _charTimeUs = ModbusTransaction::charTimeForBaudRate(baudRate);
+  _silenceUs = ModbusTransaction::silenceForBaudRate(baudRate);
+  _rxLength = 0;
+  _overrun = false;
+  _transmitting = false;
+  _stats = ModbusSlaveStats();
+  if (_port != nullptr) {
+    _port->setTransmit(false);
+  }
+}
+
+bool ModbusSlave::poll(uint32_t nowUs, bool lineIdle) {
+  if (_port == nullptr) {
+    return false;
+  }
+
+  // Release the line once the response has left it
+  if (_transmitting) {
+    if ((int32_t)(nowUs - _txEndUs) < 0) {
+      return false;
+    }
+    _port->setTransmit(false);
+    _transmitting = false;
+  }
+
+  while (_port->available() > 0) {
+    int value = _port->read();
+    if (value < 0) {
+      break;
+    }
+    if (_rxLength < MODBUS_MAX_FRAME_LENGTH) {
+      _rxBuffer[_rxLength++] = (uint8_t)value;
+    } else {
+      _overrun = true;
+    }
+    _lastByteUs = nowUs;
+  }
+
+  // Frame ends after 3.5 character times of line silence
+  bool silent = nowUs - _lastByteUs >= _silenceUs;
+  if (_rxLength == 0 || !(silent || lineIdle)) {
+    return false;
+  }
+
+  uint8_t response[MODBUS_MAX_FRAME_LENGTH];
+  size_t length = _overrun ? 0 : respond(_rxBuffer, _rxLength, response);
+  _rxLength = 0;
+  _overrun = false;
+  if (length == 0) {
+    return false;
+  }
+
+  _port->setTransmit(true);
+  _port->write(response, length);
+  _txEndUs = nowUs + (uint32_t)length * _charTimeUs;
+  _transmitting = true;
+  _lastAnswerDelayUs = silent ? nowUs - _lastByteUs - _silenceUs : 0;
+  return true;
+}
+
+size_t ModbusSlave::respond(const uint8_t *request, size_t length,
+                            uint8_t *response) {
+  if (length < 4 || !ModbusCRC::check(request, length)) {
+    _stats.crcErrors++;
+    return 0;
+  }
+  if (request[0] != _address) {
+    _stats.ignored++;
+    return 0;
+  }
+  _stats.requests++;
+
+  uint8_t function = request[1];
+  if (function != MODBUS_HOLDING_REGISTERS &&
+      function != MODBUS_INPUT_REGISTERS) {
+    return exceptionResponse(function, MODBUS_EXCEPTION_ILLEGAL_FUNCTION,
+                             response);
+  }
+  if (length != MODBUS_READ_REQUEST_LENGTH) {
+    return exceptionResponse(function, MODBUS_EXCEPTION_ILLEGAL_VALUE,
+                             response);
+  }
+
+  uint16_t start = (uint16_t)((request[2] << 8) | request[3]);
+  uint16_t count = (uint16_t)((request[4] << 8) | request[5]);
+  if (count == 0 || count > MODBUS_MAX_READ_REGISTERS) {
+    return exceptionResponse(function, MODBUS_EXCEPTION_ILLEGAL_VALUE,
+                             response);
+  }
+
+  uint16_t values[MODBUS_MAX_READ_REGISTERS];
+  uint8_t code = _map != nullptr ?
+    _map->readRegisters(function, start, count, values) :
+    MODBUS_EXCEPTION_ILLEGAL_ADDRESS;
+  if (code != 0) {
+    return exceptionResponse(function, code, response);
+  }
+
+  response[0] = _address;
+  response[1] = function;
+  response[2] = (uint8_t)(count * 2);
+  for (uint16_t i = 0; i < count; i++) {
+    response[3 + i * 2] = (uint8_t)(values[i] >> 8);
+    response[4 + i * 2] = (uint8_t)values[i];
+  }
+  size_t responseLength = 3 + (size_t)count * 2;
+  ModbusCRC::append(response, responseLength);
+  return responseLength + 2;
+}
+
+size_t ModbusSlave::exceptionResponse(uint8_t function, uint8_t code,
+                                      uint8_t *response) {
+  _stats.exceptions++;
+  response[0] = _address;
+  response[1] = (uint8_t)(function | 0x80);
+  response[2] = code;
+  ModbusCRC::append(response, 3);
+  return 5;
+}
@@ -0,0 +1,116 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking Modbus RTU Slave
+ *
+ * Answers Read Holding Registers (0x03) and Read Input Registers (0x04)
+ * requests addressed to this node from a ModbusRegisterMap, so a PLC or
+ * other master can read cached values without reaching the devices
+ * behind them. poll() collects request bytes, ends a frame after the
+ * 3.5-character silence like ModbusTransaction, and answers at once:
+ * building a response is a copy out of the map plus a CRC, so the reply
+ * starts well within a millisecond of the request ending.
+ *
+ * Frames for other addresses, broadcasts and frames with a bad CRC are
+ * ignored as the spec requires; unsupported functions and reads outside
+ * the map get exception replies (0x01, 0x02, 0x03).
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_SLAVE_H
+#define MODBUS_SLAVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ModbusPort.h"
+#include "ModbusTransaction.h"
+
+#define MODBUS_EXCEPTION_ILLEGAL_FUNCTION  0x01
+#define MODBUS_EXCEPTION_ILLEGAL_ADDRESS   0x02
+#define MODBUS_EXCEPTION_ILLEGAL_VALUE     0x03
+
+// Registers a slave serves; implemented by the application
+class ModbusRegisterMap {
+public:
+  virtual ~ModbusRegisterMap() {}
+
+  /**
+   * Copy a range of registers for a read request
+   *
+   * @param function 0x03 (holding) or 0x04 (input)
+   * @param values Receives count registers
+   * @return 0, or the Modbus exception code to answer with
+   */
+  virtual uint8_t readRegisters(uint8_t function, uint16_t start,
+                                uint16_t count, uint16_t *values) = 0;
+};
+
+// Counters since begin()
+struct ModbusSlaveStats {
+  uint32_t requests;         // Frames addressed to this node
+  uint32_t exceptions;       // Answered with an exception
+  uint32_t crcErrors;        // Frames dropped for a bad CRC
+  uint32_t ignored;          // Frames for other nodes and broadcasts
+};
+
+class ModbusSlave {
+public:
+  ModbusSlave();
+
+  /**
+   * @param port Serial port of the slave-side RS485 transceiver
+   * @param address This node's Modbus address (1..247)
+   * @param map Source of register values
+   */
+  void begin(ModbusPort *port, uint32_t baudRate, uint8_t address,
+             ModbusRegisterMap *map);
+
+  /**
+   * Receive, and answer a request whose frame has ended; never blocks
+   *
+   * @param lineIdle The UART driver has already seen the line go silent
+   *                 (RX timeout), so the frame ends with the bytes read now
+   * @return true if a response was queued in this call
+   */
+  bool poll(uint32_t nowUs, bool lineIdle = false);
+
+  // True while a request is arriving or a response is on the wire, when
+  // poll() needs calling again within a character time or two
+  bool busy() const { return _rxLength > 0 || _transmitting; }
+
+  // How long after the end of the last answered request (its closing
+  // silence) poll() noticed it, 0 when ended by lineIdle; add the time
+  // poll() took for the total
+  uint32_t lastAnswerDelayUs() const { return _lastAnswerDelayUs; }
+
+  const ModbusSlaveStats &stats() const { return _stats; }
+
+  /**
+   * Build the response to a complete request frame (CRC included)
+   *
+   * @param response At least MODBUS_MAX_FRAME_LENGTH bytes
+   * @return Response length, or 0 if nothing must be sent
+   */
+  size_t respond(const uint8_t *request, size_t length, uint8_t *response);
+
+private:
+  size_t exceptionResponse(uint8_t function, uint8_t code,
+                           uint8_t *response);
+
+  ModbusPort *_port;
+  ModbusRegisterMap *_map;
+  uint8_t _address;
+  uint32_t _charTimeUs;
+  uint32_t _silenceUs;
+  uint32_t _lastByteUs;      // Time the most recent request byte was seen
+  uint32_t _txEndUs;         // Estimated time the response leaves the wire
+  uint32_t _lastAnswerDelayUs;
+  bool _transmitting;
+  bool _overrun;
+  uint8_t _rxBuffer[MODBUS_MAX_FRAME_LENGTH];
+  size_t _rxLength;
+  ModbusSlaveStats _stats;
+};
+
+#endif // MODBUS_SLAVE_H
@@ -0,0 +1,158 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking Modbus RTU Transaction
+ *
+ * See ModbusTransaction.h for the state machine overview.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "ModbusTransaction.h"
+
+// Modbus RTU frames characters as 11 bits (start + 8 data + parity/stop + stop)
+#define MODBUS_BITS_PER_CHAR        11
+// Above 19200 baud the spec fixes the inter-frame silence at 1.75 ms
+#define MODBUS_FIXED_SILENCE_BAUD   19200
+#define MODBUS_FIXED_SILENCE_US     1750
+
+ModbusTransaction::ModbusTransaction()
+  : _port(nullptr),
+    _state(MODBUS_IDLE),
+    _charTimeUs(0),
+    _silenceUs(0),
+    _timeoutUs(0),
+    _txEndUs(0),
+    _lastByteUs(0),
+    _responseTimeUs(0),
+    _rxLength(0),
+    _rxCrc(MODBUS_CRC_INITIAL),
+    _overrun(false) {
+}
+
+void ModbusTransaction::begin(ModbusPort *port, uint32_t baudRate) {
+  _port = port;
+  _state = MODBUS_IDLE;
+  setBaudRate(baudRate);
+}
+
+void ModbusTransaction::setBaudRate(uint32_t baudRate) {
+  _charTimeUs = charTimeForBaudRate(baudRate);
+  _silenceUs = silenceForBaudRate(baudRate);
+}
+
+uint32_t ModbusTransaction::charTimeForBaudRate(uint32_t baudRate) {
+  // Round up so the silence window is never shorter than the spec requires
+  return (MODBUS_BITS_PER_CHAR * 1000000UL + baudRate - 1) / baudRate;
+}
+
+uint32_t ModbusTransaction::silenceForBaudRate(uint32_t baudRate) {
+  if (baudRate > MODBUS_FIXED_SILENCE_BAUD) {
+    return MODBUS_FIXED_SILENCE_US;
+  }
+  return (charTimeForBaudRate(baudRate) * 7 + 1) / 2; // 3.5 characters
+}
+
+bool ModbusTransaction::start(const uint8_t *frame, size_t length,
+                              uint32_t timeoutMs, uint32_t nowUs) {
+  if (_port == nullptr || busy() || length == 0 ||
+      length > MODBUS_MAX_FRAME_LENGTH) {
+    return false;
+  }
+
+  // Discard anything left over from a previous exchange so it cannot be
+  // mistaken for the start of this response
+  while (_port->available() > 0) {
+    _port->read();
+  }
+
+  _rxLength = 0;
+  _rxCrc = MODBUS_CRC_INITIAL;
+  _overrun = false;
+  _responseTimeUs = 0;
+  _timeoutUs = timeoutMs * 1000UL;
+
+  _port->setTransmit(true);
+  _port->write(frame, length);
+
+  // The UART shifts the frame out in the background; keep the driver
+  // enabled for the wire time plus one character of margin
+  _txEndUs = nowUs + (uint32_t)(length + 1) * _charTimeUs;
+  _state = MODBUS_TRANSMITTING;
+  return true;
+}
+
+ModbusTransactionState ModbusTransaction::poll(uint32_t nowUs) {
+  if (_state == MODBUS_TRANSMITTING) {
+    if ((int32_t)(nowUs - _txEndUs) < 0) {
+      return _state;
+    }
+    _port->setTransmit(false);
+    _state = MODBUS_AWAITING;
+  }
+
+  if (_state != MODBUS_AWAITING) {
+    return _state;
+  }
+
+  drainReceiver(nowUs);
+
+  if (_rxLength > 0) {
+    // Frame ends after 3.5 character times of line silence
+    if (nowUs - _lastByteUs >= _silenceUs) {
+      _responseTimeUs = _lastByteUs - _txEndUs;
+      _state = MODBUS_COMPLETE;
+    }
+  } else if (nowUs - _txEndUs >= _timeoutUs) {
+    _responseTimeUs = nowUs - _txEndUs;
+    _state = MODBUS_TIMEOUT;
+  }
+
+  return _state;
+}
+
+uint32_t ModbusTransaction::timeUntilEventUs(uint32_t nowUs) const {
+  uint32_t dueUs;
+  if (_state == MODBUS_TRANSMITTING) {
+    dueUs = _txEndUs;
+  } else if (_state == MODBUS_AWAITING) {
+    dueUs = _rxLength > 0 ? _lastByteUs + _silenceUs : _txEndUs + _timeoutUs;
+  } else {
+    return 0;
+  }
+  int32_t remainingUs = (int32_t)(dueUs - nowUs);
+  return remainingUs > 0 ? (uint32_t)remainingUs : 0;
+}
+
+void ModbusTransaction::reset() {
+  if (_state == MODBUS_TRANSMITTING && _port != nullptr) {
+    _port->setTransmit(false);
+  }
+  _state = MODBUS_IDLE;
+}
+
+/**
+ * Move all pending bytes from the port into the frame buffer
+ * Bytes beyond the maximum frame length are consumed and flagged as overrun
+ */
+void ModbusTransaction::drainReceiver(uint32_t nowUs) {
+  bool received = false;
+
+  while (_port->available() > 0) {
+    int value = _port->read();
+    if (value < 0) {
+      break;
+    }
+    if (_rxLength < MODBUS_MAX_FRAME_LENGTH) {
+      _rxBuffer[_rxLength++] = (uint8_t)value;
+      _rxCrc = ModbusCRC::update(_rxCrc, (uint8_t)value);
+    } else {
+      _overrun = true;
+    }
+    received = true;
+  }
+
+  if (received) {
+    _lastByteUs = nowUs;
+  }
+}
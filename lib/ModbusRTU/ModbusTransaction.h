@@ -0,0 +1,135 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking Modbus RTU Transaction
+ *
+ * Event-driven request/response state machine for a Modbus RTU master:
+ *
+ *   IDLE -> TRANSMITTING -> AWAITING -> COMPLETE | TIMEOUT
+ *
+ * start() queues the request frame and returns immediately. poll() is
+ * then called from loop() (or from a UART RX callback, but never from
+ * both) to move received bytes into the frame buffer and advance the
+ * state. The end of a response frame is detected with the Modbus
+ * 3.5-character silence rule instead of a fixed byte count, so replies
+ * of any length and exception frames are handled the same way.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MODBUS_TRANSACTION_H
+#define MODBUS_TRANSACTION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ModbusCRC.h"
+#include "ModbusPort.h"
+
+// Largest Modbus RTU application data unit (address + PDU + CRC)
+#define MODBUS_MAX_FRAME_LENGTH  256
+
+enum ModbusTransactionState : uint8_t {
+  MODBUS_IDLE,          // No request in flight
+  MODBUS_TRANSMITTING,  // Request is shifting out of the UART
+  MODBUS_AWAITING,      // Listening for (the rest of) the response
+  MODBUS_COMPLETE,      // Response frame ended by inter-frame silence
+  MODBUS_TIMEOUT        // No response before the deadline
+};
+
+class ModbusTransaction {
+public:
+  ModbusTransaction();
+
+  /**
+   * Bind the engine to a port and derive frame timings from the baud rate
+   *
+   * @param port Serial port connected to the RS485 transceiver
+   * @param baudRate Line speed used to compute character and silence times
+   */
+  void begin(ModbusPort *port, uint32_t baudRate);
+
+  /**
+   * Re-derive frame timings after the port changed speed (while idle)
+   */
+  void setBaudRate(uint32_t baudRate);
+
+  /**
+   * Queue a request frame and start a transaction
+   *
+   * @param frame Complete request including CRC
+   * @param length Number of bytes in frame
+   * @param timeoutMs Maximum wait for the first response byte after TX ends
+   * @param nowUs Current time in microseconds
+   * @return false if a transaction is already in flight or the frame is invalid
+   */
+  bool start(const uint8_t *frame, size_t length, uint32_t timeoutMs,
+             uint32_t nowUs);
+
+  /**
+   * Advance the state machine; never blocks
+   *
+   * @param nowUs Current time in microseconds
+   * @return State after processing
+   */
+  ModbusTransactionState poll(uint32_t nowUs);
+
+  /**
+   * Time until poll() can next change state without a new byte arriving:
+   * the end of transmission, the end-of-frame silence after the last
+   * byte, or the response timeout. The caller may sleep that long and
+   * rely on an RX notification for anything earlier.
+   *
+   * @return Microseconds (0 if due now or not busy)
+   */
+  uint32_t timeUntilEventUs(uint32_t nowUs) const;
+
+  /**
+   * Return to IDLE after a COMPLETE or TIMEOUT result has been consumed
+   */
+  void reset();
+
+  ModbusTransactionState state() const { return _state; }
+  bool busy() const {
+    return _state == MODBUS_TRANSMITTING || _state == MODBUS_AWAITING;
+  }
+
+  const uint8_t *response() const { return _rxBuffer; }
+  size_t responseLength() const { return _rxLength; }
+
+  // CRC folded in as bytes arrived; true if the complete frame checks out
+  bool crcValid() const {
+    return _rxLength > 2 && !_overrun && _rxCrc == MODBUS_CRC_RESIDUE;
+  }
+
+  // True if the response was longer than MODBUS_MAX_FRAME_LENGTH
+  bool overrun() const { return _overrun; }
+
+  // Time from the end of transmission to the end of the response frame
+  uint32_t responseTimeUs() const { return _responseTimeUs; }
+
+  uint32_t charTimeUs() const { return _charTimeUs; }
+  uint32_t silenceTimeUs() const { return _silenceUs; }
+
+  static uint32_t charTimeForBaudRate(uint32_t baudRate);
+  static uint32_t silenceForBaudRate(uint32_t baudRate);
+
+private:
+  void drainReceiver(uint32_t nowUs);
+
+  ModbusPort *_port;
+  ModbusTransactionState _state;
+
+  uint32_t _charTimeUs;     // Time for one 11-bit RTU character
+  uint32_t _silenceUs;      // 3.5 character end-of-frame silence
+  uint32_t _timeoutUs;      // Response timeout for the current request
+  uint32_t _txEndUs;        // Estimated time the last request bit leaves
+  uint32_t _lastByteUs;     // Time the most recent response byte was seen
+  uint32_t _responseTimeUs;
+
+  uint8_t _rxBuffer[MODBUS_MAX_FRAME_LENGTH];
+  size_t _rxLength;
+  uint16_t _rxCrc;
+  bool _overrun;
+};
+
+#endif // MODBUS_TRANSACTION_H
@@ -0,0 +1,375 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking MQTT Publisher
+ *
+ * See MqttClient.h for the supported subset of MQTT 3.1.1.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "MqttClient.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Control packet types (first byte, flags included)
+#define MQTT_CONNECT     0x10
+#define MQTT_CONNACK     0x20
+#define MQTT_PUBLISH_QOS1 0x32
+#define MQTT_PUBACK      0x40
+#define MQTT_PINGREQ     0xC0
+#define MQTT_PINGRESP    0xD0
+#define MQTT_DISCONNECT  0xE0
+
+#define MQTT_PROTOCOL_LEVEL  4     // 3.1.1
+#define MQTT_CLEAN_SESSION   0x02
+
+/**
+ * Encode the "remaining length" field (1-4 bytes)
+ */
+static size_t encodeLength(uint8_t *out, size_t length) {
+  size_t count = 0;
+  do {
+    uint8_t digit = length % 128;
+    length /= 128;
+    out[count++] = length > 0 ? (uint8_t)(digit | 0x80) : digit;
+  } while (length > 0 && count < 4);
+  return count;
+}
+
+MqttClient::MqttClient()
+  : _fd(-1),
+    _brokerAddress(0),
+    _port(0),
+    _clientId(""),
+    _keepAliveS(0),
+    _retryMinMs(0),
+    _retryMaxMs(0),
+    _retryDelayMs(0),
+    _state(MQTT_DISCONNECTED),
+    _enabled(false),
+    _stateSinceMs(0),
+    _lastSentMs(0),
+    _lastReceivedMs(0),
+    _inFlight(false),
+    _acknowledged(false),
+    _publishedMs(0),
+    _packetId(0),
+    _tx(),
+    _txLength(0),
+    _rx(),
+    _rxLength(0),
+    _stats() {
+}
+
+bool MqttClient::begin(const char *brokerAddress, uint16_t port,
+                       const char *clientId, uint16_t keepAliveS,
+                       uint32_t retryMinMs, uint32_t retryMaxMs) {
+  struct in_addr address;
+  if (inet_pton(AF_INET, brokerAddress, &address) != 1) {
+    return false;
+  }
+  _brokerAddress = address.s_addr;
+  _port = port;
+  _clientId = clientId;
+  _keepAliveS = keepAliveS;
+  _retryMinMs = retryMinMs;
+  _retryMaxMs = retryMaxMs;
+  _retryDelayMs = 0;  // First attempt on the first poll
+  _state = MQTT_DISCONNECTED;
+  _enabled = true;
+  _stats = MqttClientStats();
+  return true;
+}
+
+void MqttClient::end() {
+  if (_state == MQTT_CONNECTED) {
+    const uint8_t disconnect[] = {MQTT_DISCONNECT, 0};
+    send(_fd, disconnect, sizeof(disconnect), MSG_NOSIGNAL);
+  }
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+  _state = MQTT_DISCONNECTED;
+  _enabled = false;
+}
+
+bool MqttClient::takeAcknowledged() {
+  bool acknowledged = _acknowledged;
+  _acknowledged = false;
+  return acknowledged;
+}
+
+void MqttClient::poll(uint32_t nowMs, uint32_t waitMs) {
+  if (!_enabled) {
+    return;
+  }
+  if (_state == MQTT_DISCONNECTED) {
+    if (nowMs - _stateSinceMs < _retryDelayMs) {
+      return;
+    }
+    startConnect(nowMs);
+    if (_state == MQTT_DISCONNECTED) {
+      return;
+    }
+  }
+
+  fd_set readable;
+  fd_set writable;
+  FD_ZERO(&readable);
+  FD_ZERO(&writable);
+  FD_SET(_fd, &readable);
+  if (_state == MQTT_CONNECTING || _txLength > 0) {
+    FD_SET(_fd, &writable);
+  }
+  struct timeval timeout;
+  timeout.tv_sec = waitMs / 1000;
+  timeout.tv_usec = (waitMs % 1000) * 1000;
+  if (select(_fd + 1, &readable, &writable, nullptr, &timeout) < 0) {
+    return; // Interrupted; try again on the next pass
+  }
+
+  if (_state == MQTT_CONNECTING) {
+    if (FD_ISSET(_fd, &writable)) {
+      finishConnect(nowMs);
+    } else if (nowMs - _stateSinceMs > MQTT_CONNECT_TIMEOUT) {
+      fail(nowMs);
+    }
+    return;
+  }
+  if (FD_ISSET(_fd, &readable)) {
+    receive(nowMs);
+  }
+  if (_state != MQTT_DISCONNECTED && FD_ISSET(_fd, &writable)) {
+    flush(nowMs);
+  }
+
+  uint32_t keepAliveMs = (uint32_t)_keepAliveS * 1000;
+  if (_state == MQTT_AWAITING_CONNACK) {
+    if (nowMs - _stateSinceMs > MQTT_CONNECT_TIMEOUT) {
+      fail(nowMs);
+    }
+  } else if (_state == MQTT_CONNECTED && keepAliveMs > 0) {
+    // An unacknowledged publish or a silent broker ends the session
+    if ((_inFlight && nowMs - _publishedMs > keepAliveMs) ||
+        nowMs - _lastReceivedMs > keepAliveMs + keepAliveMs / 2) {
+      fail(nowMs);
+    } else if (_txLength == 0 && nowMs - _lastSentMs >= keepAliveMs / 2) {
+      // Bytes still waiting on a backed-up socket count as traffic: one
+      // ping per pass would otherwise pile up in _tx until it overflows
+      const uint8_t ping[] = {MQTT_PINGREQ, 0};
+      queue(ping, sizeof(ping));
+      flush(nowMs);
+    }
+  }
+}
+
+void MqttClient::startConnect(uint32_t nowMs) {
+  _fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (_fd < 0) {
+    fail(nowMs);
+    return;
+  }
+  int flags = fcntl(_fd, F_GETFL, 0);
+  fcntl(_fd, F_SETFL, flags | O_NONBLOCK);
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(_port);
+  address.sin_addr.s_addr = _brokerAddress;
+  _state = MQTT_CONNECTING;
+  _stateSinceMs = nowMs;
+  if (connect(_fd, (struct sockaddr *)&address, sizeof(address)) < 0 &&
+      errno != EINPROGRESS) {
+    fail(nowMs);
+  }
+}
+
+void MqttClient::finishConnect(uint32_t nowMs) {
+  int error = 0;
+  socklen_t length = sizeof(error);
+  if (getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 ||
+      error != 0) {
+    fail(nowMs);
+    return;
+  }
+
+  size_t idLength = strlen(_clientId);
+  uint8_t packet[64];
+  size_t remaining = 10 + 2 + idLength;
+  if (remaining + 2 > sizeof(packet)) {
+    fail(nowMs);
+    return;
+  }
+  const uint8_t header[] = {
+    MQTT_CONNECT, (uint8_t)remaining,
+    0, 4, 'M', 'Q', 'T', 'T', MQTT_PROTOCOL_LEVEL, MQTT_CLEAN_SESSION,
+    (uint8_t)(_keepAliveS >> 8), (uint8_t)_keepAliveS,
+    (uint8_t)(idLength >> 8), (uint8_t)idLength
+  };
+  memcpy(packet, header, sizeof(header));
+  memcpy(packet + sizeof(header), _clientId, idLength);
+  _txLength = 0;
+  _rxLength = 0;
+  queue(packet, sizeof(header) + idLength);
+  _state = MQTT_AWAITING_CONNACK;
+  _stateSinceMs = nowMs;
+  flush(nowMs);
+}
+
+bool MqttClient::publish(const char *topic, const uint8_t *payload,
+                         size_t length, uint32_t nowMs) {
+  if (_state != MQTT_CONNECTED || _inFlight) {
+    return false;
+  }
+  size_t topicLength = strlen(topic);
+  size_t remaining = 2 + topicLength + 2 + length;
+  uint8_t header[5];
+  header[0] = MQTT_PUBLISH_QOS1;
+  size_t headerLength = 1 + encodeLength(header + 1, remaining);
+  if (_txLength + headerLength + remaining > MQTT_MAX_PACKET) {
+    return false;
+  }
+
+  _packetId = (uint16_t)(_packetId + 1);
+  if (_packetId == 0) {
+    _packetId = 1;
+  }
+  const uint8_t topicHeader[] = {(uint8_t)(topicLength >> 8),
+                                 (uint8_t)topicLength};
+  const uint8_t packetId[] = {(uint8_t)(_packetId >> 8), (uint8_t)_packetId};
+  queue(header, headerLength);
+  queue(topicHeader, sizeof(topicHeader));
+  queue((const uint8_t *)topic, topicLength);
+  queue(packetId, sizeof(packetId));
+  queue(payload, length);
+
+  _inFlight = true;
+  _publishedMs = nowMs;
+  _stats.published++;
+  flush(nowMs);
+  return true;
+}
+
+void MqttClient::receive(uint32_t nowMs) {
+  ssize_t received = recv(_fd, _rx + _rxLength, sizeof(_rx) - _rxLength, 0);
+  if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return;
+  }
+  if (received <= 0) {
+    fail(nowMs); // Closed by the broker, or reset
+    return;
+  }
+  _rxLength += (size_t)received;
+  _lastReceivedMs = nowMs;
+
+  // The broker only sends short packets: one length byte
+  while (_rxLength >= 2) {
+    if (_rx[1] & 0x80 || (size_t)_rx[1] + 2 > sizeof(_rx)) {
+      fail(nowMs); // Unexpectedly large packet
+      return;
+    }
+    size_t length = (size_t)_rx[1] + 2;
+    if (_rxLength < length) {
+      return;
+    }
+    if (!handlePacket(_rx, length, nowMs)) {
+      fail(nowMs);
+      return;
+    }
+    _rxLength -= length;
+    memmove(_rx, _rx + length, _rxLength);
+  }
+}
+
+/**
+ * @return false if the session must be dropped
+ */
+bool MqttClient::handlePacket(const uint8_t *packet, size_t length,
+                              uint32_t nowMs) {
+  switch (packet[0]) {
+    case MQTT_CONNACK:
+      // Return code 0 = accepted
+      if (_state != MQTT_AWAITING_CONNACK || length != 4 || packet[3] != 0) {
+        return false;
+      }
+      _state = MQTT_CONNECTED;
+      _stateSinceMs = nowMs;
+      _retryDelayMs = 0;
+      _inFlight = false;
+      _stats.connects++;
+      return true;
+    case MQTT_PUBACK:
+      if (length == 4 && _inFlight &&
+          (uint16_t)((packet[2] << 8) | packet[3]) == _packetId) {
+        _inFlight = false;
+        _acknowledged = true;
+        _stats.acknowledged++;
+      }
+      return true;
+    default:
+      return true; // PINGRESP and anything else
+  }
+}
+
+bool MqttClient::queue(const uint8_t *data, size_t length) {
+  if (_txLength + length > MQTT_MAX_PACKET) {
+    return false;
+  }
+  memcpy(_tx + _txLength, data, length);
+  _txLength += length;
+  return true;
+}
+
+void MqttClient::flush(uint32_t nowMs) {
+  if (_txLength == 0) {
+    return;
+  }
+  ssize_t sent = send(_fd, _tx, _txLength, MSG_NOSIGNAL);
+  if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return;
+  }
+  if (sent <= 0) {
+    fail(nowMs);
+    return;
+  }
+  _txLength -= (size_t)sent;
+  memmove(_tx, _tx + sent, _txLength);
+  _lastSentMs = nowMs;
+  _stats.bytesSent += (uint32_t)sent;
+}
+
+/**
+ * Drop the connection and schedule the next attempt
+ */
+void MqttClient::fail(uint32_t nowMs) {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+  if (_state == MQTT_CONNECTED) {
+    _stats.disconnects++;
+  } else {
+    _stats.failures++;
+  }
+  _state = MQTT_DISCONNECTED;
+  _stateSinceMs = nowMs;
+  _retryDelayMs = _retryDelayMs == 0 ? _retryMinMs :
+                  _retryDelayMs * 2 < _retryMaxMs ? _retryDelayMs * 2 :
+                  _retryMaxMs;
+  _inFlight = false;
+  _txLength = 0;
+  _rxLength = 0;
+}
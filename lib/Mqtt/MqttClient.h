@@ -0,0 +1,124 @@
+/**
+ * ESP32 Room Climate Monitor - Non-blocking MQTT Publisher
+ *
+ * The part of MQTT 3.1.1 a sensor node needs to push data: CONNECT with a
+ * clean session, QoS 1 PUBLISH with one message in flight, PUBACK,
+ * keep-alive PINGREQ and DISCONNECT. Nothing is subscribed to.
+ *
+ * Like the HTTP status server it runs on non-blocking BSD sockets: poll()
+ * waits in select() for at most the given time and then advances the
+ * connection by whatever is ready, so the caller's task never blocks on
+ * a slow or absent broker.
+ * - The broker is an IPv4 address: resolving a host name would block
+ * - A refused or lost connection is retried after a delay that doubles
+ *   from retryMinMs up to retryMaxMs, and resets once connected
+ * - A publish not acknowledged within the keep-alive time drops the
+ *   connection; the caller publishes the same payload again after the
+ *   reconnect (at-least-once delivery)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MQTT_MAX_PACKET        1024  // Largest PUBLISH (topic + payload + 8)
+#define MQTT_CONNECT_TIMEOUT   5000  // TCP connect plus CONNACK (milliseconds)
+
+enum MqttState : uint8_t {
+  MQTT_DISCONNECTED,         // Waiting for the retry delay
+  MQTT_CONNECTING,           // TCP connect in progress
+  MQTT_AWAITING_CONNACK,
+  MQTT_CONNECTED
+};
+
+// Counters since begin()
+struct MqttClientStats {
+  uint32_t connects;         // Sessions the broker accepted
+  uint32_t failures;         // Connection attempts that failed
+  uint32_t disconnects;      // Established sessions lost
+  uint32_t published;        // PUBLISH packets sent
+  uint32_t acknowledged;     // PUBACKs received
+  uint32_t bytesSent;
+};
+
+class MqttClient {
+public:
+  MqttClient();
+
+  /**
+   * @param brokerAddress Dotted IPv4 address
+   * @param clientId Kept by reference; must outlive the client
+   */
+  bool begin(const char *brokerAddress, uint16_t port, const char *clientId,
+             uint16_t keepAliveS, uint32_t retryMinMs, uint32_t retryMaxMs);
+
+  /**
+   * Connect, send and receive as far as possible without blocking
+   *
+   * @param waitMs Longest time to wait in select() for socket activity
+   */
+  void poll(uint32_t nowMs, uint32_t waitMs);
+
+  /**
+   * Queue a QoS 1 PUBLISH
+   *
+   * @return false unless connected with no publish in flight and the
+   *         packet fits MQTT_MAX_PACKET
+   */
+  bool publish(const char *topic, const uint8_t *payload, size_t length,
+               uint32_t nowMs);
+
+  // Close the session cleanly (DISCONNECT); no reconnect until begin()
+  void end();
+
+  bool connected() const { return _state == MQTT_CONNECTED; }
+  bool inFlight() const { return _inFlight; }
+  MqttState state() const { return _state; }
+
+  /**
+   * @return true once for each publish the broker acknowledged
+   */
+  bool takeAcknowledged();
+
+  const MqttClientStats &stats() const { return _stats; }
+
+private:
+  void startConnect(uint32_t nowMs);
+  void finishConnect(uint32_t nowMs);
+  void receive(uint32_t nowMs);
+  bool handlePacket(const uint8_t *packet, size_t length, uint32_t nowMs);
+  bool queue(const uint8_t *data, size_t length);
+  void flush(uint32_t nowMs);
+  void fail(uint32_t nowMs);
+
+  int _fd;
+  uint32_t _brokerAddress;   // Network byte order
+  uint16_t _port;
+  const char *_clientId;
+  uint16_t _keepAliveS;
+  uint32_t _retryMinMs;
+  uint32_t _retryMaxMs;
+  uint32_t _retryDelayMs;
+  MqttState _state;
+  bool _enabled;
+  uint32_t _stateSinceMs;    // Retry wait, connect or CONNACK start
+  uint32_t _lastSentMs;      // For keep-alive pings
+  uint32_t _lastReceivedMs;
+  bool _inFlight;
+  bool _acknowledged;
+  uint32_t _publishedMs;
+  uint16_t _packetId;
+  uint8_t _tx[MQTT_MAX_PACKET];
+  size_t _txLength;
+  uint8_t _rx[16];           // CONNACK, PUBACK and PINGRESP are 2-4 bytes
+  size_t _rxLength;
+  MqttClientStats _stats;
+};
+
+#endif // MQTT_CLIENT_H
@@ -0,0 +1,82 @@
+/**
+ * ESP32 Room Climate Monitor - MQTT Store-and-forward Queue
+ *
+ * See MqttOutbox.h for the drop policy.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "MqttOutbox.h"
+#include <string.h>
+
+#define OUTBOX_LENGTH_FIELD  2
+
+MqttOutbox::MqttOutbox(uint8_t *storage, size_t capacity)
+  : _storage(storage),
+    _capacity(capacity),
+    _head(0),
+    _used(0),
+    _count(0),
+    _dropped(0) {
+}
+
+bool MqttOutbox::push(const uint8_t *payload, size_t length) {
+  size_t needed = length + OUTBOX_LENGTH_FIELD;
+  if (needed > _capacity || length > UINT16_MAX) {
+    return false;
+  }
+  while (_capacity - _used < needed) {
+    pop();
+    _dropped++;
+  }
+
+  size_t tail = (_head + _used) % _capacity;
+  const uint8_t header[OUTBOX_LENGTH_FIELD] = {(uint8_t)length,
+                                               (uint8_t)(length >> 8)};
+  write(tail, header, OUTBOX_LENGTH_FIELD);
+  write((tail + OUTBOX_LENGTH_FIELD) % _capacity, payload, length);
+  _used += needed;
+  _count++;
+  return true;
+}
+
+size_t MqttOutbox::frontLength() const {
+  if (_count == 0) {
+    return 0;
+  }
+  uint8_t header[OUTBOX_LENGTH_FIELD];
+  read(_head, header, OUTBOX_LENGTH_FIELD);
+  return (size_t)header[0] | ((size_t)header[1] << 8);
+}
+
+size_t MqttOutbox::front(uint8_t *out) const {
+  size_t length = frontLength();
+  read((_head + OUTBOX_LENGTH_FIELD) % _capacity, out, length);
+  return length;
+}
+
+void MqttOutbox::pop() {
+  if (_count == 0) {
+    return;
+  }
+  size_t size = frontLength() + OUTBOX_LENGTH_FIELD;
+  _head = (_head + size) % _capacity;
+  _used -= size;
+  _count--;
+}
+
+// Copies that may wrap around the end of the ring
+
+void MqttOutbox::write(size_t position, const uint8_t *data, size_t length) {
+  size_t first = _capacity - position < length ? _capacity - position : length;
+  memcpy(_storage + position, data, first);
+  memcpy(_storage, data + first, length - first);
+}
+
+void MqttOutbox::read(size_t position, uint8_t *data, size_t length) const {
+  size_t first = _capacity - position < length ? _capacity - position : length;
+  memcpy(data, _storage + position, first);
+  memcpy(data + first, _storage, length - first);
+}
@@ -0,0 +1,66 @@
+/**
+ * ESP32 Room Climate Monitor - MQTT Store-and-forward Queue
+ *
+ * Bounded FIFO of encoded payloads waiting for the broker, kept in one
+ * fixed byte ring (a 2-byte length before each payload) so small batches
+ * do not waste fixed-size slots. When the broker stays unreachable and
+ * the ring fills up, the oldest payloads are dropped to make room: after
+ * an outage the most recent data arrives first-in-first-out, and the
+ * number of payloads lost is counted.
+ *
+ * Single-threaded: owned by the task that publishes.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class MqttOutbox {
+public:
+  /**
+   * @param storage Ring memory, owned by the caller
+   */
+  MqttOutbox(uint8_t *storage, size_t capacity);
+
+  /**
+   * Append a payload, dropping the oldest ones if it does not fit
+   *
+   * @return false if the payload is larger than the whole ring
+   */
+  bool push(const uint8_t *payload, size_t length);
+
+  /**
+   * Copy the oldest payload without removing it
+   *
+   * @param out At least frontLength() bytes
+   * @return Its length, 0 if the queue is empty
+   */
+  size_t front(uint8_t *out) const;
+  size_t frontLength() const;
+
+  // Remove the oldest payload (after the broker acknowledged it)
+  void pop();
+
+  size_t count() const { return _count; }
+  size_t bytesUsed() const { return _used; }
+  uint32_t dropped() const { return _dropped; }
+
+private:
+  void write(size_t position, const uint8_t *data, size_t length);
+  void read(size_t position, uint8_t *data, size_t length) const;
+
+  uint8_t *_storage;
+  size_t _capacity;
+  size_t _head;              // Oldest payload's length field
+  size_t _used;              // Bytes including length fields
+  size_t _count;
+  uint32_t _dropped;         // Payloads discarded to make room
+};
+
+#endif // MQTT_OUTBOX_H
@@ -0,0 +1,96 @@
+/**
+ * ESP32 Room Climate Monitor - Adafruit GFX Stand-in (native builds)
+ *
+ * Text cursor, text size and rectangle fills behave like Adafruit GFX
+ * (6x8 character cells scaled by the text size). Glyphs are replaced by
+ * a deterministic bit pattern per character: the simulator checks that
+ * pixels change when the text changes, not what the text looks like.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+#include "Arduino.h"
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t width, int16_t height)
+    : _width(width), _height(height), _cursorX(0), _cursorY(0),
+      _textSize(1), _textColor(1), _wrap(true) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t row = y; row < y + h; row++) {
+      for (int16_t column = x; column < x + w; column++) {
+        drawPixel(column, row, color);
+      }
+    }
+  }
+
+  void setCursor(int16_t x, int16_t y) {
+    _cursorX = x;
+    _cursorY = y;
+  }
+  void setTextSize(uint8_t size) { _textSize = size > 0 ? size : 1; }
+  void setTextColor(uint16_t color) { _textColor = color; }
+  void setTextColor(uint16_t color, uint16_t background) {
+    (void)background;
+    _textColor = color;
+  }
+  void setTextWrap(bool wrap) { _wrap = wrap; }
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  int16_t getCursorX() const { return _cursorX; }
+  int16_t getCursorY() const { return _cursorY; }
+
+  size_t write(uint8_t character) override {
+    if (character == '\n') {
+      _cursorX = 0;
+      _cursorY += 8 * _textSize;
+      return 1;
+    }
+    if (character == '\r') {
+      return 1;
+    }
+    if (_wrap && _cursorX + 6 * _textSize > _width) {
+      _cursorX = 0;
+      _cursorY += 8 * _textSize;
+    }
+    drawGlyph(character);
+    _cursorX += 6 * _textSize;
+    return 1;
+  }
+  using Print::write;
+
+protected:
+  int16_t _width;
+  int16_t _height;
+
+private:
+  // 5x7 placeholder glyph derived from the character code
+  void drawGlyph(uint8_t character) {
+    for (int16_t column = 0; column < 5; column++) {
+      uint8_t bits = (uint8_t)((character * 37 + column * 11) & 0x7F);
+      for (int16_t row = 0; row < 7; row++) {
+        if (bits & (1 << row)) {
+          fillRect(_cursorX + column * _textSize, _cursorY + row * _textSize,
+                   _textSize, _textSize, _textColor);
+        }
+      }
+    }
+  }
+
+  int16_t _cursorX;
+  int16_t _cursorY;
+  uint8_t _textSize;
+  uint16_t _textColor;
+  bool _wrap;
+};
+
+#endif // NATIVE_ADAFRUIT_GFX_H
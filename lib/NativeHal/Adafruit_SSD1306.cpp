@@ -0,0 +1,75 @@
+/**
+ * ESP32 Room Climate Monitor - Adafruit SSD1306 Stand-in (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "Adafruit_SSD1306.h"
+
+// Data bytes per I2C transaction after the control byte, as in the driver
+#define SSD1306_WIRE_CHUNK  (I2C_BUFFER_LENGTH - 1)
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t width, uint8_t height,
+                                   TwoWire *wire, int8_t resetPin)
+  : Adafruit_GFX(width, height), _wire(wire), _address(0), _buffer(nullptr) {
+  (void)resetPin;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  delete[] _buffer;
+}
+
+bool Adafruit_SSD1306::begin(uint8_t vccState, uint8_t address, bool reset,
+                             bool periphBegin) {
+  (void)vccState;
+  (void)reset;
+  (void)periphBegin;
+  _address = address;
+  if (_buffer == nullptr) {
+    _buffer = new uint8_t[_width * ((_height + 7) / 8)];
+  }
+  clearDisplay();
+  return true;
+}
+
+void Adafruit_SSD1306::display() {
+  const uint8_t window[] = {
+    0x00,                                  // Control byte: commands
+    0x21, 0, (uint8_t)(_width - 1),        // Full column range
+    0x22, 0, (uint8_t)((_height / 8) - 1)  // Full page range
+  };
+  _wire->beginTransmission(_address);
+  _wire->write(window, sizeof(window));
+  _wire->endTransmission();
+
+  size_t length = _width * ((_height + 7) / 8);
+  for (size_t offset = 0; offset < length; offset += SSD1306_WIRE_CHUNK) {
+    size_t chunk = length - offset < SSD1306_WIRE_CHUNK ?
+                   length - offset : SSD1306_WIRE_CHUNK;
+    _wire->beginTransmission(_address);
+    _wire->write((uint8_t)0x40);           // Control byte: display RAM data
+    _wire->write(_buffer + offset, chunk);
+    _wire->endTransmission();
+  }
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  memset(_buffer, 0, _width * ((_height + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (_buffer == nullptr || x < 0 || y < 0 || x >= _width || y >= _height) {
+    return;
+  }
+  uint8_t &cell = _buffer[x + (y / 8) * _width];
+  uint8_t bit = (uint8_t)(1 << (y & 7));
+  if (color == SSD1306_WHITE) {
+    cell |= bit;
+  } else if (color == SSD1306_BLACK) {
+    cell &= (uint8_t)~bit;
+  } else {
+    cell ^= bit;
+  }
+}
@@ -0,0 +1,43 @@
+/**
+ * ESP32 Room Climate Monitor - Adafruit SSD1306 Stand-in (native builds)
+ *
+ * Framebuffer in the SSD1306 page layout (one byte = 8 vertical pixels).
+ * display() sends the whole frame over Wire exactly like the real driver,
+ * so a SimulatedSSD1306 attached to Wire sees the same traffic.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_ADAFRUIT_SSD1306_H
+#define NATIVE_ADAFRUIT_SSD1306_H
+
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SSD1306_BLACK         0
+#define SSD1306_WHITE         1
+#define SSD1306_INVERSE       2
+#define SSD1306_SWITCHCAPVCC  0x02
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t width, uint8_t height, TwoWire *wire,
+                   int8_t resetPin = -1);
+  ~Adafruit_SSD1306() override;
+
+  bool begin(uint8_t vccState = SSD1306_SWITCHCAPVCC, uint8_t address = 0,
+             bool reset = true, bool periphBegin = true);
+  void display();
+  void clearDisplay();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  uint8_t *getBuffer() { return _buffer; }
+
+private:
+  TwoWire *_wire;
+  uint8_t _address;
+  uint8_t *_buffer;
+};
+
+#endif // NATIVE_ADAFRUIT_SSD1306_H
@@ -0,0 +1,101 @@
+/**
+ * ESP32 Room Climate Monitor - Arduino Core Stand-in (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "Arduino.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include "VirtualClock.h"
+#include "WiFi.h"
+
+#define NATIVE_GPIO_COUNT  40
+
+uint64_t VirtualClock::_nowUs = 0;
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+EspClass ESP;
+WiFiClass WiFi;
+
+static uint8_t gpioLevels[NATIVE_GPIO_COUNT];
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(VirtualClock::nowUs() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)VirtualClock::nowUs();
+}
+
+void delay(uint32_t ms) {
+  VirtualClock::advanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  VirtualClock::advanceUs(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < NATIVE_GPIO_COUNT) {
+    gpioLevels[pin] = value ? HIGH : LOW;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < NATIVE_GPIO_COUNT ? gpioLevels[pin] : LOW;
+}
+
+// ==================== PRINT ====================
+
+size_t Print::print(long value) {
+  char text[24];
+  snprintf(text, sizeof(text), "%ld", value);
+  return print(text);
+}
+
+size_t Print::print(unsigned long value) {
+  char text[24];
+  snprintf(text, sizeof(text), "%lu", value);
+  return print(text);
+}
+
+size_t Print::printf(const char *format, ...) {
+  char text[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  return print(text);
+}
+
+// ==================== HARDWARE SERIAL ====================
+
+int HardwareSerial::available() {
+  return _device ? _device->available(VirtualClock::nowUs()) : 0;
+}
+
+int HardwareSerial::read() {
+  return _device ? _device->read(VirtualClock::nowUs()) : -1;
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t length) {
+  if (_device != nullptr) {
+    _device->transmit(data, length, VirtualClock::nowUs());
+  } else if (_echo) {
+    fwrite(data, 1, length, _echoFile);
+  }
+  return length;
+}
@@ -0,0 +1,56 @@
+/**
+ * ESP32 Room Climate Monitor - Arduino Core Stand-in (native builds)
+ *
+ * Lets src/main.cpp compile unchanged on Linux for the simulator:
+ * timing comes from the VirtualClock, GPIO writes are recorded, Serial
+ * prints to stdout and the FreeRTOS API is emulated single-threaded.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "HardwareSerial.h"
+#include "NativeFreeRTOS.h"
+#include "Print.h"
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0x01
+#define OUTPUT  0x03
+
+// Flash string helper; strings already live in normal memory on the host
+#define F(text) (text)
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+// Heap statistics of the Arduino core's ESP object; the host heap is
+// not bounded, so a fixed ESP32-sized heap is reported
+#define NATIVE_HEAP_SIZE  327680
+
+class EspClass {
+public:
+  uint32_t getHeapSize() { return NATIVE_HEAP_SIZE; }
+  uint32_t getFreeHeap() { return NATIVE_HEAP_SIZE; }
+  uint32_t getMinFreeHeap() { return NATIVE_HEAP_SIZE; }
+};
+extern EspClass ESP;
+
+// Application entry points defined in src/main.cpp
+void setup();
+void loop();
+
+#endif // NATIVE_ARDUINO_H
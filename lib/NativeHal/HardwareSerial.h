@@ -0,0 +1,100 @@
+/**
+ * ESP32 Room Climate Monitor - Hardware Serial (native builds)
+ *
+ * Serial writes to stdout (it can be muted for long simulations, or
+ * redirected to a file to capture binary telemetry).
+ * Any port can be attached to a SerialDevice, which receives every
+ * transmitted frame and delivers reply bytes when the virtual clock
+ * reaches their arrival time; Serial2 is attached to the simulated
+ * RS485 bus this way, Serial1 to the simulated gateway master.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include <functional>
+#include <stdio.h>
+#include "Print.h"
+
+#define SERIAL_8N1  0x800001c
+
+// Far end of a serial line, driven by the virtual clock
+class SerialDevice {
+public:
+  virtual ~SerialDevice() {}
+
+  // Bytes written by the firmware, starting on the wire at nowUs
+  virtual void transmit(const uint8_t *data, size_t length,
+                        uint64_t nowUs) = 0;
+  // Bytes that have fully arrived by nowUs
+  virtual int available(uint64_t nowUs) = 0;
+  virtual int read(uint64_t nowUs) = 0;
+  // Line speed the firmware configured
+  virtual void setBaudRate(uint32_t baudRate) { (void)baudRate; }
+};
+
+class HardwareSerial : public Stream {
+public:
+  explicit HardwareSerial(int port)
+    : _port(port), _baudRate(0), _device(nullptr), _echo(port == 0),
+      _echoFile(stdout) {}
+
+  void begin(unsigned long baudRate, uint32_t config = SERIAL_8N1,
+             int8_t rxPin = -1, int8_t txPin = -1) {
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    updateBaudRate(baudRate);
+  }
+  void end() {}
+  void updateBaudRate(unsigned long baudRate) {
+    _baudRate = baudRate;
+    if (_device != nullptr) {
+      _device->setBaudRate((uint32_t)baudRate);
+    }
+  }
+  unsigned long baudRate() const { return _baudRate; }
+
+  void onReceive(std::function<void()> callback, bool onlyOnTimeout = false) {
+    (void)onlyOnTimeout;
+    _onReceive = callback;
+  }
+  bool setRxTimeout(uint8_t symbols) {
+    (void)symbols;
+    return true;
+  }
+
+  int available() override;
+  int read() override;
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t *data, size_t length) override;
+  void flush() {}
+
+  // Simulation hooks
+  void attach(SerialDevice *device) {
+    _device = device;
+    if (_baudRate != 0) {
+      _device->setBaudRate((uint32_t)_baudRate);
+    }
+  }
+  void setEcho(bool echo) { _echo = echo; }
+  void setEchoFile(FILE *file) { _echoFile = file; }
+
+private:
+  int _port;
+  unsigned long _baudRate;
+  SerialDevice *_device;
+  bool _echo;                    // Copy output to _echoFile when unattached
+  FILE *_echoFile;
+  std::function<void()> _onReceive;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // NATIVE_HARDWARE_SERIAL_H
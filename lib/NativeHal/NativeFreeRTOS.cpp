@@ -0,0 +1,119 @@
+/**
+ * ESP32 Room Climate Monitor - FreeRTOS Stand-ins (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "NativeFreeRTOS.h"
+#include <deque>
+#include <string.h>
+#include <vector>
+#include "VirtualClock.h"
+
+struct NativeQueue {
+  size_t length;
+  size_t itemSize;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+// Distinct non-null handles; the simulation driver runs the tasks itself
+static uint8_t taskHandles[16];
+static size_t taskCount = 0;
+static uint8_t mutexHandle;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name,
+                                   uint32_t stackDepth, void *parameter,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+  (void)task;
+  (void)name;
+  (void)stackDepth;
+  (void)parameter;
+  (void)priority;
+  (void)core;
+  if (handle != nullptr) {
+    *handle = &taskHandles[taskCount++ % sizeof(taskHandles)];
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  (void)task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  VirtualClock::advanceUs((uint64_t)ticks * 1000);
+}
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period) {
+  *previousWake += period;
+  VirtualClock::advanceTo((uint64_t)*previousWake * 1000);
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(VirtualClock::nowUs() / 1000);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  (void)clearOnExit;
+  vTaskDelay(ticks);
+  return 0;
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+  (void)task;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return &mutexHandle;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  (void)semaphore;
+  (void)ticks;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  (void)semaphore;
+  return pdTRUE;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  NativeQueue *queue = new NativeQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+  delete (NativeQueue *)queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t handle, const void *item, TickType_t ticks) {
+  (void)ticks; // Nothing else runs while we would block
+  NativeQueue *queue = (NativeQueue *)handle;
+  if (queue->items.size() >= queue->length) {
+    return pdFALSE;
+  }
+  const uint8_t *bytes = (const uint8_t *)item;
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void *item, TickType_t ticks) {
+  (void)ticks;
+  NativeQueue *queue = (NativeQueue *)handle;
+  if (queue->items.empty()) {
+    return pdFALSE;
+  }
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle) {
+  return (UBaseType_t)((NativeQueue *)handle)->items.size();
+}
@@ -0,0 +1,61 @@
+/**
+ * ESP32 Room Climate Monitor - NVS Preferences (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "Preferences.h"
+#include <map>
+
+// Namespace -> key -> value, shared by every Preferences object
+static std::map<std::string, std::map<std::string, uint8_t>> &storage() {
+  static std::map<std::string, std::map<std::string, uint8_t>> values;
+  return values;
+}
+
+bool Preferences::begin(const char *name, bool readOnly,
+                        const char *partitionLabel) {
+  (void)partitionLabel;
+  _namespace = name;
+  _readOnly = readOnly;
+  _open = true;
+  return true;
+}
+
+bool Preferences::isKey(const char *key) {
+  return _open && storage()[_namespace].count(key) > 0;
+}
+
+bool Preferences::remove(const char *key) {
+  if (!_open || _readOnly) {
+    return false;
+  }
+  return storage()[_namespace].erase(key) > 0;
+}
+
+bool Preferences::clear() {
+  if (!_open || _readOnly) {
+    return false;
+  }
+  storage()[_namespace].clear();
+  return true;
+}
+
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue) {
+  if (!_open) {
+    return defaultValue;
+  }
+  std::map<std::string, uint8_t> &values = storage()[_namespace];
+  auto entry = values.find(key);
+  return entry == values.end() ? defaultValue : entry->second;
+}
+
+size_t Preferences::putUChar(const char *key, uint8_t value) {
+  if (!_open || _readOnly) {
+    return 0;
+  }
+  storage()[_namespace][key] = value;
+  return sizeof(value);
+}
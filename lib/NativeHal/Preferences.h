@@ -0,0 +1,42 @@
+/**
+ * ESP32 Room Climate Monitor - NVS Preferences (native builds)
+ *
+ * RAM-backed stand-in for the Arduino-ESP32 Preferences API. Values
+ * survive end()/begin() within one process, like NVS across a reboot,
+ * and are lost when the simulator exits. Only the accessors the
+ * firmware uses are provided.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class Preferences {
+public:
+  Preferences() : _open(false), _readOnly(false) {}
+
+  bool begin(const char *name, bool readOnly = false,
+             const char *partitionLabel = nullptr);
+  void end() { _open = false; }
+
+  bool isKey(const char *key);
+  bool remove(const char *key);
+  bool clear();
+
+  uint8_t getUChar(const char *key, uint8_t defaultValue = 0);
+  size_t putUChar(const char *key, uint8_t value);
+
+private:
+  std::string _namespace;
+  bool _open;
+  bool _readOnly;
+};
+
+#endif // NATIVE_PREFERENCES_H
@@ -0,0 +1,56 @@
+/**
+ * ESP32 Room Climate Monitor - Arduino Print/Stream (native builds)
+ *
+ * Subset of the Arduino text output classes used by the firmware.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+      write(data[i]);
+    }
+    return length;
+  }
+
+  size_t print(const char *text) {
+    return write((const uint8_t *)text, strlen(text));
+  }
+  size_t print(char value) { return write((uint8_t)value); }
+  size_t print(long value);
+  size_t print(unsigned long value);
+  size_t print(int value) { return print((long)value); }
+  size_t print(unsigned int value) { return print((unsigned long)value); }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T>
+  size_t println(T value) {
+    size_t length = print(value);
+    return length + println();
+  }
+
+  size_t printf(const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+};
+
+#endif // NATIVE_PRINT_H
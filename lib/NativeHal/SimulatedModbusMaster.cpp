@@ -0,0 +1,141 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated Modbus Master (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "SimulatedModbusMaster.h"
+#include "ModbusCRC.h"
+
+#define SIM_BITS_PER_CHAR  11
+
+SimulatedModbusMaster::SimulatedModbusMaster(uint8_t slaveAddress,
+                                             uint16_t registerCount,
+                                             uint32_t pollIntervalUs,
+                                             uint32_t probeEvery)
+  : _slaveAddress(slaveAddress),
+    _registerCount(registerCount),
+    _pollIntervalUs(pollIntervalUs),
+    _probeEvery(probeEvery),
+    _charTimeUs(0),
+    _nextRequestUs(0),
+    _requestEndUs(0),
+    _expect(EXPECT_SILENCE),
+    _function(0),
+    _count(0),
+    _answered(true),
+    _stats() {
+  setBaudRate(9600);
+}
+
+void SimulatedModbusMaster::setBaudRate(uint32_t baudRate) {
+  _charTimeUs = (SIM_BITS_PER_CHAR * 1000000UL + baudRate - 1) / baudRate;
+}
+
+uint64_t SimulatedModbusMaster::poll(uint64_t nowUs) {
+  if (nowUs < _nextRequestUs) {
+    return _nextRequestUs;
+  }
+  if (!_answered) {
+    _stats.missingReplies++;
+  }
+
+  uint32_t n = _stats.requests;
+  uint8_t function = (n & 1) ? 0x04 : 0x03;
+  if (_probeEvery > 0 && n % _probeEvery == _probeEvery - 1) {
+    // Read one register past the end of the map
+    send(_slaveAddress, function, _registerCount, 1, nowUs);
+    _expect = EXPECT_EXCEPTION;
+  } else if (_probeEvery > 0 && n % _probeEvery == _probeEvery / 2) {
+    send((uint8_t)(_slaveAddress + 1), function, 0, _registerCount, nowUs);
+    _expect = EXPECT_SILENCE;
+    _stats.ignored++;
+  } else {
+    send(_slaveAddress, function, 0, _registerCount, nowUs);
+    _expect = EXPECT_REGISTERS;
+  }
+  _answered = _expect == EXPECT_SILENCE;
+  _nextRequestUs = nowUs + _pollIntervalUs;
+  return _nextRequestUs;
+}
+
+void SimulatedModbusMaster::send(uint8_t address, uint8_t function,
+                                 uint16_t start, uint16_t count,
+                                 uint64_t nowUs) {
+  uint8_t frame[8] = {address, function, (uint8_t)(start >> 8),
+                      (uint8_t)start, (uint8_t)(count >> 8), (uint8_t)count};
+  ModbusCRC::append(frame, 6);
+  uint64_t arrivalUs = nowUs;
+  for (uint8_t value : frame) {
+    arrivalUs += _charTimeUs;
+    _tx.push_back({arrivalUs, value});
+  }
+  _requestEndUs = arrivalUs;
+  _function = function;
+  _count = count;
+  _stats.requests++;
+}
+
+void SimulatedModbusMaster::transmit(const uint8_t *data, size_t length,
+                                     uint64_t nowUs) {
+  uint32_t turnaroundUs = (uint32_t)(nowUs - _requestEndUs);
+  _stats.totalTurnaroundUs += turnaroundUs;
+  if (turnaroundUs > _stats.maxTurnaroundUs) {
+    _stats.maxTurnaroundUs = turnaroundUs;
+  }
+
+  if (_expect == EXPECT_SILENCE) {
+    _stats.unexpectedReplies++;
+    return;
+  }
+  _answered = true;
+
+  bool framed = length >= 5 && ModbusCRC::check(data, length) &&
+                data[0] == _slaveAddress;
+  if (_expect == EXPECT_EXCEPTION) {
+    if (framed && length == 5 && data[1] == (uint8_t)(_function | 0x80) &&
+        data[2] == 0x02) {
+      _stats.exceptions++;
+    } else {
+      _stats.badReplies++;
+    }
+    return;
+  }
+
+  if (!framed || data[1] != _function || data[2] != _count * 2 ||
+      length != 5 + (size_t)_count * 2) {
+    _stats.badReplies++;
+    return;
+  }
+  _registers.resize(_count);
+  for (uint16_t i = 0; i < _count; i++) {
+    _registers[i] = (uint16_t)((data[3 + i * 2] << 8) | data[4 + i * 2]);
+  }
+  _stats.replies++;
+}
+
+int SimulatedModbusMaster::available(uint64_t nowUs) {
+  int count = 0;
+  for (const auto &pending : _tx) {
+    if (pending.first > nowUs) {
+      break;
+    }
+    count++;
+  }
+  return count;
+}
+
+int SimulatedModbusMaster::read(uint64_t nowUs) {
+  if (_tx.empty() || _tx.front().first > nowUs) {
+    return -1;
+  }
+  uint8_t value = _tx.front().second;
+  _tx.pop_front();
+  return value;
+}
+
+uint64_t SimulatedModbusMaster::nextArrivalUs() const {
+  return _tx.empty() ? 0 : _tx.front().first;
+}
@@ -0,0 +1,100 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated Modbus Master (native builds)
+ *
+ * Stand-in for the PLC that reads the firmware's gateway registers on
+ * Serial1. Every poll interval it sends one read of the whole register
+ * map, alternating 0x03 and 0x04; every probeEvery-th request instead
+ * reads past the end of the map, or is addressed to another node, to
+ * exercise the exception and ignore paths.
+ *
+ * Request bytes reach the firmware at their wire arrival time (11 bits
+ * per character); replies are checked (CRC, address, function, byte
+ * count or the expected exception) when the firmware writes them, and
+ * the register values of the last good reply are kept for the
+ * simulator to compare with the sensors.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SIMULATED_MODBUS_MASTER_H
+#define SIMULATED_MODBUS_MASTER_H
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+#include "HardwareSerial.h"
+
+// What the master saw of the slave
+struct ModbusMasterStats {
+  uint32_t requests;
+  uint32_t replies;              // Good register replies
+  uint32_t exceptions;           // Expected exception replies
+  uint32_t ignored;              // Requests for other nodes left unanswered
+  uint32_t badReplies;           // Wrong CRC, address, function or length
+  uint32_t missingReplies;       // No reply before the next request
+  uint32_t unexpectedReplies;    // Replies to requests for other nodes
+  uint64_t totalTurnaroundUs;    // End of request to start of reply
+  uint32_t maxTurnaroundUs;
+};
+
+class SimulatedModbusMaster : public SerialDevice {
+public:
+  /**
+   * @param slaveAddress Address of the firmware's gateway
+   * @param registerCount Size of the gateway's register map
+   */
+  SimulatedModbusMaster(uint8_t slaveAddress, uint16_t registerCount,
+                        uint32_t pollIntervalUs, uint32_t probeEvery);
+
+  void setBaudRate(uint32_t baudRate) override;
+  void transmit(const uint8_t *data, size_t length, uint64_t nowUs) override;
+  int available(uint64_t nowUs) override;
+  int read(uint64_t nowUs) override;
+
+  /**
+   * Send the next request if one is due
+   *
+   * @return Time the next request is due
+   */
+  uint64_t poll(uint64_t nowUs);
+
+  /**
+   * @return Arrival time of the next undelivered request byte, or 0
+   */
+  uint64_t nextArrivalUs() const;
+
+  // Arrival time of the last byte of the latest request
+  uint64_t requestEndUs() const { return _requestEndUs; }
+  uint32_t charTimeUs() const { return _charTimeUs; }
+
+  // Registers of the last good reply, and how many such replies arrived
+  const std::vector<uint16_t> &registers() const { return _registers; }
+  uint32_t replyCount() const { return _stats.replies; }
+
+  const ModbusMasterStats &stats() const { return _stats; }
+
+private:
+  enum Expect { EXPECT_REGISTERS, EXPECT_EXCEPTION, EXPECT_SILENCE };
+
+  void send(uint8_t address, uint8_t function, uint16_t start,
+            uint16_t count, uint64_t nowUs);
+
+  uint8_t _slaveAddress;
+  uint16_t _registerCount;
+  uint32_t _pollIntervalUs;
+  uint32_t _probeEvery;
+  uint32_t _charTimeUs;
+  uint64_t _nextRequestUs;
+  uint64_t _requestEndUs;
+  std::deque<std::pair<uint64_t, uint8_t>> _tx;  // Arrival time, byte
+  Expect _expect;
+  uint8_t _function;
+  uint16_t _count;
+  bool _answered;
+  std::vector<uint16_t> _registers;
+  ModbusMasterStats _stats;
+};
+
+#endif // SIMULATED_MODBUS_MASTER_H
@@ -0,0 +1,193 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated MQTT Broker (native builds)
+ *
+ * See SimulatedMqttBroker.h for what is implemented.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "SimulatedMqttBroker.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "Arduino.h"
+
+SimulatedMqttBroker::SimulatedMqttBroker(uint16_t port)
+  : _port(port),
+    _listenFd(-1),
+    _clientFd(-1),
+    _rx(),
+    _messages(),
+    _stats() {
+}
+
+SimulatedMqttBroker::~SimulatedMqttBroker() {
+  setOnline(false);
+}
+
+bool SimulatedMqttBroker::setOnline(bool online) {
+  if (!online) {
+    dropClient();
+    if (_listenFd >= 0) {
+      close(_listenFd);
+      _listenFd = -1;
+    }
+    return true;
+  }
+  if (_listenFd >= 0) {
+    return true;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(_port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+      listen(fd, 1) < 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  _listenFd = fd;
+  return true;
+}
+
+void SimulatedMqttBroker::poll() {
+  if (_listenFd < 0) {
+    return;
+  }
+  // One session at a time: a reconnecting client is accepted once the
+  // old connection has been seen to close
+  if (_clientFd < 0) {
+    _clientFd = accept(_listenFd, nullptr, nullptr);
+    if (_clientFd < 0) {
+      return;
+    }
+    fcntl(_clientFd, F_SETFL, fcntl(_clientFd, F_GETFL, 0) | O_NONBLOCK);
+  }
+
+  uint8_t buffer[2048];
+  for (;;) {
+    ssize_t received = recv(_clientFd, buffer, sizeof(buffer), 0);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    if (received <= 0) {
+      dropClient();
+      return;
+    }
+    _rx.insert(_rx.end(), buffer, buffer + received);
+  }
+
+  // Fixed header: type byte, then a 1-4 byte remaining length
+  while (_rx.size() >= 2) {
+    size_t length = 0;
+    size_t position = 1;
+    uint32_t multiplier = 1;
+    bool complete = false;
+    while (position < _rx.size() && position <= 4) {
+      uint8_t digit = _rx[position++];
+      length += (digit & 0x7F) * multiplier;
+      multiplier *= 128;
+      if (!(digit & 0x80)) {
+        complete = true;
+        break;
+      }
+    }
+    if (!complete) {
+      if (position > 4) {
+        _stats.protocolErrors++;
+        dropClient();
+      }
+      return;
+    }
+    if (_rx.size() < position + length) {
+      return;
+    }
+    if (!handlePacket(_rx[0], _rx.data() + position, length)) {
+      _stats.protocolErrors++;
+      dropClient();
+      return;
+    }
+    if (_clientFd < 0) {
+      return; // DISCONNECT
+    }
+    _rx.erase(_rx.begin(), _rx.begin() + (long)(position + length));
+  }
+}
+
+/**
+ * @return false if the packet is malformed
+ */
+bool SimulatedMqttBroker::handlePacket(uint8_t type, const uint8_t *body,
+                                       size_t length) {
+  switch (type >> 4) {
+    case 1: { // CONNECT: accept any client
+      if (length < 10 || memcmp(body, "\x00\x04MQTT\x04", 7) != 0) {
+        return false;
+      }
+      const uint8_t connack[] = {0x20, 2, 0, 0};
+      reply(connack, sizeof(connack));
+      _stats.connections++;
+      return true;
+    }
+    case 3: { // PUBLISH
+      uint8_t qos = (type >> 1) & 0x03;
+      if (length < 2) {
+        return false;
+      }
+      size_t topicLength = ((size_t)body[0] << 8) | body[1];
+      size_t header = 2 + topicLength + (qos > 0 ? 2 : 0);
+      if (header > length) {
+        return false;
+      }
+      MqttMessage message;
+      message.receivedMs = (uint32_t)millis();
+      message.topic.assign((const char *)body + 2, topicLength);
+      message.payload.assign(body + header, body + length);
+      _messages.push_back(message);
+      _stats.publishes++;
+      if (qos == 1) {
+        const uint8_t puback[] = {0x40, 2, body[2 + topicLength],
+                                  body[3 + topicLength]};
+        reply(puback, sizeof(puback));
+      }
+      return true;
+    }
+    case 12: { // PINGREQ
+      const uint8_t pingresp[] = {0xD0, 0};
+      reply(pingresp, sizeof(pingresp));
+      _stats.pings++;
+      return true;
+    }
+    case 14: // DISCONNECT
+      dropClient();
+      return true;
+    default:
+      return false;
+  }
+}
+
+void SimulatedMqttBroker::reply(const uint8_t *data, size_t length) {
+  if (_clientFd >= 0) {
+    send(_clientFd, data, length, MSG_NOSIGNAL);
+  }
+}
+
+void SimulatedMqttBroker::dropClient() {
+  if (_clientFd >= 0) {
+    close(_clientFd);
+    _clientFd = -1;
+  }
+  _rx.clear();
+}
@@ -0,0 +1,70 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated MQTT Broker (native builds)
+ *
+ * Just enough of an MQTT 3.1.1 broker on a loopback port to check the
+ * firmware's publisher: it accepts one client at a time, answers
+ * CONNECT, QoS 1 PUBLISH and PINGREQ, and keeps every message it
+ * received with the virtual time it arrived. Nothing is forwarded.
+ *
+ * setOnline(false) stands in for a broker outage: the listening socket
+ * and the client connection are closed, so reconnect attempts are
+ * refused until setOnline(true).
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SIMULATED_MQTT_BROKER_H
+#define SIMULATED_MQTT_BROKER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct MqttMessage {
+  uint32_t receivedMs;       // millis() when the PUBLISH arrived
+  std::string topic;
+  std::vector<uint8_t> payload;
+};
+
+struct MqttBrokerStats {
+  uint32_t connections;      // CONNECTs accepted
+  uint32_t publishes;
+  uint32_t pings;
+  uint32_t protocolErrors;   // Malformed packets (connection closed)
+};
+
+class SimulatedMqttBroker {
+public:
+  explicit SimulatedMqttBroker(uint16_t port);
+  ~SimulatedMqttBroker();
+
+  /**
+   * Start or stop listening; going offline drops the client
+   *
+   * @return false if the port could not be bound
+   */
+  bool setOnline(bool online);
+  bool online() const { return _listenFd >= 0; }
+
+  // Accept, read and answer whatever is ready, without blocking
+  void poll();
+
+  const std::vector<MqttMessage> &messages() const { return _messages; }
+  const MqttBrokerStats &stats() const { return _stats; }
+
+private:
+  bool handlePacket(uint8_t type, const uint8_t *body, size_t length);
+  void reply(const uint8_t *data, size_t length);
+  void dropClient();
+
+  uint16_t _port;
+  int _listenFd;
+  int _clientFd;
+  std::vector<uint8_t> _rx;
+  std::vector<MqttMessage> _messages;
+  MqttBrokerStats _stats;
+};
+
+#endif // SIMULATED_MQTT_BROKER_H
@@ -0,0 +1,81 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated SSD1306 Panel (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "SimulatedSSD1306.h"
+
+#define SSD1306_CONTROL_COMMAND  0x00
+#define SSD1306_CONTROL_DATA     0x40
+#define SSD1306_SET_COLUMNS      0x21
+#define SSD1306_SET_PAGES        0x22
+
+SimulatedSSD1306::SimulatedSSD1306(uint8_t address)
+  : _address(address),
+    _ram(),
+    _columnStart(0),
+    _columnEnd(SIM_SSD1306_WIDTH - 1),
+    _pageStart(0),
+    _pageEnd(SIM_SSD1306_PAGES - 1),
+    _column(0),
+    _page(0),
+    _dataBytes(0) {
+}
+
+void SimulatedSSD1306::receive(const uint8_t *data, size_t length) {
+  if (length == 0) {
+    return;
+  }
+
+  if (data[0] == SSD1306_CONTROL_COMMAND) {
+    command(data + 1, length - 1);
+    return;
+  }
+  if (data[0] != SSD1306_CONTROL_DATA) {
+    return;
+  }
+
+  // Horizontal addressing: advance within the window, wrapping columns
+  // into the next page and pages back to the start of the window
+  for (size_t i = 1; i < length; i++) {
+    _ram[_page * SIM_SSD1306_WIDTH + _column] = data[i];
+    _dataBytes++;
+    if (_column < _columnEnd) {
+      _column++;
+      continue;
+    }
+    _column = _columnStart;
+    _page = _page < _pageEnd ? _page + 1 : _pageStart;
+  }
+}
+
+void SimulatedSSD1306::command(const uint8_t *data, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+    uint8_t opcode = data[i++];
+    if (opcode == SSD1306_SET_COLUMNS && i + 2 <= length) {
+      _columnStart = data[i] % SIM_SSD1306_WIDTH;
+      _columnEnd = data[i + 1] % SIM_SSD1306_WIDTH;
+      _column = _columnStart;
+      i += 2;
+    } else if (opcode == SSD1306_SET_PAGES && i + 2 <= length) {
+      _pageStart = data[i] % SIM_SSD1306_PAGES;
+      _pageEnd = data[i + 1] % SIM_SSD1306_PAGES;
+      _page = _pageStart;
+      i += 2;
+    }
+    // Other commands do not affect display RAM
+  }
+}
+
+bool SimulatedSSD1306::matches(const uint8_t *frame) const {
+  for (size_t i = 0; i < sizeof(_ram); i++) {
+    if (_ram[i] != frame[i]) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,48 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated SSD1306 Panel (native builds)
+ *
+ * I2C slave that keeps the panel's display RAM up to date from the
+ * command/data stream: control byte 0x00 carries commands (column and
+ * page address windows are honoured), 0x40 carries RAM data written in
+ * horizontal addressing mode. Comparing ram() with the framebuffer
+ * verifies that incremental flushes leave the panel showing the frame.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SIMULATED_SSD1306_H
+#define SIMULATED_SSD1306_H
+
+#include "Wire.h"
+
+#define SIM_SSD1306_WIDTH  128
+#define SIM_SSD1306_PAGES  8
+
+class SimulatedSSD1306 : public I2CDevice {
+public:
+  explicit SimulatedSSD1306(uint8_t address);
+
+  uint8_t address() const override { return _address; }
+  void receive(const uint8_t *data, size_t length) override;
+
+  const uint8_t *ram() const { return _ram; }
+  uint32_t dataBytes() const { return _dataBytes; }
+
+  /**
+   * @return true if the panel RAM equals a framebuffer in SSD1306 layout
+   */
+  bool matches(const uint8_t *frame) const;
+
+private:
+  void command(const uint8_t *data, size_t length);
+
+  uint8_t _address;
+  uint8_t _ram[SIM_SSD1306_WIDTH * SIM_SSD1306_PAGES];
+  uint8_t _columnStart, _columnEnd, _pageStart, _pageEnd;
+  uint8_t _column, _page;
+  uint32_t _dataBytes;
+};
+
+#endif // SIMULATED_SSD1306_H
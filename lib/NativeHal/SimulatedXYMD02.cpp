@@ -0,0 +1,280 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated XY-MD02 Sensors (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "SimulatedXYMD02.h"
+#include <math.h>
+#include "ModbusCRC.h"
+
+#define XYMD02_REG_TEMPERATURE   0x0001
+#define XYMD02_REG_HUMIDITY      0x0002
+#define XYMD02_REG_ADDRESS       0x0101
+#define XYMD02_REG_BAUD          0x0102
+#define XYMD02_REG_TEMP_CORR     0x0103
+#define XYMD02_REG_HUM_CORR      0x0104
+
+#define MODBUS_EXCEPTION_FUNCTION  0x01
+#define MODBUS_EXCEPTION_ADDRESS   0x02
+#define MODBUS_EXCEPTION_VALUE     0x03
+#define MODBUS_EXCEPTION_FAILURE   0x04
+
+#define SIM_BITS_PER_CHAR   11
+#define SIM_DEFAULT_BAUD    9600
+#define SIM_DAY_US          86400000000.0
+
+SimulatedXYMD02::SimulatedXYMD02(uint8_t address,
+                                 const XYMD02Behavior &behavior,
+                                 uint32_t seed)
+  : _address(address),
+    _baudCode(0), // 9600 baud
+    _temperatureCorrection(0),
+    _humidityCorrection(0),
+    _behavior(behavior),
+    _connected(true),
+    _rng(((uint64_t)seed << 32) ^ 0x9E3779B97F4A7C15ULL ^ address),
+    _stats() {
+}
+
+uint32_t SimulatedXYMD02::baudRate() const {
+  static const uint32_t rates[] = {9600, 14400, 19200};
+  return _baudCode < 3 ? rates[_baudCode] : SIM_DEFAULT_BAUD;
+}
+
+/**
+ * Uniform random number in [0, 1) (xorshift64*)
+ */
+double SimulatedXYMD02::random() {
+  _rng ^= _rng >> 12;
+  _rng ^= _rng << 25;
+  _rng ^= _rng >> 27;
+  return (double)((_rng * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+int16_t SimulatedXYMD02::temperatureDeci(uint64_t nowUs) const {
+  double phase = 2.0 * M_PI * (double)nowUs / SIM_DAY_US;
+  double celsius = _behavior.temperature +
+                   _behavior.dailySwing / 2.0 * sin(phase);
+  return (int16_t)lround(celsius * 10.0) + _temperatureCorrection;
+}
+
+int16_t SimulatedXYMD02::humidityDeci(uint64_t nowUs) const {
+  // Relative humidity falls as the room warms up
+  double phase = 2.0 * M_PI * (double)nowUs / SIM_DAY_US;
+  double percent = _behavior.humidity - _behavior.dailySwing * sin(phase);
+  if (percent < 0.0) {
+    percent = 0.0;
+  } else if (percent > 100.0) {
+    percent = 100.0;
+  }
+  return (int16_t)lround(percent * 10.0) + _humidityCorrection;
+}
+
+bool SimulatedXYMD02::readRegister(uint8_t function, uint16_t reg,
+                                   uint64_t nowUs, uint16_t &value) const {
+  switch (reg) {
+    case XYMD02_REG_TEMPERATURE: value = (uint16_t)temperatureDeci(nowUs); return true;
+    case XYMD02_REG_HUMIDITY:    value = (uint16_t)humidityDeci(nowUs); return true;
+    default: break;
+  }
+  if (function != 0x03) {
+    return false; // Configuration lives in holding registers only
+  }
+  switch (reg) {
+    case XYMD02_REG_ADDRESS:   value = _address; return true;
+    case XYMD02_REG_BAUD:      value = _baudCode; return true;
+    case XYMD02_REG_TEMP_CORR: value = (uint16_t)_temperatureCorrection; return true;
+    case XYMD02_REG_HUM_CORR:  value = (uint16_t)_humidityCorrection; return true;
+    default: return false;
+  }
+}
+
+void SimulatedXYMD02::exception(uint8_t function, uint8_t code,
+                                std::vector<uint8_t> &reply) {
+  reply.assign({_address, (uint8_t)(function | 0x80), code, 0, 0});
+  ModbusCRC::append(reply.data(), 3);
+}
+
+void SimulatedXYMD02::handle(const uint8_t *request, size_t length,
+                             uint64_t nowUs, std::vector<uint8_t> &reply,
+                             uint32_t &delayUs) {
+  reply.clear();
+  uint32_t lineRate = baudRate(); // The reply goes out before a rate change
+  delayUs = _behavior.latencyUs +
+            (uint32_t)(random() * (double)_behavior.jitterUs);
+
+  if (!_connected) {
+    _stats.unpluggedPolls++;
+    return;
+  }
+
+  // Corrupted requests are ignored, as on the real device
+  if (length < 4 || !ModbusCRC::check(request, length)) {
+    return;
+  }
+  _stats.requests++;
+
+  if (random() < _behavior.dropoutRate) {
+    _stats.dropouts++;
+    return;
+  }
+
+  uint8_t function = request[1];
+  bool glitched = false;
+  if (random() < _behavior.exceptionRate) {
+    exception(function, MODBUS_EXCEPTION_FAILURE, reply);
+    _stats.exceptions++;
+    return;
+  }
+
+  if ((function == 0x03 || function == 0x04) && length == 8) {
+    uint16_t start = (uint16_t)((request[2] << 8) | request[3]);
+    uint16_t count = (uint16_t)((request[4] << 8) | request[5]);
+    if (count == 0 || count > 125) {
+      exception(function, MODBUS_EXCEPTION_VALUE, reply);
+      _stats.exceptions++;
+      return;
+    }
+    bool glitch = _behavior.glitchRate > 0 && random() < _behavior.glitchRate;
+    reply.assign({_address, function, (uint8_t)(count * 2)});
+    for (uint16_t i = 0; i < count; i++) {
+      uint16_t reg = (uint16_t)(start + i);
+      uint16_t value;
+      if (!readRegister(function, reg, nowUs, value)) {
+        exception(function, MODBUS_EXCEPTION_ADDRESS, reply);
+        _stats.exceptions++;
+        return;
+      }
+      // A glitch shifts both readings by 50 units (e.g. a bad ADC read)
+      if (glitch && (reg == XYMD02_REG_TEMPERATURE ||
+                     reg == XYMD02_REG_HUMIDITY)) {
+        value = (uint16_t)(value + 500);
+        glitched = true;
+      }
+      reply.push_back((uint8_t)(value >> 8));
+      reply.push_back((uint8_t)value);
+    }
+  } else if (function == 0x06 && length == 8) {
+    uint16_t reg = (uint16_t)((request[2] << 8) | request[3]);
+    uint16_t value = (uint16_t)((request[4] << 8) | request[5]);
+    switch (reg) {
+      case XYMD02_REG_ADDRESS:   _address = (uint8_t)value; break;
+      case XYMD02_REG_BAUD:      _baudCode = value; break;
+      case XYMD02_REG_TEMP_CORR: _temperatureCorrection = (int16_t)value; break;
+      case XYMD02_REG_HUM_CORR:  _humidityCorrection = (int16_t)value; break;
+      default:
+        exception(function, MODBUS_EXCEPTION_ADDRESS, reply);
+        _stats.exceptions++;
+        return;
+    }
+    reply.assign(request, request + 6); // Echo of the request
+  } else {
+    exception(function, MODBUS_EXCEPTION_FUNCTION, reply);
+    _stats.exceptions++;
+    return;
+  }
+
+  reply.resize(reply.size() + 2);
+  ModbusCRC::append(reply.data(), reply.size() - 2);
+
+  if (random() < _behavior.crcErrorRate ||
+      (_behavior.maxBaudRate != 0 && lineRate > _behavior.maxBaudRate)) {
+    // Flip one bit anywhere in the frame, as line noise would
+    size_t bit = (size_t)(random() * (double)(reply.size() * 8));
+    reply[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    _stats.crcErrors++;
+    return;
+  }
+  if (glitched) {
+    _stats.glitches++;
+  }
+  if (_behavior.noiseRate > 0 && random() < _behavior.noiseRate) {
+    addStrayBytes(request, length, reply);
+    _stats.noisyReplies++;
+  }
+  _stats.validReplies++;
+}
+
+/**
+ * Surround a valid reply with bytes that are not part of it, as a real
+ * line produces them: a glitch while the transceiver turns around, an
+ * echo of the request from a transceiver that hears itself, or noise
+ * after the reply
+ */
+void SimulatedXYMD02::addStrayBytes(const uint8_t *request, size_t length,
+                                    std::vector<uint8_t> &reply) {
+  double kind = random();
+  if (kind < 0.4) {
+    size_t count = 1 + (size_t)(random() * 3);
+    for (size_t i = 0; i < count; i++) {
+      reply.insert(reply.begin(), random() < 0.5 ? 0x00 : 0xFF);
+    }
+  } else if (kind < 0.7) {
+    reply.insert(reply.begin(), request, request + length);
+  } else {
+    reply.push_back((uint8_t)(random() * 256));
+  }
+}
+
+// ==================== BUS ====================
+
+SimulatedModbusBus::SimulatedModbusBus(uint32_t baudRate)
+  : _baudRate(0), _charTimeUs(0), _framesSent(0) {
+  setBaudRate(baudRate);
+}
+
+void SimulatedModbusBus::setBaudRate(uint32_t baudRate) {
+  _baudRate = baudRate;
+  _charTimeUs = (SIM_BITS_PER_CHAR * 1000000UL + baudRate - 1) / baudRate;
+}
+
+void SimulatedModbusBus::transmit(const uint8_t *data, size_t length,
+                                  uint64_t nowUs) {
+  _framesSent++;
+  uint64_t requestEndUs = nowUs + (uint64_t)length * _charTimeUs;
+  if (length == 0) {
+    return;
+  }
+
+  std::vector<uint8_t> reply;
+  for (SimulatedXYMD02 *device : _devices) {
+    // A device set to another rate only sees framing errors
+    if (device->address() != data[0] || device->baudRate() != _baudRate) {
+      continue;
+    }
+    uint32_t delayUs;
+    device->handle(data, length, requestEndUs, reply, delayUs);
+    uint64_t arrivalUs = requestEndUs + delayUs;
+    for (uint8_t value : reply) {
+      arrivalUs += _charTimeUs;
+      _rx.push_back({arrivalUs, value});
+    }
+  }
+}
+
+int SimulatedModbusBus::available(uint64_t nowUs) {
+  int count = 0;
+  for (const PendingByte &pending : _rx) {
+    if (pending.arrivalUs > nowUs) {
+      break;
+    }
+    count++;
+  }
+  return count;
+}
+
+int SimulatedModbusBus::read(uint64_t nowUs) {
+  if (_rx.empty() || _rx.front().arrivalUs > nowUs) {
+    return -1;
+  }
+  uint8_t value = _rx.front().value;
+  _rx.pop_front();
+  return value;
+}
+
+uint64_t SimulatedModbusBus::nextArrivalUs() const {
+  return _rx.empty() ? 0 : _rx.front().arrivalUs;
+}
@@ -0,0 +1,145 @@
+/**
+ * ESP32 Room Climate Monitor - Simulated XY-MD02 Sensors (native builds)
+ *
+ * Device model of the XY-MD02 temperature/humidity transmitter on an
+ * RS485 bus, with fault injection for testing the polling code:
+ * - Input registers 0x0001 (temperature) and 0x0002 (humidity) in
+ *   signed 0.1 units, read with function 0x04 or 0x03
+ * - Holding registers 0x0101 (address), 0x0102 (baud code: 0 = 9600,
+ *   1 = 14400, 2 = 19200), 0x0103/0x0104 (temperature/humidity
+ *   correction), function 0x06; a new baud rate applies after the reply
+ * - Only frames sent at the device's own baud rate are understood
+ * - Configurable response latency and uniform jitter
+ * - Random dropouts (no reply), CRC corruption and exception replies
+ * - Glitched readings: CRC-valid replies carrying a wildly wrong
+ *   temperature and humidity
+ * - A line that corrupts every reply above a maximum baud rate (long or
+ *   poorly terminated cables)
+ * - Stray bytes around valid replies: turnaround glitches, request
+ *   echoes and trailing noise
+ * - Unplugging: a disconnected device hears nothing and never replies
+ *
+ * SimulatedModbusBus is the shared line: it receives the firmware's
+ * request frames from Serial2, hands them to the addressed device and
+ * delivers reply bytes at their wire arrival time (11 bits per
+ * character at the bus baud rate) using the virtual clock.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SIMULATED_XY_MD02_H
+#define SIMULATED_XY_MD02_H
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+#include "HardwareSerial.h"
+
+#define SIM_MODBUS_MAX_FRAME  256
+
+// Fault injection and environment parameters for one device
+struct XYMD02Behavior {
+  uint32_t latencyUs;            // End of request to first reply byte
+  uint32_t jitterUs;             // Uniform extra latency 0..jitterUs
+  double dropoutRate;            // Probability of ignoring a request
+  double crcErrorRate;           // Probability of a corrupted reply
+  double exceptionRate;          // Probability of a 0x04 exception reply
+  double glitchRate;             // Probability of a valid reply with bad readings
+  uint32_t maxBaudRate;          // Replies above this rate are corrupted (0 = off)
+  double noiseRate;              // Probability of stray bytes around a valid reply
+  double temperature;            // Mean temperature in °C
+  double humidity;               // Mean relative humidity in %
+  double dailySwing;             // Peak-to-peak daily temperature swing
+};
+
+// What a device did, for comparison with the firmware's own counters
+struct XYMD02Stats {
+  uint32_t requests;
+  uint32_t validReplies;
+  uint32_t dropouts;
+  uint32_t crcErrors;
+  uint32_t exceptions;
+  uint32_t glitches;             // Valid replies with garbled readings
+  uint32_t noisyReplies;         // Valid replies with stray bytes around them
+  uint32_t unpluggedPolls;       // Requests sent while disconnected
+};
+
+class SimulatedXYMD02 {
+public:
+  SimulatedXYMD02(uint8_t address, const XYMD02Behavior &behavior,
+                  uint32_t seed);
+
+  /**
+   * Process a request addressed to this device
+   *
+   * @param reply Receives the reply frame (empty if the device is silent)
+   * @param delayUs Receives the latency before the first reply byte
+   */
+  void handle(const uint8_t *request, size_t length, uint64_t nowUs,
+              std::vector<uint8_t> &reply, uint32_t &delayUs);
+
+  uint8_t address() const { return _address; }
+  uint32_t baudRate() const;
+  const XYMD02Stats &stats() const { return _stats; }
+  XYMD02Behavior &behavior() { return _behavior; }
+
+  // Unplug or reconnect the device; it starts connected
+  void setConnected(bool connected) { _connected = connected; }
+  bool connected() const { return _connected; }
+
+  // Current simulated readings in 0.1 units
+  int16_t temperatureDeci(uint64_t nowUs) const;
+  int16_t humidityDeci(uint64_t nowUs) const;
+
+private:
+  bool readRegister(uint8_t function, uint16_t reg, uint64_t nowUs,
+                    uint16_t &value) const;
+  void exception(uint8_t function, uint8_t code, std::vector<uint8_t> &reply);
+  void addStrayBytes(const uint8_t *request, size_t length,
+                     std::vector<uint8_t> &reply);
+  double random();
+
+  uint8_t _address;
+  uint16_t _baudCode;
+  int16_t _temperatureCorrection;
+  int16_t _humidityCorrection;
+  XYMD02Behavior _behavior;
+  bool _connected;
+  uint64_t _rng;
+  XYMD02Stats _stats;
+};
+
+class SimulatedModbusBus : public SerialDevice {
+public:
+  explicit SimulatedModbusBus(uint32_t baudRate);
+
+  void addDevice(SimulatedXYMD02 *device) { _devices.push_back(device); }
+  void setBaudRate(uint32_t baudRate) override;
+
+  void transmit(const uint8_t *data, size_t length, uint64_t nowUs) override;
+  int available(uint64_t nowUs) override;
+  int read(uint64_t nowUs) override;
+
+  /**
+   * @return Arrival time of the next undelivered byte, or 0 if none
+   */
+  uint64_t nextArrivalUs() const;
+
+  uint32_t framesSent() const { return _framesSent; }
+
+private:
+  struct PendingByte {
+    uint64_t arrivalUs;
+    uint8_t value;
+  };
+
+  std::vector<SimulatedXYMD02 *> _devices;
+  std::deque<PendingByte> _rx;
+  uint32_t _baudRate;
+  uint32_t _charTimeUs;
+  uint32_t _framesSent;
+};
+
+#endif // SIMULATED_XY_MD02_H
@@ -0,0 +1,37 @@
+/**
+ * ESP32 Room Climate Monitor - Virtual Clock (native builds)
+ *
+ * Simulated time behind millis(), micros(), delay() and the FreeRTOS
+ * tick count. Time only moves when the simulation driver or a blocking
+ * call (delay, vTaskDelay) advances it, so hours of operation can be
+ * replayed in milliseconds of host time and runs are reproducible.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdint.h>
+
+class VirtualClock {
+public:
+  static uint64_t nowUs() { return _nowUs; }
+  static void advanceUs(uint64_t us) { _nowUs += us; }
+
+  /**
+   * Jump forward to an absolute time; never moves backwards
+   */
+  static void advanceTo(uint64_t us) {
+    if (us > _nowUs) {
+      _nowUs = us;
+    }
+  }
+
+private:
+  static uint64_t _nowUs;
+};
+
+#endif // VIRTUAL_CLOCK_H
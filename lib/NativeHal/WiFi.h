@@ -0,0 +1,34 @@
+/**
+ * ESP32 Room Climate Monitor - WiFi Stand-in (native builds)
+ *
+ * The host is already on a network: the status server binds to the
+ * host's loopback interface, so joining a network does nothing.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#define WIFI_STA       1
+#define WL_CONNECTED   3
+
+class WiFiClass {
+public:
+  bool mode(int mode) {
+    (void)mode;
+    return true;
+  }
+  int begin(const char *ssid, const char *password) {
+    (void)ssid;
+    (void)password;
+    return WL_CONNECTED;
+  }
+  int status() { return WL_CONNECTED; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
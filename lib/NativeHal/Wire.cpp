@@ -0,0 +1,48 @@
+/**
+ * ESP32 Room Climate Monitor - I2C Master (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "Wire.h"
+
+// 8 data bits + ACK per byte
+#define I2C_BITS_PER_BYTE  9
+
+TwoWire Wire;
+
+size_t TwoWire::write(uint8_t value) {
+  if (_length >= I2C_BUFFER_LENGTH) {
+    _overflow = true;
+    return 0;
+  }
+  _buffer[_length++] = value;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length) {
+  size_t written = 0;
+  while (written < length && write(data[written]) == 1) {
+    written++;
+  }
+  return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  uint32_t bytes = (uint32_t)_length + 1; // Address byte
+  _stats.transactions++;
+  _stats.bytes += bytes;
+  _stats.busTimeUs += (uint64_t)bytes * I2C_BITS_PER_BYTE * 1000000 / _clock;
+  if (_overflow) {
+    _stats.overflows++;
+  }
+
+  if (_device == nullptr || _device->address() != _address) {
+    return 2; // NACK on address
+  }
+  _device->receive(_buffer, _length);
+  return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * ESP32 Room Climate Monitor - I2C Master (native builds)
+ *
+ * Transactions are buffered like the ESP32 core (128 bytes, excess is
+ * dropped and counted) and delivered to the attached I2CDevice on
+ * endTransmission(). Counts bytes and the wire time they would take
+ * at the configured clock.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include "Arduino.h"
+
+#define I2C_BUFFER_LENGTH  128
+
+// Simulated I2C slave
+class I2CDevice {
+public:
+  virtual ~I2CDevice() {}
+  virtual uint8_t address() const = 0;
+  virtual void receive(const uint8_t *data, size_t length) = 0;
+};
+
+struct TwoWireStats {
+  uint32_t transactions;
+  uint32_t bytes;             // Including address bytes
+  uint32_t overflows;         // Transactions longer than the buffer
+  uint64_t busTimeUs;         // Wire time at the configured clock
+};
+
+class TwoWire {
+public:
+  TwoWire() : _device(nullptr), _clock(100000), _address(0), _length(0),
+              _overflow(false), _stats() {}
+
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+    (void)sda;
+    (void)scl;
+    if (frequency != 0) {
+      _clock = frequency;
+    }
+    return true;
+  }
+  void setClock(uint32_t frequency) { _clock = frequency; }
+
+  void beginTransmission(uint8_t address) {
+    _address = address;
+    _length = 0;
+    _overflow = false;
+  }
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *data, size_t length);
+  uint8_t endTransmission(bool sendStop = true);
+
+  // Simulation hooks
+  void attach(I2CDevice *device) { _device = device; }
+  const TwoWireStats &stats() const { return _stats; }
+
+private:
+  I2CDevice *_device;
+  uint32_t _clock;
+  uint8_t _address;
+  uint8_t _buffer[I2C_BUFFER_LENGTH];
+  size_t _length;
+  bool _overflow;
+  TwoWireStats _stats;
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
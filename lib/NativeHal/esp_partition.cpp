@@ -0,0 +1,69 @@
+/**
+ * ESP32 Room Climate Monitor - Flash Partition API (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "esp_partition.h"
+#include <string.h>
+
+// Default esp32dev table: 1.375 MB SPIFFS data partition at 0x290000
+#define NATIVE_SPIFFS_ADDRESS  0x290000
+#define NATIVE_SPIFFS_SIZE     0x160000
+
+static esp_partition_t spiffsPartition = {
+  ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS,
+  NATIVE_SPIFFS_ADDRESS, NATIVE_SPIFFS_SIZE, "spiffs", nullptr
+};
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label) {
+  if (type != spiffsPartition.type ||
+      (subtype != ESP_PARTITION_SUBTYPE_ANY &&
+       subtype != spiffsPartition.subtype) ||
+      (label != nullptr && strcmp(label, spiffsPartition.label) != 0)) {
+    return nullptr;
+  }
+  if (spiffsPartition.storage == nullptr) {
+    // Fresh flash reads as erased
+    spiffsPartition.storage = new uint8_t[NATIVE_SPIFFS_SIZE];
+    memset(spiffsPartition.storage, 0xFF, NATIVE_SPIFFS_SIZE);
+  }
+  return &spiffsPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t offset,
+                             void *destination, size_t size) {
+  if (offset + size > partition->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memcpy(destination, partition->storage + offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t offset,
+                              const void *source, size_t size) {
+  if (offset + size > partition->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  const uint8_t *bytes = (const uint8_t *)source;
+  for (size_t i = 0; i < size; i++) {
+    partition->storage[offset + i] &= bytes[i]; // NOR: bits only clear
+  }
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition,
+                                    size_t offset, size_t size) {
+  if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (offset + size > partition->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memset(partition->storage + offset, 0xFF, size);
+  return ESP_OK;
+}
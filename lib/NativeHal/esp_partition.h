@@ -0,0 +1,55 @@
+/**
+ * ESP32 Room Climate Monitor - Flash Partition API (native builds)
+ *
+ * RAM-backed stand-in for the ESP-IDF partition API with NOR flash
+ * semantics (erase sets 0xFF, writes can only clear bits). Provides the
+ * "spiffs" data partition of the default esp32dev table.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_ESP_PARTITION_H
+#define NATIVE_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK                 0
+#define ESP_ERR_INVALID_ARG    0x102
+#define ESP_ERR_INVALID_SIZE   0x104
+
+#define SPI_FLASH_SEC_SIZE     4096
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+  ESP_PARTITION_SUBTYPE_ANY = 0xFF
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+  uint8_t *storage;              // Native only: backing memory
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t offset,
+                             void *destination, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t offset,
+                              const void *source, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition,
+                                    size_t offset, size_t size);
+
+#endif // NATIVE_ESP_PARTITION_H
@@ -0,0 +1,14 @@
+/**
+ * ESP32 Room Climate Monitor - SPI Flash Constants (native builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef NATIVE_ESP_SPI_FLASH_H
+#define NATIVE_ESP_SPI_FLASH_H
+
+#include "esp_partition.h"
+
+#endif // NATIVE_ESP_SPI_FLASH_H
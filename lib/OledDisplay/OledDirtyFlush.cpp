@@ -0,0 +1,86 @@
+/**
+ * ESP32 Room Climate Monitor - Incremental SSD1306 Flush
+ *
+ * See OledDirtyFlush.h for the diffing strategy.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "OledDirtyFlush.h"
+#include <string.h>
+
+// SSD1306 addressing commands (horizontal addressing mode)
+#define SSD1306_CMD_COLUMN_ADDRESS  0x21
+#define SSD1306_CMD_PAGE_ADDRESS    0x22
+
+OledDirtyFlush::OledDirtyFlush()
+  : _bus(nullptr),
+    _width(0),
+    _pages(0),
+    _valid(false),
+    _lastWindows(0) {
+}
+
+void OledDirtyFlush::begin(OledBus *bus, uint8_t width, uint8_t height) {
+  _bus = bus;
+  _width = width > OLED_MAX_WIDTH ? OLED_MAX_WIDTH : width;
+  _pages = (height + 7) / 8;
+  if (_pages > OLED_MAX_PAGES) {
+    _pages = OLED_MAX_PAGES;
+  }
+  _valid = false;
+}
+
+size_t OledDirtyFlush::flush(const uint8_t *frame) {
+  size_t bytes = 0;
+  _lastWindows = 0;
+
+  for (uint8_t page = 0; page < _pages; page++) {
+    const uint8_t *row = frame + page * _width;
+    uint8_t *shadow = _shadow + page * _width;
+
+    // Find the changed column range within this page
+    int first = 0;
+    int last = _width - 1;
+    if (_valid) {
+      while (first < _width && row[first] == shadow[first]) {
+        first++;
+      }
+      if (first == _width) {
+        continue; // Page unchanged
+      }
+      while (row[last] == shadow[last]) {
+        last--;
+      }
+    }
+
+    bytes += sendWindow(frame, page, first, last);
+    memcpy(shadow + first, row + first, last - first + 1);
+    _lastWindows++;
+  }
+
+  _valid = true;
+  return bytes;
+}
+
+size_t OledDirtyFlush::fullFrameBytes() const {
+  return (size_t)_width * _pages;
+}
+
+/**
+ * Address one page/column window and stream its bytes
+ */
+size_t OledDirtyFlush::sendWindow(const uint8_t *frame, uint8_t page,
+                                  uint8_t firstColumn, uint8_t lastColumn) {
+  const uint8_t commands[6] = {
+    SSD1306_CMD_COLUMN_ADDRESS, firstColumn, lastColumn,
+    SSD1306_CMD_PAGE_ADDRESS, page, page
+  };
+
+  size_t bytes = _bus->sendCommands(commands, sizeof(commands));
+  bytes += _bus->sendData(frame + page * _width + firstColumn,
+                          lastColumn - firstColumn + 1);
+  return bytes;
+}
@@ -0,0 +1,84 @@
+/**
+ * ESP32 Room Climate Monitor - Incremental SSD1306 Flush
+ *
+ * Pushes only the changed parts of a framebuffer to an SSD1306 panel.
+ * The panel memory is organised as pages (8-pixel-high bands) of one
+ * byte per column. A shadow copy of the last frame sent is kept, and
+ * for every page the first and last changed column are found; only
+ * that window is sent using column/page addressing. A frame where just
+ * the uptime digits changed costs a few dozen bytes instead of 1 KB.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef OLED_DIRTY_FLUSH_H
+#define OLED_DIRTY_FLUSH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define OLED_MAX_WIDTH      128
+#define OLED_MAX_PAGES      8     // 64 rows / 8 rows per page
+#define OLED_BUFFER_SIZE    (OLED_MAX_WIDTH * OLED_MAX_PAGES)
+
+/**
+ * Transport for controller commands and display RAM data
+ * Implementations add the I2C control byte (0x00 command, 0x40 data)
+ */
+class OledBus {
+public:
+  virtual ~OledBus() {}
+
+  /**
+   * @return Bytes put on the bus, including control bytes
+   */
+  virtual size_t sendCommands(const uint8_t *commands, size_t length) = 0;
+  virtual size_t sendData(const uint8_t *data, size_t length) = 0;
+};
+
+class OledDirtyFlush {
+public:
+  OledDirtyFlush();
+
+  /**
+   * @param bus Transport to the controller
+   * @param width Panel width in pixels (at most OLED_MAX_WIDTH)
+   * @param height Panel height in pixels (at most 8 * OLED_MAX_PAGES)
+   */
+  void begin(OledBus *bus, uint8_t width, uint8_t height);
+
+  /**
+   * Force the next flush to resend the whole frame
+   * Use after anything else has written to the panel
+   */
+  void invalidate() { _valid = false; }
+
+  /**
+   * Send the changed windows of frame to the panel
+   *
+   * @param frame Framebuffer in SSD1306 page layout (e.g. getBuffer())
+   * @return Bytes put on the bus for this frame
+   */
+  size_t flush(const uint8_t *frame);
+
+  // Number of page windows sent by the last flush
+  uint8_t lastWindowCount() const { return _lastWindows; }
+
+  // Framebuffer bytes a full-frame update sends, for comparison
+  size_t fullFrameBytes() const;
+
+private:
+  size_t sendWindow(const uint8_t *frame, uint8_t page, uint8_t firstColumn,
+                    uint8_t lastColumn);
+
+  OledBus *_bus;
+  uint8_t _width;
+  uint8_t _pages;
+  bool _valid;               // Shadow matches the panel contents
+  uint8_t _lastWindows;
+  uint8_t _shadow[OLED_BUFFER_SIZE];
+};
+
+#endif // OLED_DIRTY_FLUSH_H
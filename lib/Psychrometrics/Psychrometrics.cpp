@@ -0,0 +1,184 @@
+/**
+ * ESP32 Room Climate Monitor - Derived Psychrometric Metrics
+ *
+ * See Psychrometrics.h for the approximations and their error bounds.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "Psychrometrics.h"
+#include <math.h>
+#include <string.h>
+
+#define PSYCHRO_TABLE_SIZE   (PSYCHRO_TABLE_MAX - PSYCHRO_TABLE_MIN + 1)
+
+// Water vapour density: e[hPa] * 100 / (Rv * T[K]) * 1000 g/kg,
+// Rv = 461.5 J/(kg K)
+#define PSYCHRO_VAPOR_DENSITY  216.68f
+#define PSYCHRO_KELVIN         273.15f
+
+// Vapour pressures in hPa at each whole °C of the table range
+struct SaturationTable {
+  float pressure[PSYCHRO_TABLE_SIZE];
+};
+
+/**
+ * exp() usable at compile time: halve the argument until the Taylor
+ * series converges quickly, then square the result back up
+ */
+static constexpr double constexprExp(double x) {
+  int halvings = 0;
+  while (x > 0.5 || x < -0.5) {
+    x /= 2;
+    halvings++;
+  }
+  double sum = 1.0;
+  double term = 1.0;
+  for (int n = 1; n < 20; n++) {
+    term *= x / n;
+    sum += term;
+  }
+  while (halvings-- > 0) {
+    sum *= sum;
+  }
+  return sum;
+}
+
+static constexpr SaturationTable buildSaturationTable() {
+  SaturationTable table = {};
+  for (int i = 0; i < PSYCHRO_TABLE_SIZE; i++) {
+    double t = PSYCHRO_TABLE_MIN + i;
+    table.pressure[i] = (float)(PSYCHRO_MAGNUS_A *
+      constexprExp(PSYCHRO_MAGNUS_B * t / (PSYCHRO_MAGNUS_C + t)));
+  }
+  return table;
+}
+
+static constexpr SaturationTable SATURATION = buildSaturationTable();
+
+/**
+ * Natural logarithm of a positive normal float: the exponent gives
+ * whole multiples of ln 2, and a degree-4 minimax polynomial covers the
+ * mantissa folded into [sqrt(1/2), sqrt(2)) (error below 7.6e-5)
+ */
+static float fastLog(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  int exponent = (int)((bits >> 23) & 0xFF) - 127;
+  bits = (bits & 0x007FFFFFUL) | 0x3F800000UL;
+  float mantissa;
+  memcpy(&mantissa, &bits, sizeof(mantissa));
+  if (mantissa > 1.41421356f) {
+    mantissa *= 0.5f;
+    exponent++;
+  }
+
+  float x = mantissa - 1.0f;
+  float series = 0.15847695f;
+  series = series * x - 0.26219257f;
+  series = series * x + 0.33661766f;
+  series = series * x - 0.49985806f;
+  series = series * x + 0.99998255f;
+  return x * series + (float)exponent * 0.69314718f;
+}
+
+// Round to the nearest deci-unit without pulling in lroundf()
+static int16_t toDeciUnits(float value) {
+  return (int16_t)(value >= 0 ? value * 10.0f + 0.5f : value * 10.0f - 0.5f);
+}
+
+float Psychrometrics::saturationPressure(int16_t temperature) {
+  int32_t offset = (int32_t)temperature - PSYCHRO_TABLE_MIN * 10;
+  if (offset <= 0) {
+    return SATURATION.pressure[0];
+  }
+  if (offset >= (PSYCHRO_TABLE_SIZE - 1) * 10) {
+    return SATURATION.pressure[PSYCHRO_TABLE_SIZE - 1];
+  }
+
+  int32_t index = offset / 10;
+  int32_t tenths = offset % 10;
+  float low = SATURATION.pressure[index];
+  if (tenths == 0) {
+    return low;
+  }
+  return low + (SATURATION.pressure[index + 1] - low) * (float)tenths * 0.1f;
+}
+
+float Psychrometrics::vaporPressure(int16_t temperature, int16_t humidity) {
+  if (humidity < 0) {
+    humidity = 0;
+  } else if (humidity > 1000) {
+    humidity = 1000;
+  }
+  return saturationPressure(temperature) * (float)humidity * 0.001f;
+}
+
+int16_t Psychrometrics::dewPointFromPressure(float pressure) {
+  if (pressure <= 0) {
+    return PSYCHRO_DEW_POINT_MIN * 10;
+  }
+
+  // Inverse Magnus formula: Td = C * g / (B - g), g = ln(e / A)
+  float gamma = fastLog(pressure * (float)(1.0 / PSYCHRO_MAGNUS_A));
+  float dewPoint = (float)PSYCHRO_MAGNUS_C * gamma /
+                   ((float)PSYCHRO_MAGNUS_B - gamma);
+  if (dewPoint < PSYCHRO_DEW_POINT_MIN) {
+    return PSYCHRO_DEW_POINT_MIN * 10;
+  }
+  return toDeciUnits(dewPoint);
+}
+
+int16_t Psychrometrics::absoluteHumidityFromPressure(int16_t temperature,
+                                                     float pressure) {
+  float kelvin = (float)temperature * 0.1f + PSYCHRO_KELVIN;
+  return toDeciUnits(PSYCHRO_VAPOR_DENSITY * pressure / kelvin);
+}
+
+int16_t Psychrometrics::heatIndex(int16_t temperature, int16_t humidity) {
+  float t = (float)temperature * 0.18f + 32.0f;  // °F
+  float rh = (float)humidity * 0.1f;
+
+  // Steadman's simple formula, averaged with the temperature
+  float index = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+  if ((index + t) * 0.5f >= 80.0f) {
+    // Rothfusz regression
+    index = -42.379f + 2.04901523f * t + 10.14333127f * rh -
+            0.22475541f * t * rh - 0.00683783f * t * t -
+            0.05481717f * rh * rh + 0.00122874f * t * t * rh +
+            0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+
+    if (rh < 13.0f && t >= 80.0f && t <= 112.0f) {
+      // Hot, dry air feels cooler than the regression says
+      float distance = t > 95.0f ? t - 95.0f : 95.0f - t;
+      float root = sqrtf((17.0f - distance) / 17.0f);
+      index -= (13.0f - rh) * 0.25f * root;
+    } else if (rh > 85.0f && t >= 80.0f && t <= 87.0f) {
+      index += (rh - 85.0f) * 0.1f * (87.0f - t) * 0.2f;
+    }
+  }
+
+  return toDeciUnits((index - 32.0f) / 1.8f);
+}
+
+int16_t Psychrometrics::dewPoint(int16_t temperature, int16_t humidity) {
+  return dewPointFromPressure(vaporPressure(temperature, humidity));
+}
+
+int16_t Psychrometrics::absoluteHumidity(int16_t temperature,
+                                         int16_t humidity) {
+  return absoluteHumidityFromPressure(temperature,
+                                      vaporPressure(temperature, humidity));
+}
+
+PsychroMetrics Psychrometrics::derive(int16_t temperature, int16_t humidity) {
+  float pressure = vaporPressure(temperature, humidity);
+  PsychroMetrics metrics;
+  metrics.dewPoint = dewPointFromPressure(pressure);
+  metrics.heatIndex = heatIndex(temperature, humidity);
+  metrics.absoluteHumidity = absoluteHumidityFromPressure(temperature,
+                                                          pressure);
+  return metrics;
+}
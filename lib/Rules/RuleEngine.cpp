@@ -0,0 +1,151 @@
+/**
+ * ESP32 Room Climate Monitor - Incremental Comfort/Alarm Rule Engine
+ *
+ * See RuleEngine.h for the rule semantics.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "RuleEngine.h"
+
+RuleEngine::RuleEngine()
+  : _definitions(nullptr),
+    _handler(nullptr),
+    _rules(),
+    _ruleCount(0),
+    _sensorCount(0),
+    _first(),
+    _active(),
+    _metricMasks(),
+    _evaluations(0),
+    _transitions(0) {
+}
+
+size_t RuleEngine::compile(const RuleDefinition *definitions,
+                           size_t definitionCount, const uint8_t *addresses,
+                           size_t sensorCount, RuleEventHandler handler) {
+  _definitions = definitions;
+  _handler = handler;
+  _sensorCount = sensorCount > RULE_ENGINE_MAX_SENSORS ?
+                 RULE_ENGINE_MAX_SENSORS : sensorCount;
+  _ruleCount = 0;
+  _evaluations = 0;
+  _transitions = 0;
+
+  for (size_t sensor = 0; sensor < _sensorCount; sensor++) {
+    _first[sensor] = (uint8_t)_ruleCount;
+    _active[sensor] = 0;
+    for (size_t metric = 0; metric < RULE_METRIC_COUNT; metric++) {
+      _metricMasks[sensor][metric] = 0;
+    }
+
+    size_t sensorRules = 0;
+    for (size_t i = 0; i < definitionCount && i <= UINT8_MAX; i++) {
+      const RuleDefinition &source = definitions[i];
+      if ((source.sensor != RULE_ANY_SENSOR &&
+           source.sensor != addresses[sensor]) ||
+          source.metric >= RULE_METRIC_COUNT) {
+        continue;
+      }
+      if (_ruleCount >= RULE_ENGINE_MAX_RULES ||
+          sensorRules >= RULE_SENSOR_RULES_MAX) {
+        break;
+      }
+
+      // Clear on the far side of the band so the two levels never meet
+      int16_t band = source.hysteresis < 0 ? 0 : source.hysteresis;
+      bool below = source.direction == RULE_BELOW;
+      int32_t clearLevel = below ? (int32_t)source.threshold + band :
+                                   (int32_t)source.threshold - band;
+      if (clearLevel > INT16_MAX) {
+        clearLevel = INT16_MAX;
+      } else if (clearLevel < INT16_MIN) {
+        clearLevel = INT16_MIN;
+      }
+
+      CompiledRule &rule = _rules[_ruleCount++];
+      rule.setLevel = source.threshold;
+      rule.clearLevel = (int16_t)clearLevel;
+      rule.minDurationMs = source.minDurationMs;
+      rule.pendingSinceMs = 0;
+      rule.metric = source.metric;
+      rule.definition = (uint8_t)i;
+      rule.below = below;
+      rule.pending = false;
+      _metricMasks[sensor][source.metric] |= 1UL << sensorRules;
+      sensorRules++;
+    }
+  }
+  _first[_sensorCount] = (uint8_t)_ruleCount;
+  return _ruleCount;
+}
+
+uint32_t RuleEngine::update(size_t sensor, const int16_t *values,
+                            uint32_t nowMs) {
+  if (sensor >= _sensorCount) {
+    return 0;
+  }
+
+  uint32_t active = _active[sensor];
+  for (size_t i = _first[sensor]; i < _first[sensor + 1]; i++) {
+    CompiledRule &rule = _rules[i];
+    uint32_t bit = 1UL << (i - _first[sensor]);
+    bool isActive = (active & bit) != 0;
+    int16_t value = values[rule.metric];
+
+    // Condition for leaving the current state
+    bool change;
+    if (isActive) {
+      change = rule.below ? value >= rule.clearLevel : value <= rule.clearLevel;
+    } else {
+      change = rule.below ? value < rule.setLevel : value > rule.setLevel;
+    }
+
+    if (!change) {
+      rule.pending = false;
+      continue;
+    }
+    if (!rule.pending) {
+      rule.pending = true;
+      rule.pendingSinceMs = nowMs;
+    }
+    if (nowMs - rule.pendingSinceMs < rule.minDurationMs) {
+      continue;
+    }
+
+    rule.pending = false;
+    active ^= bit;
+    _transitions++;
+    if (_handler != nullptr) {
+      RuleEvent event = {(uint8_t)sensor, rule.definition, !isActive, value,
+                         nowMs};
+      _handler(event);
+    }
+  }
+  _evaluations++;
+  _active[sensor] = active;
+  return active;
+}
+
+void RuleEngine::reset(size_t sensor) {
+  if (sensor >= _sensorCount) {
+    return;
+  }
+  _active[sensor] = 0;
+  for (size_t i = _first[sensor]; i < _first[sensor + 1]; i++) {
+    _rules[i].pending = false;
+  }
+}
+
+const RuleDefinition *RuleEngine::definition(size_t sensor, uint8_t bit) const {
+  if (sensor >= _sensorCount) {
+    return nullptr;
+  }
+  size_t index = (size_t)_first[sensor] + bit;
+  if (index >= _first[sensor + 1]) {
+    return nullptr;
+  }
+  return &_definitions[_rules[index].definition];
+}
@@ -0,0 +1,148 @@
+/**
+ * ESP32 Room Climate Monitor - Incremental Comfort/Alarm Rule Engine
+ *
+ * Rules are declared as a table of RuleDefinition entries (metric,
+ * direction, threshold, hysteresis band, minimum duration, sensor) and
+ * compiled once into a flat per-sensor table with the set and clear
+ * levels precomputed. Each new sample of a sensor then walks only that
+ * sensor's rules:
+ *
+ *   inactive --(beyond threshold for minDurationMs)--> active
+ *   active   --(back inside threshold - hysteresis for minDurationMs)--> inactive
+ *
+ * so a value hovering on a boundary does not make the state flap. Each
+ * transition is reported once to an event handler; between samples the
+ * active rules are a bitmask the caller can publish and render without
+ * re-evaluating anything.
+ *
+ * Rules are kept in declaration order, which doubles as their priority
+ * (bit 0 of a sensor's mask is its first applicable rule).
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef RULE_ENGINE_H
+#define RULE_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RULE_ENGINE_MAX_RULES    64   // Compiled rules across all sensors
+#define RULE_ENGINE_MAX_SENSORS  16
+#define RULE_SENSOR_RULES_MAX    32   // Rules per sensor (bits in a mask)
+#define RULE_ANY_SENSOR          0    // RuleDefinition::sensor: every sensor
+
+// Quantities a rule can watch; indexes the values passed to update()
+enum RuleMetric : uint8_t {
+  RULE_TEMPERATURE,          // 0.1 °C
+  RULE_HUMIDITY,             // 0.1 %RH
+  RULE_DEW_POINT,            // 0.1 °C
+  RULE_HEAT_INDEX,           // 0.1 °C
+  RULE_ABSOLUTE_HUMIDITY,    // 0.1 g/m³
+  RULE_METRIC_COUNT
+};
+
+enum RuleDirection : uint8_t {
+  RULE_ABOVE,                // Active while the value exceeds the threshold
+  RULE_BELOW                 // Active while the value is under the threshold
+};
+
+// One rule as written by the user
+struct RuleDefinition {
+  uint8_t sensor;            // Modbus address, or RULE_ANY_SENSOR
+  RuleMetric metric;
+  RuleDirection direction;
+  int16_t threshold;         // Fixed-point, same units as the metric
+  int16_t hysteresis;        // Distance back inside needed to clear
+  uint32_t minDurationMs;    // Time a condition must hold to change state
+  const char *label;         // Text shown while the rule is active
+};
+
+// State change of one rule for one sensor
+struct RuleEvent {
+  uint8_t sensor;            // Sensor index
+  uint8_t rule;              // Index into the definition table
+  bool active;
+  int16_t value;             // Value that completed the transition
+  uint32_t timestampMs;
+};
+
+typedef void (*RuleEventHandler)(const RuleEvent &event);
+
+class RuleEngine {
+public:
+  RuleEngine();
+
+  /**
+   * Expand the definitions for each sensor and precompute their levels
+   *
+   * @param definitions Rule table; must outlive the engine
+   * @param addresses Modbus address of each sensor
+   * @param sensorCount Number of sensors (at most RULE_ENGINE_MAX_SENSORS)
+   * @param handler Called for every state change (may be nullptr)
+   * @return Number of compiled rules; rules beyond the table or
+   *         per-sensor limits are dropped
+   */
+  size_t compile(const RuleDefinition *definitions, size_t definitionCount,
+                 const uint8_t *addresses, size_t sensorCount,
+                 RuleEventHandler handler);
+
+  /**
+   * Evaluate a sensor's rules against a new sample
+   *
+   * @param values One value per RuleMetric
+   * @return Mask of the sensor's active rules
+   */
+  uint32_t update(size_t sensor, const int16_t *values, uint32_t nowMs);
+
+  /**
+   * Forget a sensor's states without events (e.g. readings lost)
+   */
+  void reset(size_t sensor);
+
+  uint32_t activeMask(size_t sensor) const { return _active[sensor]; }
+
+  /**
+   * @return Mask of a sensor's rules that watch the given metric
+   */
+  uint32_t metricMask(size_t sensor, RuleMetric metric) const {
+    return _metricMasks[sensor][metric];
+  }
+
+  /**
+   * @return Definition behind bit `bit` of a sensor's mask, or nullptr
+   */
+  const RuleDefinition *definition(size_t sensor, uint8_t bit) const;
+
+  size_t ruleCount() const { return _ruleCount; }
+  uint32_t evaluations() const { return _evaluations; }
+  uint32_t transitions() const { return _transitions; }
+
+private:
+  // Precomputed form of a definition for one sensor
+  struct CompiledRule {
+    int16_t setLevel;        // Crossing this activates the rule
+    int16_t clearLevel;      // Crossing back past this clears it
+    uint32_t minDurationMs;
+    uint32_t pendingSinceMs; // When the opposite condition started to hold
+    RuleMetric metric;
+    uint8_t definition;      // Index into _definitions
+    bool below;
+    bool pending;
+  };
+
+  const RuleDefinition *_definitions;
+  RuleEventHandler _handler;
+  CompiledRule _rules[RULE_ENGINE_MAX_RULES];
+  size_t _ruleCount;
+  size_t _sensorCount;
+  uint8_t _first[RULE_ENGINE_MAX_SENSORS + 1];   // Rule range per sensor
+  uint32_t _active[RULE_ENGINE_MAX_SENSORS];
+  uint32_t _metricMasks[RULE_ENGINE_MAX_SENSORS][RULE_METRIC_COUNT];
+  uint32_t _evaluations;
+  uint32_t _transitions;
+};
+
+#endif // RULE_ENGINE_H
@@ -0,0 +1,34 @@
+/**
+ * ESP32 Room Climate Monitor - Flash Block Device Interface
+ *
+ * NOR-flash style storage as seen by the sample log: fixed-size erase
+ * blocks, erase sets every byte to 0xFF and programming can only clear
+ * bits. Implemented by the ESP32 flash partition and by a file-backed
+ * device for running the log on Linux.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef BLOCK_DEVICE_H
+#define BLOCK_DEVICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class BlockDevice {
+public:
+  virtual ~BlockDevice() {}
+
+  virtual uint32_t blockSize() const = 0;
+  virtual uint32_t blockCount() const = 0;
+
+  virtual bool read(uint32_t block, uint32_t offset, void *data,
+                    size_t length) = 0;
+  virtual bool program(uint32_t block, uint32_t offset, const void *data,
+                       size_t length) = 0;
+  virtual bool erase(uint32_t block) = 0;
+};
+
+#endif // BLOCK_DEVICE_H
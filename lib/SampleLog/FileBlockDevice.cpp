@@ -0,0 +1,117 @@
+/**
+ * ESP32 Room Climate Monitor - File-backed Block Device (host builds)
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef ARDUINO
+
+#include "FileBlockDevice.h"
+#include <string.h>
+
+FileBlockDevice::FileBlockDevice()
+  : _file(nullptr),
+    _blockSize(0),
+    _blockCount(0),
+    _eraseCount(0),
+    _programmedBytes(0) {
+}
+
+FileBlockDevice::~FileBlockDevice() {
+  close();
+}
+
+bool FileBlockDevice::open(const char *path, uint32_t blockSize,
+                           uint32_t blockCount) {
+  close();
+  _blockSize = blockSize;
+  _blockCount = blockCount;
+
+  _file = fopen(path, "r+b");
+  if (_file != nullptr) {
+    return true;
+  }
+
+  // New image: start fully erased
+  _file = fopen(path, "w+b");
+  if (_file == nullptr) {
+    return false;
+  }
+  for (uint32_t block = 0; block < blockCount; block++) {
+    erase(block);
+  }
+  _eraseCount = 0;
+  return true;
+}
+
+void FileBlockDevice::close() {
+  if (_file != nullptr) {
+    fclose(_file);
+    _file = nullptr;
+  }
+}
+
+bool FileBlockDevice::inRange(uint32_t block, uint32_t offset,
+                              size_t length) const {
+  return _file != nullptr && block < _blockCount &&
+         offset + length <= _blockSize;
+}
+
+bool FileBlockDevice::read(uint32_t block, uint32_t offset, void *data,
+                           size_t length) {
+  if (!inRange(block, offset, length)) {
+    return false;
+  }
+  fseek(_file, (long)block * _blockSize + offset, SEEK_SET);
+  return fread(data, 1, length, _file) == length;
+}
+
+bool FileBlockDevice::program(uint32_t block, uint32_t offset,
+                              const void *data, size_t length) {
+  if (!inRange(block, offset, length)) {
+    return false;
+  }
+
+  // NOR semantics: programming can only clear bits
+  uint8_t current[256];
+  const uint8_t *source = (const uint8_t *)data;
+  size_t done = 0;
+  while (done < length) {
+    size_t chunk = length - done > sizeof(current) ? sizeof(current) : length - done;
+    if (!read(block, offset + done, current, chunk)) {
+      return false;
+    }
+    for (size_t i = 0; i < chunk; i++) {
+      current[i] &= source[done + i];
+    }
+    fseek(_file, (long)block * _blockSize + offset + done, SEEK_SET);
+    if (fwrite(current, 1, chunk, _file) != chunk) {
+      return false;
+    }
+    done += chunk;
+  }
+
+  _programmedBytes += length;
+  return true;
+}
+
+bool FileBlockDevice::erase(uint32_t block) {
+  if (!inRange(block, 0, _blockSize)) {
+    return false;
+  }
+  uint8_t blank[256];
+  memset(blank, 0xFF, sizeof(blank));
+  fseek(_file, (long)block * _blockSize, SEEK_SET);
+  for (uint32_t done = 0; done < _blockSize; done += sizeof(blank)) {
+    size_t chunk = _blockSize - done > sizeof(blank) ? sizeof(blank) : _blockSize - done;
+    if (fwrite(blank, 1, chunk, _file) != chunk) {
+      return false;
+    }
+  }
+  _eraseCount++;
+  return true;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,62 @@
+/**
+ * ESP32 Room Climate Monitor - File-backed Block Device (host builds)
+ *
+ * Emulates NOR flash in a regular file so the sample log can be
+ * exercised on Linux: erase fills a block with 0xFF and program ANDs
+ * new data into the existing contents, like real flash. Counts erases
+ * and programmed bytes for wear measurements.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef FILE_BLOCK_DEVICE_H
+#define FILE_BLOCK_DEVICE_H
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include "BlockDevice.h"
+
+class FileBlockDevice : public BlockDevice {
+public:
+  FileBlockDevice();
+  ~FileBlockDevice() override;
+
+  /**
+   * Open (or create and erase) an image file
+   *
+   * @param path Image file path
+   * @param blockSize Erase block size in bytes
+   * @param blockCount Number of blocks
+   * @return false if the file cannot be opened
+   */
+  bool open(const char *path, uint32_t blockSize, uint32_t blockCount);
+  void close();
+
+  uint32_t blockSize() const override { return _blockSize; }
+  uint32_t blockCount() const override { return _blockCount; }
+
+  bool read(uint32_t block, uint32_t offset, void *data,
+            size_t length) override;
+  bool program(uint32_t block, uint32_t offset, const void *data,
+               size_t length) override;
+  bool erase(uint32_t block) override;
+
+  uint32_t eraseCount() const { return _eraseCount; }
+  uint64_t programmedBytes() const { return _programmedBytes; }
+
+private:
+  bool inRange(uint32_t block, uint32_t offset, size_t length) const;
+
+  FILE *_file;
+  uint32_t _blockSize;
+  uint32_t _blockCount;
+  uint32_t _eraseCount;
+  uint64_t _programmedBytes;
+};
+
+#endif // ARDUINO
+
+#endif // FILE_BLOCK_DEVICE_H
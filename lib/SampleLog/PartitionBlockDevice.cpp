@@ -0,0 +1,45 @@
+/**
+ * ESP32 Room Climate Monitor - Flash Partition Block Device
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#if __has_include(<esp_partition.h>)
+
+#include "PartitionBlockDevice.h"
+#include <esp_spi_flash.h>
+
+bool PartitionBlockDevice::begin(const char *label) {
+  _partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                        ESP_PARTITION_SUBTYPE_ANY, label);
+  return _partition != nullptr;
+}
+
+uint32_t PartitionBlockDevice::blockSize() const {
+  return SPI_FLASH_SEC_SIZE;
+}
+
+uint32_t PartitionBlockDevice::blockCount() const {
+  return _partition ? _partition->size / SPI_FLASH_SEC_SIZE : 0;
+}
+
+bool PartitionBlockDevice::read(uint32_t block, uint32_t offset, void *data,
+                                size_t length) {
+  return esp_partition_read(_partition, block * SPI_FLASH_SEC_SIZE + offset,
+                            data, length) == ESP_OK;
+}
+
+bool PartitionBlockDevice::program(uint32_t block, uint32_t offset,
+                                   const void *data, size_t length) {
+  return esp_partition_write(_partition, block * SPI_FLASH_SEC_SIZE + offset,
+                             data, length) == ESP_OK;
+}
+
+bool PartitionBlockDevice::erase(uint32_t block) {
+  return esp_partition_erase_range(_partition, block * SPI_FLASH_SEC_SIZE,
+                                   SPI_FLASH_SEC_SIZE) == ESP_OK;
+}
+
+#endif // __has_include(<esp_partition.h>)
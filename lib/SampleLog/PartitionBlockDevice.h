@@ -0,0 +1,49 @@
+/**
+ * ESP32 Room Climate Monitor - Flash Partition Block Device
+ *
+ * Exposes a raw data partition (by default the "spiffs" partition of
+ * the standard esp32dev table, which this firmware does not otherwise
+ * use) as erase blocks of SPI_FLASH_SEC_SIZE bytes.
+ * Available wherever the ESP-IDF partition API is: on the ESP32 and in
+ * the native simulator, which provides a RAM-backed stand-in.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef PARTITION_BLOCK_DEVICE_H
+#define PARTITION_BLOCK_DEVICE_H
+
+#if __has_include(<esp_partition.h>)
+
+#include <esp_partition.h>
+#include "BlockDevice.h"
+
+class PartitionBlockDevice : public BlockDevice {
+public:
+  PartitionBlockDevice() : _partition(nullptr) {}
+
+  /**
+   * Locate the data partition by label
+   *
+   * @return false if no data partition with that label exists
+   */
+  bool begin(const char *label);
+
+  uint32_t blockSize() const override;
+  uint32_t blockCount() const override;
+
+  bool read(uint32_t block, uint32_t offset, void *data,
+            size_t length) override;
+  bool program(uint32_t block, uint32_t offset, const void *data,
+               size_t length) override;
+  bool erase(uint32_t block) override;
+
+private:
+  const esp_partition_t *_partition;
+};
+
+#endif // __has_include(<esp_partition.h>)
+
+#endif // PARTITION_BLOCK_DEVICE_H
@@ -0,0 +1,572 @@
+/**
+ * ESP32 Room Climate Monitor - Append-only Flash Sample Log
+ *
+ * See SampleLog.h for the on-flash layout and compaction policy.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "SampleLog.h"
+#include <string.h>
+#include "ModbusCRC.h"
+
+#define SEGMENT_MAGIC   0x474F4C53UL  // "SLOG"
+#define BATCH_MARKER    0xA5
+#define ERASED_BYTE     0xFF
+
+// Bucket length for each downsampling level
+static const uint32_t LEVEL_BUCKET_SECONDS[SAMPLE_LOG_LEVELS] = {0, 600, 3600};
+
+struct SegmentHeader {
+  uint32_t magic;
+  uint32_t sequence;
+  uint8_t level;
+  uint8_t reserved;
+  uint16_t crc;           // CRC-16 of the preceding 10 bytes
+};
+
+struct BatchHeader {
+  uint8_t marker;
+  uint8_t count;
+  uint16_t crc;           // CRC-16 of the records that follow
+};
+
+static_assert(sizeof(SampleLogRecord) == 12, "Record layout changed");
+static_assert(sizeof(SegmentHeader) == 12, "Segment header layout changed");
+static_assert(sizeof(BatchHeader) == 4, "Batch header layout changed");
+static_assert(SAMPLE_LOG_MAX_SEGMENTS <= 256, "Query order uses 8-bit indices");
+
+#define MAX_BATCH_BYTES  (sizeof(BatchHeader) + \
+                          SAMPLE_LOG_BATCH_RECORDS * sizeof(SampleLogRecord))
+
+SampleLog::SampleLog()
+  : _device(nullptr),
+    _segmentCount(0),
+    _nextSequence(1),
+    _nextTime(0),
+    _pendingCount(0),
+    _compactedCount(0),
+    _bucketCount(0),
+    _compacting(false),
+    _compactionFailed(false) {
+  for (uint8_t level = 0; level < SAMPLE_LOG_LEVELS; level++) {
+    _active[level] = -1;
+  }
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+// ==================== MOUNT ====================
+
+bool SampleLog::mount(BlockDevice *device) {
+  _device = device;
+  _segmentCount = device->blockCount();
+  if (_segmentCount > SAMPLE_LOG_MAX_SEGMENTS) {
+    _segmentCount = SAMPLE_LOG_MAX_SEGMENTS;
+  }
+  if (_segmentCount < SAMPLE_LOG_MIN_FREE + 2 ||
+      device->blockSize() < sizeof(SegmentHeader) + MAX_BATCH_BYTES) {
+    return false;
+  }
+
+  _nextSequence = 1;
+  _nextTime = 0;
+  _pendingCount = 0;
+  for (uint8_t level = 0; level < SAMPLE_LOG_LEVELS; level++) {
+    _active[level] = -1;
+  }
+
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    scanSegment(index);
+    const SegmentInfo &segment = _segments[index];
+    if (segment.state != SEGMENT_DATA) {
+      continue;
+    }
+
+    if (segment.sequence >= _nextSequence) {
+      _nextSequence = segment.sequence + 1;
+    }
+    if (segment.records > 0 && segment.lastTime >= _nextTime) {
+      _nextTime = segment.lastTime + 1;
+    }
+
+    // Newest unsealed segment of each level keeps receiving appends
+    int &active = _active[segment.level];
+    if (segment.writeOffset < _device->blockSize() &&
+        (active < 0 || segment.sequence > _segments[active].sequence)) {
+      active = (int)index;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Read a segment header and walk its batches to rebuild the index entry
+ */
+void SampleLog::scanSegment(uint32_t index) {
+  SegmentInfo &segment = _segments[index];
+  memset(&segment, 0, sizeof(segment));
+  segment.state = SEGMENT_DIRTY;
+
+  SegmentHeader header;
+  if (!_device->read(index, 0, &header, sizeof(header)) ||
+      header.magic != SEGMENT_MAGIC ||
+      header.crc != ModbusCRC::compute((const uint8_t *)&header, 10) ||
+      header.level >= SAMPLE_LOG_LEVELS) {
+    return;
+  }
+
+  segment.state = SEGMENT_DATA;
+  segment.sequence = header.sequence;
+  segment.level = header.level;
+
+  uint32_t offset = sizeof(SegmentHeader);
+  SampleLogRecord records[SAMPLE_LOG_BATCH_RECORDS];
+  uint8_t count;
+  while (readBatch(index, offset, records, count)) {
+    for (uint8_t i = 0; i < count; i++) {
+      if (segment.records == 0 || records[i].time < segment.firstTime) {
+        segment.firstTime = records[i].time;
+      }
+      if (segment.records == 0 || records[i].time > segment.lastTime) {
+        segment.lastTime = records[i].time;
+      }
+      segment.records++;
+    }
+  }
+  segment.writeOffset = offset;
+
+  // Anything other than erased flash after the last good batch is a torn
+  // write; programming over it is unsafe, so seal the segment
+  uint8_t marker = ERASED_BYTE;
+  if (offset + sizeof(BatchHeader) <= _device->blockSize()) {
+    _device->read(index, offset, &marker, 1);
+  }
+  if (marker != ERASED_BYTE) {
+    segment.writeOffset = _device->blockSize();
+  }
+}
+
+/**
+ * Read and verify the batch at offset
+ * On success offset advances past the batch
+ */
+bool SampleLog::readBatch(uint32_t index, uint32_t &offset,
+                          SampleLogRecord *records, uint8_t &count) {
+  BatchHeader header;
+  if (offset + sizeof(header) > _device->blockSize() ||
+      !_device->read(index, offset, &header, sizeof(header)) ||
+      header.marker != BATCH_MARKER || header.count == 0 ||
+      header.count > SAMPLE_LOG_BATCH_RECORDS) {
+    return false;
+  }
+
+  size_t bytes = header.count * sizeof(SampleLogRecord);
+  if (offset + sizeof(header) + bytes > _device->blockSize() ||
+      !_device->read(index, offset + sizeof(header), records, bytes) ||
+      ModbusCRC::compute((const uint8_t *)records, bytes) != header.crc) {
+    return false;
+  }
+
+  count = header.count;
+  offset += sizeof(header) + bytes;
+  return true;
+}
+
+// ==================== APPEND ====================
+
+bool SampleLog::append(uint32_t time, uint8_t sensor, int16_t temperature,
+                       int16_t humidity) {
+  SampleLogRecord &record = _pending[_pendingCount++];
+  record.time = time;
+  record.sensor = sensor;
+  record.level = 0;
+  record.temperature = temperature;
+  record.humidity = humidity;
+  record.count = 1;
+
+  if (time >= _nextTime) {
+    _nextTime = time + 1;
+  }
+
+  if (_pendingCount == SAMPLE_LOG_BATCH_RECORDS) {
+    return flush();
+  }
+  return true;
+}
+
+bool SampleLog::flush() {
+  if (_pendingCount == 0) {
+    return true;
+  }
+  bool written = writeBatch(0, _pending, _pendingCount);
+  _pendingCount = 0; // A failed batch is dropped rather than retried forever
+  return written;
+}
+
+/**
+ * Program one batch into the active segment of a level,
+ * opening a new segment when the current one is full
+ */
+bool SampleLog::writeBatch(uint8_t level, const SampleLogRecord *records,
+                           uint8_t count) {
+  size_t bytes = count * sizeof(SampleLogRecord);
+  int index = _active[level];
+  if (index < 0 ||
+      _segments[index].writeOffset + sizeof(BatchHeader) + bytes >
+        _device->blockSize()) {
+    index = openSegment(level);
+    if (index < 0) {
+      _stats.writeErrors++;
+      return false;
+    }
+  }
+
+  // A torn write leaves a marker whose CRC does not match, which mount()
+  // treats as the end of the segment and seals it
+  SegmentInfo &segment = _segments[index];
+  BatchHeader header = {
+    BATCH_MARKER, count, ModbusCRC::compute((const uint8_t *)records, bytes)
+  };
+  if (!_device->program(index, segment.writeOffset, &header, sizeof(header)) ||
+      !_device->program(index, segment.writeOffset + sizeof(header), records,
+                        bytes)) {
+    segment.writeOffset = _device->blockSize(); // Seal on error
+    _stats.writeErrors++;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (segment.records == 0 || records[i].time < segment.firstTime) {
+      segment.firstTime = records[i].time;
+    }
+    if (segment.records == 0 || records[i].time > segment.lastTime) {
+      segment.lastTime = records[i].time;
+    }
+    segment.records++;
+  }
+  segment.writeOffset += sizeof(header) + bytes;
+  _stats.batchesWritten++;
+  return true;
+}
+
+/**
+ * Start a new segment for a level and make it the level's append target
+ */
+int SampleLog::openSegment(uint8_t level) {
+  int index = allocateSegment();
+  if (index < 0) {
+    return -1;
+  }
+
+  SegmentHeader header;
+  header.magic = SEGMENT_MAGIC;
+  header.sequence = _nextSequence++;
+  header.level = level;
+  header.reserved = ERASED_BYTE;
+  header.crc = ModbusCRC::compute((const uint8_t *)&header, 10);
+  if (!_device->program(index, 0, &header, sizeof(header))) {
+    _segments[index].state = SEGMENT_DIRTY;
+    return -1;
+  }
+
+  SegmentInfo &segment = _segments[index];
+  memset(&segment, 0, sizeof(segment));
+  segment.state = SEGMENT_DATA;
+  segment.sequence = header.sequence;
+  segment.level = level;
+  segment.writeOffset = sizeof(SegmentHeader);
+
+  // The previous target is left as is; it simply stops receiving appends
+  _active[level] = index;
+  return index;
+}
+
+/**
+ * Find a blank segment, preferring ones maintain() already erased
+ * Falls back to dropping the oldest data if the log is completely full
+ */
+int SampleLog::allocateSegment() {
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    if (_segments[index].state == SEGMENT_ERASED) {
+      return (int)index;
+    }
+  }
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    if (_segments[index].state == SEGMENT_DIRTY) {
+      return eraseSegment(index) ? (int)index : -1;
+    }
+  }
+
+  // Compaction output must come from the reserve, never recurse
+  if (_compacting) {
+    return -1;
+  }
+
+  // No space at all: compact the oldest segment now, or drop it if even
+  // its summary does not fit
+  if (!compactOldest() && !dropOldest()) {
+    return -1;
+  }
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    if (_segments[index].state == SEGMENT_ERASED) {
+      return (int)index;
+    }
+  }
+  return -1;
+}
+
+bool SampleLog::eraseSegment(uint32_t index) {
+  for (uint8_t level = 0; level < SAMPLE_LOG_LEVELS; level++) {
+    if (_active[level] == (int)index) {
+      _active[level] = -1;
+    }
+  }
+
+  _stats.erases++;
+  if (!_device->erase(index)) {
+    _segments[index].state = SEGMENT_DIRTY;
+    return false;
+  }
+  memset(&_segments[index], 0, sizeof(SegmentInfo));
+  _segments[index].state = SEGMENT_ERASED;
+  return true;
+}
+
+// ==================== COMPACTION ====================
+
+void SampleLog::maintain() {
+  if (_device == nullptr) {
+    return;
+  }
+
+  if (countFree() < SAMPLE_LOG_MIN_FREE) {
+    compactOldest();
+  }
+
+  // Keep one segment erased ahead of time so flush() only programs
+  bool haveErased = false;
+  int dirty = -1;
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    if (_segments[index].state == SEGMENT_ERASED) {
+      haveErased = true;
+      break;
+    }
+    if (_segments[index].state == SEGMENT_DIRTY && dirty < 0) {
+      dirty = (int)index;
+    }
+  }
+  if (!haveErased && dirty >= 0) {
+    eraseSegment(dirty);
+  }
+}
+
+/**
+ * Downsample the segment holding the oldest data into the next level,
+ * or drop it if it is already at the coarsest level
+ */
+bool SampleLog::compactOldest() {
+  int victim = oldestSegment();
+  if (victim < 0) {
+    return false;
+  }
+
+  uint8_t level = _segments[victim].level;
+  if (level + 1 < SAMPLE_LOG_LEVELS) {
+    uint8_t target = level + 1;
+    _compactedCount = 0;
+    _bucketCount = 0;
+    _compactionFailed = false;
+    _compacting = true;
+
+    uint32_t offset = sizeof(SegmentHeader);
+    SampleLogRecord records[SAMPLE_LOG_BATCH_RECORDS];
+    uint8_t count;
+    while (readBatch(victim, offset, records, count)) {
+      for (uint8_t i = 0; i < count; i++) {
+        compactRecord(records[i], LEVEL_BUCKET_SECONDS[target], target);
+      }
+    }
+    for (uint8_t i = 0; i < _bucketCount; i++) {
+      emitBucket(_buckets[i], target);
+    }
+    flushCompaction(target);
+    _compacting = false;
+
+    // Keep the source if its summary could not be written
+    if (_compactionFailed) {
+      return false;
+    }
+    _stats.compactions++;
+  } else {
+    _stats.segmentsDropped++;
+  }
+
+  return eraseSegment(victim);
+}
+
+/**
+ * Erase the segment holding the oldest data without summarizing it
+ */
+bool SampleLog::dropOldest() {
+  int victim = oldestSegment();
+  if (victim < 0) {
+    return false;
+  }
+  _stats.segmentsDropped++;
+  return eraseSegment(victim);
+}
+
+/**
+ * @return Sealed or inactive data segment with the oldest first record
+ */
+int SampleLog::oldestSegment() const {
+  int victim = -1;
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    const SegmentInfo &segment = _segments[index];
+    if (segment.state != SEGMENT_DATA || _active[segment.level] == (int)index) {
+      continue;
+    }
+    if (victim < 0 || segment.firstTime < _segments[victim].firstTime) {
+      victim = (int)index;
+    }
+  }
+  return victim;
+}
+
+/**
+ * Fold one record into its sensor's current time bucket
+ */
+void SampleLog::compactRecord(const SampleLogRecord &record,
+                              uint32_t bucketSeconds, uint8_t level) {
+  uint32_t start = record.time - record.time % bucketSeconds;
+
+  Bucket *bucket = nullptr;
+  for (uint8_t i = 0; i < _bucketCount; i++) {
+    if (_buckets[i].sensor == record.sensor) {
+      bucket = &_buckets[i];
+      break;
+    }
+  }
+  if (bucket == nullptr) {
+    if (_bucketCount == sizeof(_buckets) / sizeof(_buckets[0])) {
+      emitBucket(_buckets[0], level); // More sensors than slots: recycle
+      bucket = &_buckets[0];
+    } else {
+      bucket = &_buckets[_bucketCount++];
+    }
+    bucket->sensor = record.sensor;
+    bucket->count = 0;
+  } else if (bucket->count > 0 && bucket->start != start) {
+    emitBucket(*bucket, level);
+  }
+
+  if (bucket->count == 0) {
+    bucket->start = start;
+    bucket->temperatureSum = 0;
+    bucket->humiditySum = 0;
+  }
+  bucket->temperatureSum += (int32_t)record.temperature * record.count;
+  bucket->humiditySum += (int32_t)record.humidity * record.count;
+  bucket->count += record.count;
+}
+
+/**
+ * Turn a bucket into an averaged record in the compaction output batch
+ */
+void SampleLog::emitBucket(Bucket &bucket, uint8_t level) {
+  if (bucket.count == 0) {
+    return;
+  }
+
+  SampleLogRecord &record = _compacted[_compactedCount++];
+  record.time = bucket.start;
+  record.sensor = bucket.sensor;
+  record.level = level;
+  record.temperature = (int16_t)(bucket.temperatureSum / (int32_t)bucket.count);
+  record.humidity = (int16_t)(bucket.humiditySum / (int32_t)bucket.count);
+  record.count = bucket.count > 0xFFFF ? 0xFFFF : (uint16_t)bucket.count;
+  bucket.count = 0;
+
+  if (_compactedCount == SAMPLE_LOG_BATCH_RECORDS) {
+    flushCompaction(level);
+  }
+}
+
+bool SampleLog::flushCompaction(uint8_t level) {
+  if (_compactedCount == 0) {
+    return true;
+  }
+  if (!writeBatch(level, _compacted, _compactedCount)) {
+    _compactionFailed = true;
+  }
+  _compactedCount = 0;
+  return !_compactionFailed;
+}
+
+// ==================== QUERIES ====================
+
+size_t SampleLog::query(uint32_t from, uint32_t to, SampleLogVisitor visit,
+                        void *context) {
+  // Collect overlapping segments ordered by their oldest record
+  uint8_t order[SAMPLE_LOG_MAX_SEGMENTS];
+  size_t matches = 0;
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    const SegmentInfo &segment = _segments[index];
+    if (segment.state != SEGMENT_DATA || segment.records == 0 ||
+        segment.lastTime < from || segment.firstTime > to) {
+      continue;
+    }
+    size_t position = matches++;
+    while (position > 0 &&
+           _segments[order[position - 1]].firstTime > segment.firstTime) {
+      order[position] = order[position - 1];
+      position--;
+    }
+    order[position] = (uint8_t)index;
+  }
+
+  size_t visited = 0;
+  SampleLogRecord records[SAMPLE_LOG_BATCH_RECORDS];
+  for (size_t i = 0; i < matches; i++) {
+    uint32_t offset = sizeof(SegmentHeader);
+    uint8_t count;
+    while (readBatch(order[i], offset, records, count)) {
+      for (uint8_t r = 0; r < count; r++) {
+        if (records[r].time >= from && records[r].time <= to) {
+          visit(records[r], context);
+          visited++;
+        }
+      }
+    }
+  }
+
+  // Samples still waiting in RAM are the newest of all
+  for (uint8_t r = 0; r < _pendingCount; r++) {
+    if (_pending[r].time >= from && _pending[r].time <= to) {
+      visit(_pending[r], context);
+      visited++;
+    }
+  }
+
+  return visited;
+}
+
+uint32_t SampleLog::countFree() const {
+  uint32_t free = 0;
+  for (uint32_t index = 0; index < _segmentCount; index++) {
+    if (_segments[index].state != SEGMENT_DATA) {
+      free++;
+    }
+  }
+  return free;
+}
+
+SampleLogStats SampleLog::stats() const {
+  SampleLogStats stats = _stats;
+  stats.segmentsFree = countFree();
+  stats.segmentsUsed = _segmentCount - stats.segmentsFree;
+  return stats;
+}
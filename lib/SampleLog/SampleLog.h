@@ -0,0 +1,185 @@
+/**
+ * ESP32 Room Climate Monitor - Append-only Flash Sample Log
+ *
+ * Log-structured storage for sensor samples on a BlockDevice:
+ *
+ * - Each erase block is a segment with a small header (magic, sequence
+ *   number, downsampling level) followed by CRC-protected batches of
+ *   fixed 12-byte records. Records are only ever appended; a segment is
+ *   erased only when it is reclaimed, which spreads wear over the whole
+ *   device.
+ * - Samples are collected in a RAM batch and programmed in one go, so
+ *   flash is touched once per batch rather than once per sample.
+ * - A RAM index of every segment's time range lets range queries skip
+ *   segments that cannot match.
+ * - When free segments run low, the segment holding the oldest data is
+ *   compacted: its records are averaged into coarser time buckets
+ *   (level 0 raw -> level 1 10-minute -> level 2 hourly) and appended to
+ *   a segment of the next level, then the source is erased. Data at the
+ *   coarsest level is dropped when it is the oldest.
+ *
+ * Time is a log-relative second counter. There is no RTC, so after a
+ * reboot the caller continues from nextTime() recovered at mount.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "BlockDevice.h"
+
+// Records per RAM batch (one flash program operation)
+#ifndef SAMPLE_LOG_BATCH_RECORDS
+#define SAMPLE_LOG_BATCH_RECORDS  20
+#endif
+
+// Segments tracked in the RAM index (extra device blocks are unused)
+#ifndef SAMPLE_LOG_MAX_SEGMENTS
+#define SAMPLE_LOG_MAX_SEGMENTS   128
+#endif
+
+// Free segments kept in reserve by maintain()
+#ifndef SAMPLE_LOG_MIN_FREE
+#define SAMPLE_LOG_MIN_FREE       2
+#endif
+
+// Downsampling levels: raw, 10-minute averages, hourly averages
+#define SAMPLE_LOG_LEVELS         3
+
+// One stored sample or downsampled average (12 bytes on flash)
+struct SampleLogRecord {
+  uint32_t time;          // Log time in seconds (bucket start when downsampled)
+  uint8_t sensor;         // Modbus address of the sensor
+  uint8_t level;          // 0 = raw sample, >0 = downsampled
+  int16_t temperature;    // 0.1 °C
+  int16_t humidity;       // 0.1 %RH
+  uint16_t count;         // Raw samples represented by this record
+};
+
+typedef void (*SampleLogVisitor)(const SampleLogRecord &record, void *context);
+
+struct SampleLogStats {
+  uint32_t segmentsUsed;
+  uint32_t segmentsFree;
+  uint32_t batchesWritten;
+  uint32_t compactions;
+  uint32_t segmentsDropped;
+  uint32_t erases;
+  uint32_t writeErrors;
+};
+
+class SampleLog {
+public:
+  SampleLog();
+
+  /**
+   * Scan the device and rebuild the segment index
+   *
+   * @return false if the device has fewer than SAMPLE_LOG_MIN_FREE + 2 blocks
+   */
+  bool mount(BlockDevice *device);
+
+  /**
+   * Queue a raw sample; the batch is written when it becomes full
+   *
+   * @return false if a full batch could not be written
+   */
+  bool append(uint32_t time, uint8_t sensor, int16_t temperature,
+              int16_t humidity);
+
+  /**
+   * Write the pending batch, if any
+   */
+  bool flush();
+
+  /**
+   * Background upkeep: compact until SAMPLE_LOG_MIN_FREE segments are
+   * free and pre-erase one free segment so the next flush never erases.
+   * Performs at most one compaction per call.
+   */
+  void maintain();
+
+  /**
+   * Visit all records with from <= time <= to
+   * Segments are visited in order of their oldest record
+   *
+   * @return Number of records visited
+   */
+  size_t query(uint32_t from, uint32_t to, SampleLogVisitor visit,
+               void *context);
+
+  // First unused log time, recovered at mount and advanced by append()
+  uint32_t nextTime() const { return _nextTime; }
+  size_t pending() const { return _pendingCount; }
+  SampleLogStats stats() const;
+
+private:
+  enum SegmentState : uint8_t {
+    SEGMENT_DIRTY,        // Unknown content; erase before use
+    SEGMENT_ERASED,       // Blank and ready for a header
+    SEGMENT_DATA          // Valid header and records
+  };
+
+  struct SegmentInfo {
+    uint32_t sequence;
+    uint32_t firstTime;
+    uint32_t lastTime;
+    uint32_t writeOffset; // blockSize when sealed
+    uint16_t records;
+    uint8_t level;
+    SegmentState state;
+  };
+
+  // Streaming per-sensor averaging used by compaction
+  struct Bucket {
+    uint8_t sensor;
+    uint32_t start;
+    int32_t temperatureSum;
+    int32_t humiditySum;
+    uint32_t count;
+  };
+
+  void scanSegment(uint32_t index);
+  bool readBatch(uint32_t index, uint32_t &offset, SampleLogRecord *records,
+                 uint8_t &count);
+  bool writeBatch(uint8_t level, const SampleLogRecord *records,
+                  uint8_t count);
+  int openSegment(uint8_t level);
+  int allocateSegment();
+  bool eraseSegment(uint32_t index);
+  bool compactOldest();
+  bool dropOldest();
+  int oldestSegment() const;
+  void compactRecord(const SampleLogRecord &record, uint32_t bucketSeconds,
+                     uint8_t level);
+  void emitBucket(Bucket &bucket, uint8_t level);
+  bool flushCompaction(uint8_t level);
+  uint32_t countFree() const;
+
+  BlockDevice *_device;
+  uint32_t _segmentCount;
+  uint32_t _nextSequence;
+  uint32_t _nextTime;
+  int _active[SAMPLE_LOG_LEVELS];   // Segment receiving appends per level
+  SegmentInfo _segments[SAMPLE_LOG_MAX_SEGMENTS];
+
+  SampleLogRecord _pending[SAMPLE_LOG_BATCH_RECORDS];
+  uint8_t _pendingCount;
+
+  // Compaction output buffer and per-sensor accumulators
+  SampleLogRecord _compacted[SAMPLE_LOG_BATCH_RECORDS];
+  uint8_t _compactedCount;
+  Bucket _buckets[16];
+  uint8_t _bucketCount;
+  bool _compacting;
+  bool _compactionFailed;
+
+  SampleLogStats _stats;
+};
+
+#endif // SAMPLE_LOG_H
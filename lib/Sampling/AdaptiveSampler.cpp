@@ -0,0 +1,84 @@
+/**
+ * ESP32 Room Climate Monitor - Adaptive Sampling Interval
+ *
+ * See AdaptiveSampler.h for the policy.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "AdaptiveSampler.h"
+
+AdaptiveSampler::AdaptiveSampler()
+  : _channels(),
+    _reference(),
+    _channelCount(0),
+    _primed(false),
+    _minIntervalMs(0),
+    _maxIntervalMs(0),
+    _intervalMs(0),
+    _activeReadings(0),
+    _flatReadings(0) {
+}
+
+void AdaptiveSampler::begin(uint32_t minIntervalMs, uint32_t maxIntervalMs,
+                            const AdaptiveChannel *channels,
+                            size_t channelCount) {
+  _channelCount = channelCount > ADAPTIVE_SAMPLER_MAX_CHANNELS ?
+                  ADAPTIVE_SAMPLER_MAX_CHANNELS : channelCount;
+  for (size_t i = 0; i < _channelCount; i++) {
+    _channels[i] = channels[i];
+  }
+  _minIntervalMs = minIntervalMs;
+  _maxIntervalMs = maxIntervalMs < minIntervalMs ? minIntervalMs :
+                   maxIntervalMs;
+  _intervalMs = _minIntervalMs;
+  _primed = false;
+  _activeReadings = 0;
+  _flatReadings = 0;
+}
+
+uint32_t AdaptiveSampler::update(const int16_t *values) {
+  bool moved = !_primed;
+  bool nearThreshold = false;
+
+  for (size_t i = 0; i < _channelCount; i++) {
+    const AdaptiveChannel &channel = _channels[i];
+    int32_t value = values[i];
+    int32_t change = value - _reference[i];
+    if (change > channel.deadband || change < -channel.deadband) {
+      moved = true;
+    }
+    int32_t toLow = value - channel.low;
+    int32_t toHigh = value - channel.high;
+    if ((toLow >= -channel.margin && toLow <= channel.margin) ||
+        (toHigh >= -channel.margin && toHigh <= channel.margin)) {
+      nearThreshold = true;
+    }
+  }
+
+  if (moved) {
+    for (size_t i = 0; i < _channelCount; i++) {
+      _reference[i] = values[i];
+    }
+    _primed = true;
+  }
+
+  if (moved || nearThreshold) {
+    _intervalMs = _minIntervalMs;
+    _activeReadings++;
+  } else {
+    // Exponential back-off while the readings stay flat
+    _intervalMs = _intervalMs > _maxIntervalMs / 2 ? _maxIntervalMs :
+                  _intervalMs * 2;
+    _flatReadings++;
+  }
+  return _intervalMs;
+}
+
+uint32_t AdaptiveSampler::reset() {
+  _primed = false;
+  _intervalMs = _minIntervalMs;
+  return _intervalMs;
+}
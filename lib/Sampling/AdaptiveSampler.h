@@ -0,0 +1,85 @@
+/**
+ * ESP32 Room Climate Monitor - Adaptive Sampling Interval
+ *
+ * Picks the time until the next reading of a sensor from the readings
+ * themselves, so the bus, the log and the display only work when
+ * something is happening:
+ * - A channel that moved more than its deadband since the last
+ *   significant value drops the interval to the minimum
+ * - A channel within its margin of a low or high threshold holds the
+ *   interval at the minimum, so limit crossings are caught promptly
+ * - Otherwise the interval doubles, up to the maximum
+ *
+ * The deadband is measured against the value that last triggered a
+ * change rather than the previous reading, so slow drifts still add up
+ * to a change. All values are fixed-point integers (e.g. deci-units).
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ADAPTIVE_SAMPLER_MAX_CHANNELS  4
+
+// Change detection settings for one measured quantity
+struct AdaptiveChannel {
+  int16_t deadband;          // Changes up to this size count as flat
+  int16_t low;               // Thresholds worth watching closely
+  int16_t high;
+  int16_t margin;            // Distance from a threshold that counts as near
+};
+
+class AdaptiveSampler {
+public:
+  AdaptiveSampler();
+
+  /**
+   * Configure the interval range and channels, and start at the minimum
+   *
+   * @param channels Settings per channel (at most ADAPTIVE_SAMPLER_MAX_CHANNELS)
+   * @param channelCount Number of channels
+   */
+  void begin(uint32_t minIntervalMs, uint32_t maxIntervalMs,
+             const AdaptiveChannel *channels, size_t channelCount);
+
+  /**
+   * Fold in a new reading
+   *
+   * @param values One value per channel
+   * @return Interval until the next reading
+   */
+  uint32_t update(const int16_t *values);
+
+  /**
+   * Forget the reference values after a failed reading; the next
+   * successful one counts as a change
+   *
+   * @return Interval until the next attempt (the minimum)
+   */
+  uint32_t reset();
+
+  uint32_t intervalMs() const { return _intervalMs; }
+
+  // Readings that moved beyond the deadband or sat near a threshold
+  uint32_t activeReadings() const { return _activeReadings; }
+  uint32_t flatReadings() const { return _flatReadings; }
+
+private:
+  AdaptiveChannel _channels[ADAPTIVE_SAMPLER_MAX_CHANNELS];
+  int16_t _reference[ADAPTIVE_SAMPLER_MAX_CHANNELS];
+  size_t _channelCount;
+  bool _primed;                  // _reference holds a reading
+  uint32_t _minIntervalMs;
+  uint32_t _maxIntervalMs;
+  uint32_t _intervalMs;
+  uint32_t _activeReadings;
+  uint32_t _flatReadings;
+};
+
+#endif // ADAPTIVE_SAMPLER_H
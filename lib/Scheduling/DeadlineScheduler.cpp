@@ -0,0 +1,156 @@
+/**
+ * ESP32 Room Climate Monitor - Deadline Job Scheduler
+ *
+ * See DeadlineScheduler.h for the scheduling rules.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "DeadlineScheduler.h"
+
+DeadlineScheduler::DeadlineScheduler()
+  : _jobs(),
+    _heap(),
+    _jobCount(0),
+    _heapSize(0) {
+}
+
+int DeadlineScheduler::add(DeadlineJobFunction function, uint32_t periodUs,
+                           uint32_t firstDueUs) {
+  if (_jobCount >= DEADLINE_SCHEDULER_MAX_JOBS || function == nullptr) {
+    return -1;
+  }
+  int id = (int)_jobCount++;
+  Job &job = _jobs[id];
+  job.function = function;
+  job.periodUs = periodUs;
+  job.dueUs = firstDueUs;
+  job.heapIndex = -1;
+  job.stats = DeadlineJobStats();
+  insert(id);
+  return id;
+}
+
+void DeadlineScheduler::reschedule(int id, uint32_t dueUs) {
+  Job &job = _jobs[id];
+  if (job.heapIndex >= 0 && job.dueUs == dueUs) {
+    return;
+  }
+  cancel(id);
+  job.dueUs = dueUs;
+  insert(id);
+}
+
+void DeadlineScheduler::cancel(int id) {
+  if (_jobs[id].heapIndex >= 0) {
+    removeAt((size_t)_jobs[id].heapIndex);
+  }
+}
+
+size_t DeadlineScheduler::runDue(uint32_t nowUs) {
+  size_t ran = 0;
+
+  // Bounded so a job that re-arms itself in the past cannot spin forever
+  for (size_t n = 0; n < _jobCount && _heapSize > 0; n++) {
+    int id = _heap[0];
+    Job &job = _jobs[id];
+    int32_t latenessUs = (int32_t)(nowUs - job.dueUs);
+    if (latenessUs < 0) {
+      break;
+    }
+
+    // Re-arm before running so the job may reschedule or cancel itself
+    removeAt(0);
+    if (job.periodUs > 0) {
+      job.dueUs += job.periodUs;
+      if ((int32_t)(nowUs - job.dueUs) >= 0) {
+        job.dueUs = nowUs + job.periodUs; // Skip the missed runs
+      }
+      insert(id);
+    }
+
+    job.stats.runs++;
+    job.stats.totalLatenessUs += (uint32_t)latenessUs;
+    if ((uint32_t)latenessUs > job.stats.maxLatenessUs) {
+      job.stats.maxLatenessUs = (uint32_t)latenessUs;
+    }
+    job.stats.lastLatenessUs = (uint32_t)latenessUs;
+    job.function();
+    ran++;
+  }
+  return ran;
+}
+
+uint32_t DeadlineScheduler::timeUntilNextUs(uint32_t nowUs) const {
+  if (_heapSize == 0) {
+    return UINT32_MAX;
+  }
+  int32_t remainingUs = (int32_t)(_jobs[_heap[0]].dueUs - nowUs);
+  return remainingUs > 0 ? (uint32_t)remainingUs : 0;
+}
+
+// ==================== HEAP ====================
+
+bool DeadlineScheduler::before(uint8_t a, uint8_t b) const {
+  int32_t difference = (int32_t)(_jobs[a].dueUs - _jobs[b].dueUs);
+  return difference < 0 || (difference == 0 && a < b);
+}
+
+void DeadlineScheduler::swap(size_t i, size_t j) {
+  uint8_t id = _heap[i];
+  _heap[i] = _heap[j];
+  _heap[j] = id;
+  _jobs[_heap[i]].heapIndex = (int16_t)i;
+  _jobs[_heap[j]].heapIndex = (int16_t)j;
+}
+
+void DeadlineScheduler::siftUp(size_t index) {
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (!before(_heap[index], _heap[parent])) {
+      break;
+    }
+    swap(index, parent);
+    index = parent;
+  }
+}
+
+void DeadlineScheduler::siftDown(size_t index) {
+  for (;;) {
+    size_t smallest = index;
+    size_t left = index * 2 + 1;
+    size_t right = left + 1;
+    if (left < _heapSize && before(_heap[left], _heap[smallest])) {
+      smallest = left;
+    }
+    if (right < _heapSize && before(_heap[right], _heap[smallest])) {
+      smallest = right;
+    }
+    if (smallest == index) {
+      break;
+    }
+    swap(index, smallest);
+    index = smallest;
+  }
+}
+
+void DeadlineScheduler::insert(int id) {
+  size_t index = _heapSize++;
+  _heap[index] = (uint8_t)id;
+  _jobs[id].heapIndex = (int16_t)index;
+  siftUp(index);
+}
+
+void DeadlineScheduler::removeAt(size_t index) {
+  _jobs[_heap[index]].heapIndex = -1;
+  _heapSize--;
+  if (index == _heapSize) {
+    return;
+  }
+  _heap[index] = _heap[_heapSize];
+  _jobs[_heap[index]].heapIndex = (int16_t)index;
+  siftDown(index);
+  siftUp(index);
+}
@@ -0,0 +1,102 @@
+/**
+ * ESP32 Room Climate Monitor - Deadline Job Scheduler
+ *
+ * Runs timed jobs from one task and tells the task exactly how long it
+ * may sleep, instead of waking on a fixed period to compare timestamps:
+ * - Jobs live in a fixed-capacity binary min-heap ordered by deadline
+ *   (ties run in the order the jobs were added)
+ * - Periodic jobs are re-armed at deadline + period, so they do not
+ *   drift with scheduling delays; a job that fell more than a period
+ *   behind skips the missed runs instead of bursting
+ * - One-shot jobs (period 0) stay parked until reschedule() arms them
+ * - Each run records its lateness (start time - deadline)
+ *
+ * Times are microseconds from micros(); differences are taken modulo
+ * 2^32, so deadlines must lie within ±35 minutes of the current time.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef DEADLINE_SCHEDULER_H
+#define DEADLINE_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEADLINE_SCHEDULER_MAX_JOBS  8
+
+typedef void (*DeadlineJobFunction)();
+
+// Timing of one job since the last resetStats()
+struct DeadlineJobStats {
+  uint32_t runs;
+  uint32_t totalLatenessUs;
+  uint32_t maxLatenessUs;
+  uint32_t lastLatenessUs;   // Of the run in progress or the latest one
+};
+
+class DeadlineScheduler {
+public:
+  DeadlineScheduler();
+
+  /**
+   * Register a job
+   *
+   * @param function Called from runDue() when the deadline passes
+   * @param periodUs Re-arm interval, or 0 for a one-shot job
+   * @param firstDueUs First deadline
+   * @return Job id, or -1 if the scheduler is full
+   */
+  int add(DeadlineJobFunction function, uint32_t periodUs, uint32_t firstDueUs);
+
+  /**
+   * Move a job's deadline (arms a parked one-shot job)
+   */
+  void reschedule(int id, uint32_t dueUs);
+
+  /**
+   * Park a job until it is rescheduled
+   */
+  void cancel(int id);
+
+  /**
+   * Run every job whose deadline has passed, earliest first
+   *
+   * @return Number of jobs run
+   */
+  size_t runDue(uint32_t nowUs);
+
+  /**
+   * @return Time until the earliest deadline (0 if one has passed), or
+   *         UINT32_MAX if no job is armed
+   */
+  uint32_t timeUntilNextUs(uint32_t nowUs) const;
+
+  const DeadlineJobStats &stats(int id) const { return _jobs[id].stats; }
+  void resetStats(int id) { _jobs[id].stats = DeadlineJobStats(); }
+
+private:
+  struct Job {
+    DeadlineJobFunction function;
+    uint32_t periodUs;
+    uint32_t dueUs;
+    int16_t heapIndex;           // Position in _heap, or -1 when parked
+    DeadlineJobStats stats;
+  };
+
+  bool before(uint8_t a, uint8_t b) const;
+  void swap(size_t i, size_t j);
+  void siftUp(size_t index);
+  void siftDown(size_t index);
+  void insert(int id);
+  void removeAt(size_t index);
+
+  Job _jobs[DEADLINE_SCHEDULER_MAX_JOBS];
+  uint8_t _heap[DEADLINE_SCHEDULER_MAX_JOBS];  // Job ids, earliest first
+  size_t _jobCount;
+  size_t _heapSize;
+};
+
+#endif // DEADLINE_SCHEDULER_H
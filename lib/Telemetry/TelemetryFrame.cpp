@@ -0,0 +1,179 @@
+/**
+ * ESP32 Room Climate Monitor - Binary Telemetry Frames
+ *
+ * See TelemetryFrame.h for the frame layout.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include "TelemetryFrame.h"
+#include <string.h>
+#include "ModbusCRC.h"
+
+// Longest run a COBS code byte can describe
+#define COBS_BLOCK  0xFF
+
+static void putU16(uint8_t *out, uint16_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t getU16(const uint8_t *in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+// ==================== COBS ====================
+
+size_t Cobs::encode(const uint8_t *data, size_t length, uint8_t *out) {
+  size_t codeAt = 0;
+  size_t written = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] != 0) {
+      out[written++] = data[i];
+      code++;
+    }
+    // A zero, or a full block, closes the current run
+    if (data[i] == 0 || code == COBS_BLOCK) {
+      out[codeAt] = code;
+      codeAt = written++;
+      code = 1;
+    }
+  }
+  out[codeAt] = code;
+  return written;
+}
+
+size_t Cobs::decode(const uint8_t *frame, size_t length, uint8_t *out) {
+  size_t read = 0;
+  size_t written = 0;
+  while (read < length) {
+    uint8_t code = frame[read++];
+    if (code == 0 || read + code - 1 > length) {
+      return 0;
+    }
+    for (uint8_t i = 1; i < code; i++) {
+      if (frame[read] == 0) {
+        return 0;
+      }
+      out[written++] = frame[read++];
+    }
+    // Every run but a full block or the last one stood for a zero
+    if (code != COBS_BLOCK && read < length) {
+      out[written++] = 0;
+    }
+  }
+  return written;
+}
+
+// ==================== ENCODER ====================
+
+TelemetryEncoder::TelemetryEncoder()
+  : _payload(),
+    _count(0),
+    _baseTimeMs(0),
+    _sequence(0) {
+}
+
+bool TelemetryEncoder::add(const TelemetryRecord &record) {
+  if (_count >= TELEMETRY_MAX_RECORDS) {
+    return false;
+  }
+  if (_count == 0) {
+    _baseTimeMs = record.timestampMs;
+  }
+  uint32_t offset = record.timestampMs - _baseTimeMs;
+  if (offset > UINT16_MAX) {
+    return false;
+  }
+
+  uint8_t *out = _payload + TELEMETRY_HEADER_LENGTH +
+                 _count * TELEMETRY_RECORD_LENGTH;
+  putU16(out, (uint16_t)offset);
+  out[2] = record.address;
+  putU16(out + 3, (uint16_t)record.temperature);
+  putU16(out + 5, (uint16_t)record.humidity);
+  out[7] = record.flags;
+  _count++;
+  return true;
+}
+
+size_t TelemetryEncoder::finish(uint8_t *out) {
+  if (_count == 0) {
+    return 0;
+  }
+  _payload[0] = TELEMETRY_FRAME_SAMPLES;
+  _payload[1] = _sequence++;
+  putU16(_payload + 2, (uint16_t)_baseTimeMs);
+  putU16(_payload + 4, (uint16_t)(_baseTimeMs >> 16));
+  _payload[6] = (uint8_t)_count;
+  size_t length = TELEMETRY_HEADER_LENGTH + _count * TELEMETRY_RECORD_LENGTH;
+  _count = 0;
+  return seal(_payload, length, out);
+}
+
+size_t TelemetryEncoder::encodeLog(const char *text, size_t length,
+                                   uint8_t *out) {
+  if (length > TELEMETRY_MAX_TEXT) {
+    length = TELEMETRY_MAX_TEXT;
+  }
+  uint8_t payload[TELEMETRY_LOG_PAYLOAD];
+  payload[0] = TELEMETRY_FRAME_LOG;
+  payload[1] = _sequence++;
+  memcpy(payload + 2, text, length);
+  return seal(payload, length + 2, out);
+}
+
+/**
+ * Append the CRC, stuff the payload and terminate it with the delimiter
+ */
+size_t TelemetryEncoder::seal(uint8_t *payload, size_t length, uint8_t *out) {
+  ModbusCRC::append(payload, length);
+  size_t encoded = Cobs::encode(payload, length + 2, out);
+  out[encoded] = 0;
+  return encoded + 1;
+}
+
+// ==================== DECODER ====================
+
+bool TelemetryDecoder::parse(const uint8_t *encoded, size_t length,
+                             uint8_t *buffer, TelemetryFrame &frame) {
+  size_t decoded = Cobs::decode(encoded, length, buffer);
+  if (decoded < 4 || !ModbusCRC::check(buffer, decoded)) {
+    return false;
+  }
+  decoded -= 2;
+
+  frame.type = buffer[0];
+  frame.sequence = buffer[1];
+  frame.baseTimeMs = 0;
+  frame.recordCount = 0;
+  if (frame.type == TELEMETRY_FRAME_LOG) {
+    frame.body = buffer + 2;
+    frame.bodyLength = decoded - 2;
+    return true;
+  }
+  if (frame.type != TELEMETRY_FRAME_SAMPLES ||
+      decoded < TELEMETRY_HEADER_LENGTH) {
+    return false;
+  }
+  frame.baseTimeMs = getU16(buffer + 2) | ((uint32_t)getU16(buffer + 4) << 16);
+  frame.recordCount = buffer[6];
+  frame.body = buffer + TELEMETRY_HEADER_LENGTH;
+  frame.bodyLength = decoded - TELEMETRY_HEADER_LENGTH;
+  return frame.bodyLength == (size_t)frame.recordCount * TELEMETRY_RECORD_LENGTH;
+}
+
+TelemetryRecord TelemetryDecoder::record(const TelemetryFrame &frame,
+                                         size_t index) {
+  const uint8_t *in = frame.body + index * TELEMETRY_RECORD_LENGTH;
+  TelemetryRecord record;
+  record.timestampMs = frame.baseTimeMs + getU16(in);
+  record.address = in[2];
+  record.temperature = (int16_t)getU16(in + 3);
+  record.humidity = (int16_t)getU16(in + 5);
+  record.flags = in[7];
+  return record;
+}
@@ -0,0 +1,159 @@
+/**
+ * ESP32 Room Climate Monitor - Binary Telemetry Frames
+ *
+ * Compact machine-readable alternative to the text log on the serial
+ * console. Samples are batched into frames, each protected by a
+ * CRC-16/Modbus and COBS-encoded so that 0x00 only ever appears as the
+ * frame delimiter; a reader that starts mid-stream, or loses bytes,
+ * resynchronises at the next zero.
+ *
+ * Frame payload before COBS (multi-byte fields little-endian):
+ *
+ *   type      u8   TELEMETRY_FRAME_SAMPLES or TELEMETRY_FRAME_LOG
+ *   sequence  u8   Increments per frame; gaps reveal lost frames
+ *   samples:  baseTimeMs u32, count u8, then count records of
+ *             offsetMs u16 (from baseTimeMs), address u8,
+ *             temperature i16 (0.1 °C), humidity i16 (0.1 %RH), flags u8
+ *   log:      the formatted text line, no terminator
+ *   crc       u16  Over everything above
+ *
+ * A sample costs 8 bytes on the wire instead of ~70 for its text line.
+ * tools/telemetry_decode.cpp turns a captured stream into CSV.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_FRAME_SAMPLES  0x01
+#define TELEMETRY_FRAME_LOG      0x02
+
+// Record status flags
+#define TELEMETRY_VALID     0x01  // Reading accepted and published
+#define TELEMETRY_LOST      0x02  // No or invalid reply; last published values
+#define TELEMETRY_REJECTED  0x04  // Dropped as implausible; raw values
+#define TELEMETRY_ALERT     0x08  // At least one comfort rule is active
+
+#define TELEMETRY_MAX_RECORDS    16    // Records per samples frame
+#define TELEMETRY_MAX_TEXT       128   // Characters per log frame
+#define TELEMETRY_HEADER_LENGTH  7     // Type, sequence, base time, count
+#define TELEMETRY_RECORD_LENGTH  8
+
+// Payload sizes including the CRC, and the largest frame once encoded
+// and delimited
+#define TELEMETRY_SAMPLES_PAYLOAD  (TELEMETRY_HEADER_LENGTH + \
+  TELEMETRY_MAX_RECORDS * TELEMETRY_RECORD_LENGTH + 2)
+#define TELEMETRY_LOG_PAYLOAD      (TELEMETRY_MAX_TEXT + 4)
+#define TELEMETRY_MAX_PAYLOAD      (TELEMETRY_SAMPLES_PAYLOAD > \
+  TELEMETRY_LOG_PAYLOAD ? TELEMETRY_SAMPLES_PAYLOAD : TELEMETRY_LOG_PAYLOAD)
+#define TELEMETRY_MAX_FRAME        (TELEMETRY_MAX_PAYLOAD + \
+  TELEMETRY_MAX_PAYLOAD / 254 + 2)
+
+// One sensor reading as sent on the wire
+struct TelemetryRecord {
+  uint32_t timestampMs;
+  uint8_t address;
+  int16_t temperature;
+  int16_t humidity;
+  uint8_t flags;
+};
+
+// Consistent Overhead Byte Stuffing
+class Cobs {
+public:
+  static constexpr size_t encodedSize(size_t length) {
+    return length + length / 254 + 1;
+  }
+
+  /**
+   * @param out At least encodedSize(length) bytes; gets no delimiter
+   * @return Encoded length
+   */
+  static size_t encode(const uint8_t *data, size_t length, uint8_t *out);
+
+  /**
+   * @param frame Encoded bytes between two delimiters
+   * @param out At least length bytes
+   * @return Decoded length, or 0 if the frame is malformed
+   */
+  static size_t decode(const uint8_t *frame, size_t length, uint8_t *out);
+};
+
+/**
+ * Batches records into samples frames (firmware side)
+ */
+class TelemetryEncoder {
+public:
+  TelemetryEncoder();
+
+  /**
+   * Add a record to the open batch
+   *
+   * @return false if the batch is full or the record is too far from
+   *         its first one; finish() the batch and add it again
+   */
+  bool add(const TelemetryRecord &record);
+
+  size_t recordCount() const { return _count; }
+
+  /**
+   * Close the batch into a delimited frame and start a new one
+   *
+   * @param out At least TELEMETRY_MAX_FRAME bytes
+   * @return Bytes to send (0 if the batch was empty)
+   */
+  size_t finish(uint8_t *out);
+
+  /**
+   * Wrap a text line in a delimited log frame (truncated to
+   * TELEMETRY_MAX_TEXT characters)
+   *
+   * @return Bytes to send
+   */
+  size_t encodeLog(const char *text, size_t length, uint8_t *out);
+
+private:
+  static size_t seal(uint8_t *payload, size_t length, uint8_t *out);
+
+  uint8_t _payload[TELEMETRY_SAMPLES_PAYLOAD];  // Open batch
+  size_t _count;
+  uint32_t _baseTimeMs;
+  uint8_t _sequence;
+};
+
+// A checked frame, pointing into the caller's decode buffer
+struct TelemetryFrame {
+  uint8_t type;
+  uint8_t sequence;
+  uint32_t baseTimeMs;       // Samples frames only
+  uint8_t recordCount;       // Samples frames only
+  const uint8_t *body;       // Records, or the log text
+  size_t bodyLength;
+};
+
+/**
+ * Validates frames and unpacks records (host side)
+ */
+class TelemetryDecoder {
+public:
+  /**
+   * Decode one frame received between delimiters
+   *
+   * @param buffer Scratch space of at least length bytes, referenced by
+   *               the result
+   * @return false if the frame is malformed, fails its CRC or has an
+   *         unknown type
+   */
+  static bool parse(const uint8_t *encoded, size_t length, uint8_t *buffer,
+                    TelemetryFrame &frame);
+
+  static TelemetryRecord record(const TelemetryFrame &frame, size_t index);
+};
+
+#endif // TELEMETRY_FRAME_H
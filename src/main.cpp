@@ -20,35 +20,498 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <HardwareSerial.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <atomic>
 #include "config.h"
+#include "DeadlineScheduler.h"
+#include "FixedPoint.h"
+#include "HttpStatusServer.h"
+#include "Logger.h"
+#include "ModbusBaudNegotiator.h"
+#include "ModbusBusScheduler.h"
+#include "SampleHistory.h"
+#include "ModbusCRC.h"
+#include "ModbusFrameDecoder.h"
+#include "ModbusReadPlanner.h"
+#include "ModbusRetryPolicy.h"
+#include "ModbusSlave.h"
+#include "ModbusTransaction.h"
+#include "MqttClient.h"
+#include "MqttOutbox.h"
+#include "MpscRing.h"
+#include "AdaptiveSampler.h"
+#include "OledDirtyFlush.h"
+#include "PartitionBlockDevice.h"
+#include "Psychrometrics.h"
+#include "RuleEngine.h"
+#include "RuntimeMetrics.h"
+#include "ReadingFilters.h"
+#include "SampleLog.h"
+#include "SeqLock.h"
+#include "TelemetryFrame.h"
+
+// Light sleep between deadlines needs power management and tickless idle
+// in the sdkconfig (see ENABLE_LIGHT_SLEEP)
+#if ENABLE_LIGHT_SLEEP && defined(CONFIG_PM_ENABLE) && \
+    defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+#include <esp_pm.h>
+#define LIGHT_SLEEP_SUPPORTED 1
+#endif
 
 // ==================== FUNCTION DECLARATIONS ====================
+struct SensorFilter;
+struct SensorSample;
 void initializeHardware();
 void initializeRS485Communication();
-void initializeOLEDDisplay();
+void initializeSensorFilter(SensorFilter &filter, int16_t maxRate,
+                            int16_t slack, uint32_t drift, uint32_t noise);
+bool initializeOLEDDisplay();
+void initializeSchedules();
+void configureLightSleep();
+void holdBusAwake(bool hold);
+void initializeModbusGateway();
+void initializeWiFi();
+void initializeStatusServer();
+void initializeMqtt();
+void acquisitionTask(void *parameter);
+TickType_t acquisitionCycle();
+void pollSensorJob();
+void scheduleNextPoll();
+void reportAcquisitionTiming();
+void renderTask(void *parameter);
+TickType_t renderCycle();
+TickType_t ticksUntil(uint32_t waitUs);
+void storageTask(void *parameter);
+QueueHandle_t openSampleLogQueue();
+void logTask(void *parameter);
+void logCycle();
+void gatewayTask(void *parameter);
+TickType_t gatewayCycle(bool lineIdle);
+void publishSample(int sensor, const SensorSample &sample);
+void httpTask(void *parameter);
+void httpCycle(uint32_t waitMs);
+bool publishDocument(HttpResponseCache &cache,
+                     void (*serialize)(TextBuilder &json));
+void writeStatusJson(TextBuilder &json);
+void writeHistoryJson(TextBuilder &json);
+void writeHealthJson(TextBuilder &json);
+void writeAggregateJson(TextBuilder &json, const HistoryAggregate &aggregate);
+void mqttTask(void *parameter);
+TickType_t mqttCycle(uint32_t waitMs);
+void batchMqttSamples();
+void drainMqttOutbox(uint32_t nowMs);
+void queueTelemetry(int sensor, uint8_t flags, int16_t temperature,
+                    int16_t humidity);
+void flushTelemetry();
+void writeLogFrame(const char *line, size_t length);
+void pollSerialCommands();
+void runSerialCommand(const char *command);
+void dumpRawHistory();
+void reportMetrics(bool clear);
+void reportLatency(const char *format, LatencyHistogram &histogram,
+                   bool clear);
 void readXYMD02Sensor();
+bool serviceSensorTransaction();
+bool extractSensorFrame(int sensor, const uint8_t *response, size_t length,
+                        ModbusFrameView &frame);
+bool processSensorResponse(int sensor, const uint8_t *response, size_t length);
+bool processBaudRateWrite(int sensor, const uint8_t *response, size_t length);
+void updateSensorBaudRate(int sensor, bool valid);
+void updateSensorHealth(int sensor, bool valid, bool timedOut);
+void selectSensorLineBaudRate(uint32_t baudRate);
 void updateDisplay();
-void displaySensorData();
-void displayErrorMessage();
-void displayComfortStatus();
+void rotateDisplayedSensor();
+void reportDisplayStats();
+void drawStaticLayout();
+void flushDisplay();
+void displaySensorData(size_t sensor, const SensorSample &reading);
+void displayErrorMessage(ModbusHealthState health);
+void displayComfortStatus(size_t sensor, const SensorSample &reading);
+void displaySensorLabel(uint8_t address);
 void displayUptime();
-uint16_t calculateCRC(uint8_t *data, uint8_t length);
-bool validateModbusResponse(uint8_t *response, uint8_t expectedLength);
-void clearSerialBuffer();
+void queueSampleForLog(int sensor);
+void logComfortRuleEvent(const RuleEvent &event);
+bool processSensorConfiguration(int sensor, const ModbusReadFrame &frame,
+                                const ModbusReadResponse &registers);
+void logReadFailure(int sensor, const ModbusReadResponse &result,
+                    const uint8_t *response, size_t length);
 
 // ==================== HARDWARE CONFIGURATION ====================
 // OLED Display instance
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
+/**
+ * Wire adapter for incremental SSD1306 flushes
+ * Each transaction starts with the SSD1306 control byte
+ */
+class DisplayI2CBus : public OledBus {
+public:
+  size_t sendCommands(const uint8_t *commands, size_t length) override {
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    Wire.write((uint8_t)0x00); // Control byte: command stream
+    Wire.write(commands, length);
+    Wire.endTransmission();
+    return length + 2; // Address + control byte
+  }
+
+  size_t sendData(const uint8_t *data, size_t length) override {
+    size_t bytes = 0;
+    while (length > 0) {
+      size_t chunk = length > OLED_I2C_CHUNK ? OLED_I2C_CHUNK : length;
+      Wire.beginTransmission(SCREEN_ADDRESS);
+      Wire.write((uint8_t)0x40); // Control byte: display RAM data
+      Wire.write(data, chunk);
+      Wire.endTransmission();
+      bytes += chunk + 2;
+      data += chunk;
+      length -= chunk;
+    }
+    return bytes;
+  }
+};
+
+// Sends only the changed page windows of each frame
+DisplayI2CBus displayBus;
+OledDirtyFlush displayFlush;
+
+/**
+ * UART adapter for the Modbus engines (sensor bus and gateway)
+ * Writes are buffered by the UART driver so they return immediately
+ */
+class RS485SerialPort : public ModbusPort {
+public:
+  RS485SerialPort(HardwareSerial &serial, int directionPin)
+    : _serial(serial), _directionPin(directionPin) {}
+
+  size_t write(const uint8_t *data, size_t length) override {
+    return _serial.write(data, length);
+  }
+
+  int available() override { return _serial.available(); }
+
+  int read() override { return _serial.read(); }
+
+  void setTransmit(bool transmit) override {
+    // Only modules with a DE/RE pin need explicit direction control
+    if (_directionPin >= 0) {
+      digitalWrite(_directionPin, transmit ? HIGH : LOW);
+    }
+  }
+
+private:
+  HardwareSerial &_serial;
+  int _directionPin;
+};
+
+// RS485 port, non-blocking Modbus transaction engine and bus scheduler
+RS485SerialPort sensorPort(Serial2, RS485_DE_PIN);
+ModbusTransaction sensorTransaction;
+ModbusBusScheduler sensorBus;
+ModbusFrameDecoder sensorFrameDecoder;  // Recovers replies among stray bytes
+ModbusRetryPolicy sensorHealth;         // Fast retries, backoff, offline parking
+
+// Per-sensor line speed negotiation; the rates sensors settle on are kept
+// in NVS so a reboot starts at the right one instead of scanning
+const uint32_t sensorBaudRates[] = SENSOR_BAUD_RATES;
+ModbusBaudNegotiator sensorBaud;
+Preferences sensorSettings;
+uint32_t sensorLineBaud = SENSOR_BAUD_RATE;  // Current Serial2 speed
+
+// XY-MD02 register map
+#define XYMD02_REG_TEMPERATURE   0x0001  // Input, 0.1 °C signed
+#define XYMD02_REG_HUMIDITY      0x0002  // Input, 0.1 %RH
+#define XYMD02_REG_ADDRESS       0x0101  // Holding, Modbus address
+#define XYMD02_REG_BAUD          0x0102  // Holding, 0 = 9600, 1 = 14400, 2 = 19200
+#define XYMD02_REG_TEMP_CORR     0x0103  // Holding, 0.1 °C offset
+#define XYMD02_REG_HUM_CORR      0x0104  // Holding, 0.1 %RH offset
+
+// Read plans: measurements every poll, configuration once per sensor
+ModbusReadPlanner measurementPlan;
+ModbusReadPlanner configurationPlan;
+
+// Gateway register block of each sensor (see GATEWAY_ENABLED)
+enum GatewayRegister : uint8_t {
+  GATEWAY_REG_TEMPERATURE,       // 0.1 °C signed
+  GATEWAY_REG_HUMIDITY,          // 0.1 %RH
+  GATEWAY_REG_DEW_POINT,         // 0.1 °C signed
+  GATEWAY_REG_HEAT_INDEX,        // 0.1 °C signed
+  GATEWAY_REG_ABSOLUTE_HUMIDITY, // 0.1 g/m³
+  GATEWAY_REG_STATUS,            // GATEWAY_STATUS_* bits
+  GATEWAY_REG_ADDRESS,           // Sensor's address on the sensor bus
+  GATEWAY_REG_AGE,               // Seconds since the reading, 0xFFFF if none
+  GATEWAY_SENSOR_REGISTERS
+};
+#define GATEWAY_STATUS_CONNECTED  0x0001
+#define GATEWAY_STATUS_ALERT      0x0002  // A comfort rule is active
+#define GATEWAY_AGE_UNKNOWN       0xFFFF
+
+// Modbus slave port towards the PLC
+RS485SerialPort gatewayPort(Serial1, GATEWAY_DE_PIN);
+ModbusSlave gatewaySlave;
+
 // ==================== GLOBAL VARIABLES ====================
-// Sensor data storage
-float temperature = 0.0;        // Current temperature reading in Celsius
-float humidity = 0.0;           // Current humidity reading in percentage
-bool sensorConnected = false;   // Flag indicating sensor connection status
+// Sensor data storage (one entry per configured sensor address)
+struct SensorSample {
+  int16_t temperature;   // Current temperature in 0.1 °C (signed)
+  int16_t humidity;      // Current relative humidity in 0.1 %
+  uint32_t timestampMs;  // millis() of the last valid reading
+  uint32_t intervalMs;   // Time until the next reading is due
+  PsychroMetrics derived; // Dew point, heat index, absolute humidity
+  uint32_t activeRules;  // Comfort rules in force (RuleEngine mask)
+  ModbusHealthState health; // Link state from the retry policy
+};
+
+// Comfort thresholds in deci-units, matching the sensor's native resolution
+constexpr int16_t TEMP_MIN_DECI = toDeci(TEMP_MIN);
+constexpr int16_t TEMP_MAX_DECI = toDeci(TEMP_MAX);
+constexpr int16_t HUMIDITY_MIN_DECI = toDeci(HUMIDITY_MIN);
+constexpr int16_t HUMIDITY_MAX_DECI = toDeci(HUMIDITY_MAX);
+constexpr int16_t DEW_POINT_MAX_DECI = toDeci(DEW_POINT_MAX);
+
+// Comfort rules in display priority order: the first active one is
+// shown. Each applies to every sensor unless it names an address, e.g.
+// {0x02, RULE_TEMPERATURE, RULE_ABOVE, toDeci(22.0), ...} for a bedroom
+const RuleDefinition comfortRuleTable[] = {
+  {RULE_ANY_SENSOR, RULE_TEMPERATURE, RULE_BELOW, TEMP_MIN_DECI,
+   toDeci(COMFORT_HYSTERESIS_TEMP), COMFORT_MIN_DURATION, "TOO COLD"},
+  {RULE_ANY_SENSOR, RULE_TEMPERATURE, RULE_ABOVE, TEMP_MAX_DECI,
+   toDeci(COMFORT_HYSTERESIS_TEMP), COMFORT_MIN_DURATION, "TOO HOT"},
+  {RULE_ANY_SENSOR, RULE_HEAT_INDEX, RULE_ABOVE, TEMP_MAX_DECI,
+   toDeci(COMFORT_HYSTERESIS_TEMP), COMFORT_MIN_DURATION, "TOO HOT"},
+  {RULE_ANY_SENSOR, RULE_HUMIDITY, RULE_BELOW, HUMIDITY_MIN_DECI,
+   toDeci(COMFORT_HYSTERESIS_HUMIDITY), COMFORT_MIN_DURATION, "TOO DRY"},
+  {RULE_ANY_SENSOR, RULE_HUMIDITY, RULE_ABOVE, HUMIDITY_MAX_DECI,
+   toDeci(COMFORT_HYSTERESIS_HUMIDITY), COMFORT_MIN_DURATION, "TOO HUMID"},
+  {RULE_ANY_SENSOR, RULE_DEW_POINT, RULE_ABOVE, DEW_POINT_MAX_DECI,
+   toDeci(COMFORT_HYSTERESIS_TEMP), COMFORT_MIN_DURATION, "MUGGY"},
+};
+
+// Width of one character of the built-in 5x7 font at text size 1
+#define FONT_CHAR_WIDTH  6
+
+const uint8_t sensorAddresses[] = SENSOR_ADDRESSES;
+const size_t SENSOR_COUNT = sizeof(sensorAddresses) / sizeof(sensorAddresses[0]);
+
+// Device configuration read from the holding registers
+struct SensorConfiguration {
+  bool known;                    // Holding registers read (or unsupported)
+  uint16_t address;
+  uint16_t baudCode;
+  int16_t temperatureCorrection; // 0.1 °C
+  int16_t humidityCorrection;    // 0.1 %RH
+};
+
+// Filter pipeline for one channel of one sensor; the chain links the
+// stages enabled in FILTER_STAGES
+struct SensorFilter {
+  int16_t raw;                   // Latest decoded reading, before filtering
+  SpikeRejector spike;
+  SlidingMedian<FILTER_MEDIAN_WINDOW> median;
+  EmaFilter ema;
+  KalmanFilter kalman;
+  FilterChain chain;
+};
 
-// Timing control variables
-unsigned long lastSensorRead = 0;      // Timestamp of last sensor reading
-unsigned long lastDisplayUpdate = 0;   // Timestamp of last display update
+// Owned by the acquisition task
+SensorSample sensorSamples[SENSOR_COUNT] = {};
+SensorConfiguration sensorConfigurations[SENSOR_COUNT] = {};
+uint8_t sensorNextFrame[SENSOR_COUNT] = {};  // Position within the active plan
+AdaptiveSampler sensorSamplers[SENSOR_COUNT];  // Change-driven poll intervals
+SensorFilter temperatureFilters[SENSOR_COUNT];
+SensorFilter humidityFilters[SENSOR_COUNT];
+RuleEngine comfortRules;       // Evaluated per sample, masks published
+uint32_t sensorRejectedReadings[SENSOR_COUNT] = {};  // Dropped by the filters
+int activeSensor = -1;         // Sensor with a transaction in flight
+const ModbusReadPlanner *activePlan = nullptr;
+uint8_t activeBaudWrite[8];    // Rate write in flight, compared with the echo
+bool activeIsBaudWrite = false;
+uint8_t activeFunction = 0;    // Function code of the request in flight
+size_t activeReplyLength = 0;  // Length of its normal (non-exception) reply
+
+// Published by the acquisition task, read by the render task
+SeqLock<SensorSample> sensorSnapshots[SENSOR_COUNT];
+
+// Gateway register image, written by the acquisition task with each
+// snapshot and copied out by the gateway task for every request
+struct GatewayBlock {
+  uint16_t registers[GATEWAY_SENSOR_REGISTERS];
+  uint32_t timestampMs;          // Of the reading, for GATEWAY_REG_AGE
+  bool hasReading;
+};
+SeqLock<GatewayBlock> gatewayImage[SENSOR_COUNT];
+
+/**
+ * Serves gateway reads from the register image; holding and input
+ * registers are the same image
+ */
+class GatewayRegisterMap : public ModbusRegisterMap {
+public:
+  uint8_t readRegisters(uint8_t function, uint16_t start, uint16_t count,
+                        uint16_t *values) override {
+    (void)function;
+    uint32_t end = (uint32_t)start + count;
+    if (end > SENSOR_COUNT * GATEWAY_SENSOR_REGISTERS) {
+      return MODBUS_EXCEPTION_ILLEGAL_ADDRESS;
+    }
+    
+    uint32_t nowMs = millis();
+    size_t sensor = SENSOR_COUNT;  // No block copied yet
+    GatewayBlock block;
+    for (uint32_t reg = start; reg < end; reg++) {
+      if (reg / GATEWAY_SENSOR_REGISTERS != sensor) {
+        sensor = reg / GATEWAY_SENSOR_REGISTERS;
+        block = gatewayImage[sensor].read();
+        uint32_t ageS = (nowMs - block.timestampMs) / 1000;
+        block.registers[GATEWAY_REG_AGE] = !block.hasReading ?
+          GATEWAY_AGE_UNKNOWN :
+          (uint16_t)(ageS < GATEWAY_AGE_UNKNOWN ? ageS : GATEWAY_AGE_UNKNOWN - 1);
+      }
+      *values++ = block.registers[reg % GATEWAY_SENSOR_REGISTERS];
+    }
+    return 0;
+  }
+};
+GatewayRegisterMap gatewayRegisters;
+
+// Per-sensor raw/minute/hour history, written by the acquisition task
+typedef SampleHistory<HISTORY_RAW_BYTES, HISTORY_MINUTE_SLOTS,
+                      HISTORY_HOUR_SLOTS> SensorHistory;
+SensorHistory sensorHistory[SENSOR_COUNT];
+SemaphoreHandle_t historyMutex = nullptr;
+static_assert(sizeof(sensorHistory) <= HISTORY_MEMORY_BUDGET,
+              "Sensor history exceeds HISTORY_MEMORY_BUDGET; "
+              "reduce HISTORY_* sizes or the number of sensors");
+
+// Samples handed from the acquisition task to the storage task
+struct LoggedSample {
+  uint32_t timestampMs;
+  uint8_t address;
+  int16_t temperature;
+  int16_t humidity;
+};
+// Published by the storage task once the log is mounted; stays null (and
+// samples are not queued) while mounting or if there is no log partition
+std::atomic<QueueHandle_t> sampleLogQueue(nullptr);
+MetricCounter sampleLogDrops;          // Samples lost because the queue was full
+
+// Persistent flash log, owned by the storage task
+PartitionBlockDevice sampleLogFlash;
+SampleLog sampleLog;
+
+// Boot timing: millis() of the first valid reading, written once by the
+// acquisition task (0 until then)
+std::atomic<uint32_t> firstReadingMs(0);
+
+// Owned by the render task
+bool displayPresent = false;           // SSD1306 answered; false = headless
+size_t displayedSensor = 0;            // Sensor currently shown on the OLED
+bool staticLayoutDrawn = false;        // Header is already in the framebuffer
+
+// Display flush statistics (render task)
+uint32_t flushFrames = 0;              // Frames flushed since last report
+uint32_t flushBytesTotal = 0;          // I2C bytes sent since last report
+uint32_t flushTimeTotalUs = 0;         // Flush time since last report
+uint32_t flushTimeMaxUs = 0;           // Slowest flush since last report
+
+// Runtime metrics since boot or the last "metrics reset", updated
+// lock-free where the events happen and read by reportMetrics()
+MetricCounter busTransactions;         // Modbus requests answered or timed out
+MetricCounter busTimeouts;
+MetricCounter busCrcErrors;
+MetricCounter busExceptions;
+MetricCounter busPartialFrames;        // Replies too short or of the wrong length
+MetricCounter busResyncs;              // Replies recovered from among stray bytes
+LatencyHistogram busResponseTime;      // End of request to end of reply
+LatencyHistogram displayFlushTime;     // Incremental display flush
+LatencyHistogram pollJitter;           // Poll job start past its deadline
+LatencyHistogram refreshJitter;        // Display refresh start past its deadline
+LatencyHistogram gatewayAnswerTime;    // End of a gateway request to its reply
+MetricCounter gatewayRequests;         // Copied from gatewaySlave.stats()
+MetricCounter gatewayExceptions;       // by the gateway task after each poll
+MetricCounter gatewayCrcErrors;
+MetricCounter gatewayIgnored;
+ModbusSlaveStats gatewayStatsCopied = {}; // Gateway task: stats at last copy
+
+// Per-sensor link counters for /health and the metrics report, kept by
+// the acquisition task next to the single-threaded scheduler, baud
+// negotiator and retry policy
+struct SensorLinkMetrics {
+  MetricCounter successes;
+  MetricCounter failures;
+  std::atomic<uint32_t> baudRate;
+  std::atomic<uint32_t> fastRetries;   // Copied from sensorHealth
+  std::atomic<uint32_t> trips;
+};
+SensorLinkMetrics sensorLinkMetrics[SENSOR_COUNT];
+
+// Binary telemetry: records queued by the acquisition task are framed
+// in batches by the log task, which owns the serial console
+MpscRing<TelemetryRecord, TELEMETRY_QUEUE_LENGTH> telemetryQueue;
+TelemetryEncoder telemetryEncoder;
+std::atomic<bool> telemetryBinary(TELEMETRY_BINARY);
+bool telemetrySynced = false;          // Delimiter sent since entering binary mode
+MetricCounter telemetryDrops;          // Records lost because the queue was full
+
+// HTTP status documents, serialized by the HTTP task when the acquisition
+// task has published something new and served from the cache to every hit
+HttpStatusServer statusServer;
+HttpResponseCache statusDocument;      // /status
+HttpResponseCache historyDocument;     // /history
+HttpResponseCache healthDocument;      // /health
+std::atomic<uint32_t> sampleVersion(0); // Bumped by publishSample()
+uint32_t statusVersion = 0;            // Sample version in statusDocument
+uint32_t historyVersion = 0;           // Sample version in historyDocument
+uint32_t healthRefreshMs = 0;          // millis() of the last health document
+
+// MQTT publishing: the acquisition task queues records, the MQTT task
+// batches them every MQTT_PUBLISH_INTERVAL into the store-and-forward
+// outbox and publishes its oldest batch whenever the broker is ready
+#define MQTT_PAYLOAD_MAX  (4 * TELEMETRY_MAX_FRAME)
+bool mqttActive = false;               // Set once in setup()
+MpscRing<TelemetryRecord, MQTT_QUEUE_LENGTH> mqttSamples;
+MetricCounter mqttRecords;             // Records queued for MQTT
+MetricCounter mqttSampleDrops;         // Lost because mqttSamples was full
+TelemetryEncoder mqttEncoder;
+uint8_t mqttOutboxStorage[MQTT_OUTBOX_BYTES];
+MqttOutbox mqttOutbox(mqttOutboxStorage, sizeof(mqttOutboxStorage));
+MqttClient mqttClient;
+uint32_t mqttBatchMs = 0;              // millis() of the last batch
+uint32_t mqttPublishMs = 0;            // millis() of the last publish
+uint32_t mqttDropsAtPublish = 0;       // Outbox drops when it was sent
+
+// Copies of the MQTT task's state for the log and HTTP tasks, updated by
+// drainMqttOutbox(); the outbox and client are single-threaded
+MetricCounter mqttBatchesSent;         // Acknowledged by the broker
+std::atomic<uint32_t> mqttBatchesQueued(0);
+std::atomic<uint32_t> mqttBatchesDropped(0);
+std::atomic<uint32_t> mqttConnects(0);
+std::atomic<bool> mqttConnected(false);
+
+// Serial console line being typed, owned by the log task
+#define SERIAL_COMMAND_LENGTH  32
+char serialCommand[SERIAL_COMMAND_LENGTH];
+size_t serialCommandLength = 0;
+
+// Deadline schedulers: each task sleeps exactly until its next job is due
+DeadlineScheduler acquisitionJobs;     // Owned by the acquisition task
+DeadlineScheduler renderJobs;          // Owned by the render task
+int sensorPollJob = -1;                // Parked while a transaction is in flight
+int displayUpdateJob = -1;
+uint32_t acquisitionWakeups = 0;       // Acquisition passes since last report
+
+#ifdef LIGHT_SLEEP_SUPPORTED
+esp_pm_lock_handle_t busAwakeLock = nullptr; // Held while the bus is active
+#endif
+
+// Task handles
+TaskHandle_t acquisitionTaskHandle = nullptr;
+TaskHandle_t renderTaskHandle = nullptr;
+TaskHandle_t storageTaskHandle = nullptr;
+TaskHandle_t logTaskHandle = nullptr;
+TaskHandle_t gatewayTaskHandle = nullptr;
+TaskHandle_t httpTaskHandle = nullptr;
+TaskHandle_t mqttTaskHandle = nullptr;
 
 // ==================== MAIN SETUP FUNCTION ====================
 /**
@@ -62,409 +525,1945 @@ void setup() {
   Serial.println("Initializing system components...");
   Serial.println("==========================================");
   
-  // Initialize all hardware components
+  // Runtime messages are queued and printed by the log task
+  Logger::begin([]() { return (uint32_t)millis(); });
+  
+  // History is shared between the acquisition task and readers
+  historyMutex = xSemaphoreCreateMutex();
+  
+  // Everything the acquisition task touches is set up first, so the
+  // first sensor transaction goes out while the slower peripherals
+  // (display, WiFi) are still initializing
   initializeRS485Communication();
-  initializeOLEDDisplay();
+  initializeSchedules();
+  configureLightSleep();
+  initializeModbusGateway();
+  initializeMqtt();
+  
+  // Sensor polling and display rendering run on separate cores so a slow
+  // I2C flush never delays a sensor transaction and vice versa
+  xTaskCreatePinnedToCore(acquisitionTask, "acquisition",
+                          ACQUISITION_TASK_STACK, nullptr,
+                          ACQUISITION_TASK_PRIORITY, &acquisitionTaskHandle,
+                          ACQUISITION_TASK_CORE);
+  
+  displayPresent = initializeOLEDDisplay();
+  initializeWiFi();
+  initializeStatusServer();
+  
+  if (displayPresent) {
+    xTaskCreatePinnedToCore(renderTask, "render", RENDER_TASK_STACK, nullptr,
+                            RENDER_TASK_PRIORITY, &renderTaskHandle,
+                            RENDER_TASK_CORE);
+  }
+  xTaskCreatePinnedToCore(storageTask, "storage", STORAGE_TASK_STACK, nullptr,
+                          STORAGE_TASK_PRIORITY, &storageTaskHandle,
+                          STORAGE_TASK_CORE);
+  xTaskCreatePinnedToCore(logTask, "log", LOG_TASK_STACK, nullptr,
+                          LOG_TASK_PRIORITY, &logTaskHandle, LOG_TASK_CORE);
+  if (GATEWAY_ENABLED) {
+    xTaskCreatePinnedToCore(gatewayTask, "gateway", GATEWAY_TASK_STACK,
+                            nullptr, GATEWAY_TASK_PRIORITY, &gatewayTaskHandle,
+                            GATEWAY_TASK_CORE);
+  }
+  if (statusServer.listening()) {
+    xTaskCreatePinnedToCore(httpTask, "http", HTTP_TASK_STACK, nullptr,
+                            HTTP_TASK_PRIORITY, &httpTaskHandle,
+                            HTTP_TASK_CORE);
+  }
+  if (mqttActive) {
+    xTaskCreatePinnedToCore(mqttTask, "mqtt", MQTT_TASK_STACK, nullptr,
+                            MQTT_TASK_PRIORITY, &mqttTaskHandle,
+                            MQTT_TASK_CORE);
+  }
   
   Serial.println("System initialization complete!");
-  Serial.println("Starting monitoring loop...");
+  Serial.println("Starting monitoring tasks...");
 }
 
 // ==================== MAIN LOOP FUNCTION ====================
 /**
- * Main execution loop - handles sensor reading and display updates
+ * All work happens in the acquisition and render tasks
  */
 void loop() {
-  unsigned long currentTime = millis();
-  
-  // Read sensor data at specified intervals
-  if (currentTime - lastSensorRead >= SENSOR_READ_INTERVAL) {
-    readXYMD02Sensor();
-    lastSensorRead = currentTime;
-  }
-  
-  // Update display at specified intervals
-  if (currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
-    updateDisplay();
-    lastDisplayUpdate = currentTime;
-  }
-  
-  // Small delay to prevent excessive CPU usage
-  delay(100);
+  vTaskDelete(nullptr);
 }
 
-// ==================== HARDWARE INITIALIZATION ====================
+// ==================== TASKS ====================
 
 /**
- * Initialize RS485 communication interface
- * Configures Serial2 for communication with XY-MD02 sensor
+ * Sensor acquisition task
+ * Starts and advances Modbus transactions; woken early by UART RX activity
  */
-void initializeRS485Communication() {
-  Serial.println("Initializing RS485 communication...");
-  
-  // Configure Serial2 for RS485 communication
-  Serial2.begin(SENSOR_BAUD_RATE, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
-  
-  // Configure direction control pin if defined
-  if (RS485_DE_PIN >= 0) {
-    pinMode(RS485_DE_PIN, OUTPUT);
-    digitalWrite(RS485_DE_PIN, LOW); // Set to receive mode initially
-    Serial.println("RS485 initialized with manual direction control");
-  } else {
-    Serial.println("RS485 initialized with automatic direction control");
+void acquisitionTask(void *parameter) {
+  for (;;) {
+    // Sleep until a byte arrives or the next job deadline
+    ulTaskNotifyTake(pdTRUE, acquisitionCycle());
   }
 }
 
 /**
- * Initialize OLED display
- * Sets up I2C communication and display parameters
+ * One pass of the acquisition task (also driven directly by the native
+ * simulator)
+ * 
+ * @return Ticks to wait before the next pass unless woken by UART RX
  */
-void initializeOLEDDisplay() {
-  Serial.println("Initializing OLED display...");
+TickType_t acquisitionCycle() {
+  acquisitionWakeups++;
   
-  // Initialize I2C communication for OLED
-  Wire.begin(OLED_SDA_PIN, OLED_SCL_PIN);
-  
-  // Initialize OLED display driver
-  if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-    Serial.println(F("ERROR: SSD1306 display allocation failed!"));
-    Serial.println(F("Check wiring and I2C address"));
-    for(;;); // Stop execution if display initialization fails
+  // Advance any in-flight sensor transaction without blocking; once it
+  // ends the bus schedule has changed, so re-arm the poll job
+  if (serviceSensorTransaction()) {
+    scheduleNextPoll();
   }
   
-  // Display startup message
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 0);
-  display.println(F("Room Climate Monitor"));
-  display.println(F("v1.0"));
-  display.println();
-  display.println(F("Initializing..."));
-  display.println(F("Starting sensors..."));
-  display.display();
+  // Start the next poll (and any other job) whose deadline has passed
+  if (!sensorTransaction.busy()) {
+    acquisitionJobs.runDue(micros());
+  }
   
-  Serial.println("OLED display initialized successfully");
-  delay(2000); // Show startup message
+  // While a transaction is in flight, sleep until it can next end (TX
+  // done, end-of-frame silence, timeout); Serial2.onReceive() wakes the
+  // task for reply bytes in between
+  uint32_t nowUs = micros();
+  uint32_t waitUs = acquisitionJobs.timeUntilNextUs(nowUs);
+  if (sensorTransaction.busy()) {
+    uint32_t transactionUs = sensorTransaction.timeUntilEventUs(nowUs);
+    waitUs = transactionUs < waitUs ? transactionUs : waitUs;
+  }
+  return ticksUntil(waitUs);
 }
 
-// ==================== SENSOR COMMUNICATION ====================
+/**
+ * Acquisition job: poll the sensor that is due
+ * Stays parked while the transaction runs; re-armed right away if the
+ * bus was not free after all
+ */
+void pollSensorJob() {
+  pollJitter.record(
+    acquisitionJobs.stats(sensorPollJob).lastLatenessUs);
+  readXYMD02Sensor();
+  if (!sensorTransaction.busy()) {
+    scheduleNextPoll();
+  }
+}
 
 /**
- * Read temperature and humidity data from XY-MD02 sensor
- * Uses Modbus RTU protocol over RS485
- * Function Code: 0x04 (Read Input Registers)
- * Register Address: 0x0001
- * Quantity: 2 registers (temperature + humidity)
+ * Set the poll job's deadline to when the bus scheduler next has a
+ * sensor due
  */
-void readXYMD02Sensor() {
-  // Prepare Modbus RTU command for XY-MD02
-  // Format: [DeviceID][Function][RegAddr_Hi][RegAddr_Lo][Quantity_Hi][Quantity_Lo][CRC_Lo][CRC_Hi]
-  uint8_t command[8] = {
-    SENSOR_ADDRESS,  // Device address (0x01)
-    0x04,           // Function code: Read Input Registers
-    0x00,           // Register address high byte (0x0001)
-    0x01,           // Register address low byte
-    0x00,           // Quantity high byte (2 registers)
-    0x02,           // Quantity low byte
-    0x00,           // CRC low byte (calculated below)
-    0x00            // CRC high byte (calculated below)
-  };
-  
-  // Calculate and append CRC for message integrity
-  uint16_t crc = calculateCRC(command, 6);
-  command[6] = crc & 0xFF;        // CRC low byte
-  command[7] = (crc >> 8) & 0xFF; // CRC high byte
-  
-  // Debug: Print command being sent
-  Serial.print("TX: ");
-  for (int i = 0; i < 8; i++) {
-    Serial.printf("%02X ", command[i]);
+void scheduleNextPoll() {
+  uint32_t nowUs = micros();
+  uint32_t waitUs = sensorBus.timeUntilDueUs(millis(), nowUs);
+  if (waitUs == UINT32_MAX) {
+    acquisitionJobs.cancel(sensorPollJob);
+  } else {
+    acquisitionJobs.reschedule(sensorPollJob, nowUs + waitUs);
   }
-  Serial.println();
-  
-  // Set RS485 to transmit mode (if direction control pin is configured)
-  if (RS485_DE_PIN >= 0) {
-    digitalWrite(RS485_DE_PIN, HIGH);
-    delay(1); // Small delay for signal stabilization
+}
+
+/**
+ * Acquisition job: report how promptly polls started and how often the
+ * task woke up
+ */
+void reportAcquisitionTiming() {
+  const DeadlineJobStats &poll = acquisitionJobs.stats(sensorPollJob);
+  LOG_INFO("Acquisition: %u wakeups, %u polls, late avg %u us, max %u us",
+           acquisitionWakeups, poll.runs,
+           poll.runs > 0 ? poll.totalLatenessUs / poll.runs : 0,
+           poll.maxLatenessUs);
+  acquisitionJobs.resetStats(sensorPollJob);
+  acquisitionWakeups = 0;
+}
+
+/**
+ * Convert a deadline distance to a task wait, rounding up to whole ticks
+ * so a task never wakes before its job is due
+ */
+TickType_t ticksUntil(uint32_t waitUs) {
+  if (waitUs == UINT32_MAX) {
+    return portMAX_DELAY;
   }
-  
-  // Transmit command to sensor
-  Serial2.write(command, sizeof(command));
-  Serial2.flush(); // Ensure all data is transmitted
-  
-  // Set RS485 to receive mode (if direction control pin is configured)
-  if (RS485_DE_PIN >= 0) {
-    digitalWrite(RS485_DE_PIN, LOW);
-    delay(1); // Small delay for signal stabilization
+  TickType_t ticks = pdMS_TO_TICKS((waitUs + 999) / 1000);
+  return ticks > 0 ? ticks : 1;
+}
+
+/**
+ * Display render task
+ * Redraws the OLED from the latest published sensor snapshots
+ */
+void renderTask(void *parameter) {
+  for (;;) {
+    vTaskDelay(renderCycle());
   }
-  
-  // Wait for response from sensor
-  // Expected response: 9 bytes total
-  // Format: [DeviceID][Function][ByteCount][Data1_Hi][Data1_Lo][Data2_Hi][Data2_Lo][CRC_Lo][CRC_Hi]
-  const uint8_t expectedResponseLength = 9;
-  unsigned long startTime = millis();
-  
-  while (Serial2.available() < expectedResponseLength && 
-         millis() - startTime < SENSOR_TIMEOUT) {
-    delay(1); // Small delay in polling loop
+}
+
+/**
+ * One pass of the render task (also driven directly by the native
+ * simulator): runs the display jobs that are due
+ * 
+ * @return Ticks to wait until the next display job
+ */
+TickType_t renderCycle() {
+  renderJobs.runDue(micros());
+  return ticksUntil(renderJobs.timeUntilNextUs(micros()));
+}
+
+/**
+ * Flash storage task
+ * Batches queued samples into the sample log and compacts it in the
+ * background, so flash erase/program stalls never hit acquisition timing
+ */
+void storageTask(void *parameter) {
+  if (!sampleLogFlash.begin(SAMPLE_LOG_PARTITION) ||
+      !sampleLog.mount(&sampleLogFlash)) {
+    LOG_WARN("Sample log partition unavailable, logging disabled");
+    vTaskDelete(nullptr);
+    return;
   }
+  QueueHandle_t queue = openSampleLogQueue();
   
-  Serial.printf("RX: %d bytes after %lu ms\n", 
-                Serial2.available(), millis() - startTime);
+  // There is no RTC: continue log time from where the previous boot stopped
+  uint32_t logBaseTime = sampleLog.nextTime();
+  LOG_INFO("Sample log mounted: %u segments used, %u free",
+           sampleLog.stats().segmentsUsed, sampleLog.stats().segmentsFree);
   
-  // Process received response
-  if (Serial2.available() >= expectedResponseLength) {
-    uint8_t response[expectedResponseLength];
-    Serial2.readBytes(response, expectedResponseLength);
-    
-    // Debug: Print received response
-    Serial.print("RX: ");
-    for (int i = 0; i < expectedResponseLength; i++) {
-      Serial.printf("%02X ", response[i]);
+  // Seconds since boot, accumulated from unsigned millis() deltas so log
+  // time keeps increasing across the 49.7-day millis() wrap. Idle wake-ups
+  // advance it too, so a long gap between samples cannot alias
+  uint32_t logSeconds = 0;
+  uint32_t logClockMs = 0;
+  uint32_t logRemainderMs = 0;
+  auto advanceLogClock = [&](uint32_t nowMs) {
+    int32_t elapsedMs = (int32_t)(nowMs - logClockMs);
+    if (elapsedMs <= 0) {
+      return; // Sample stamped just before an idle advance
     }
-    Serial.println();
-    
-    // Validate and parse response
-    if (validateModbusResponse(response, expectedResponseLength)) {
-      // Parse temperature data (registers are 16-bit big-endian, scaled by 10)
-      uint16_t tempRaw = (response[3] << 8) | response[4];
-      temperature = tempRaw / 10.0;
-      
-      // Parse humidity data (registers are 16-bit big-endian, scaled by 10)
-      uint16_t humRaw = (response[5] << 8) | response[6];
-      humidity = humRaw / 10.0;
-      
-      sensorConnected = true;
-      
-      Serial.printf("SUCCESS! Temperature: %.1f°C, Humidity: %.1f%%\n", 
-                   temperature, humidity);
+    logClockMs = nowMs;
+    logRemainderMs += (uint32_t)elapsedMs;
+    logSeconds += logRemainderMs / 1000;
+    logRemainderMs %= 1000;
+  };
+  
+  unsigned long lastLogFlush = millis();
+  for (;;) {
+    LoggedSample sample;
+    if (xQueueReceive(queue, &sample,
+                      pdMS_TO_TICKS(SAMPLE_LOG_FLUSH_INTERVAL)) == pdTRUE) {
+      advanceLogClock(sample.timestampMs);
+      sampleLog.append(logBaseTime + logSeconds, sample.address,
+                       sample.temperature, sample.humidity);
     } else {
-      sensorConnected = false;
-      Serial.println("ERROR: Invalid sensor response");
+      advanceLogClock(millis());
     }
-  } else if (Serial2.available() > 0) {
-    // Handle partial or error responses
-    uint8_t partialResponse[20];
-    int bytesRead = Serial2.readBytes(partialResponse, Serial2.available());
     
-    Serial.print("Partial response: ");
-    for (int i = 0; i < bytesRead; i++) {
-      Serial.printf("%02X ", partialResponse[i]);
+    // A partial batch is written at least once per flush interval so at
+    // most that much data is lost on power failure
+    if (millis() - lastLogFlush >= SAMPLE_LOG_FLUSH_INTERVAL) {
+      sampleLog.flush();
+      sampleLog.maintain();
+      lastLogFlush = millis();
     }
-    Serial.println();
-    
-    // Check for Modbus exception response
-    if (bytesRead >= 3 && partialResponse[1] & 0x80) {
-      Serial.printf("Modbus Exception - Function: %02X, Code: %02X\n", 
-                   partialResponse[1] & 0x7F, partialResponse[2]);
-    }
-    sensorConnected = false;
-  } else {
-    Serial.println("ERROR: No response from XY-MD02 sensor (timeout)");
-    sensorConnected = false;
   }
-  
-  // Clear any remaining bytes in receive buffer
-  clearSerialBuffer();
 }
 
-// ==================== DISPLAY FUNCTIONS ====================
+/**
+ * Create the sample queue and let the acquisition task start using it
+ * Only called once the log is known to work, so a missing partition
+ * never leaves an allocated queue behind
+ */
+QueueHandle_t openSampleLogQueue() {
+  QueueHandle_t queue = xQueueCreate(SAMPLE_LOG_QUEUE_LENGTH,
+                                     sizeof(LoggedSample));
+  sampleLogQueue.store(queue, std::memory_order_release);
+  return queue;
+}
 
 /**
- * Main display update function
- * Orchestrates the complete display update cycle
+ * Log drain task
+ * Formats queued log records and writes them to the serial console;
+ * lowest priority, so UART output only uses otherwise idle time
  */
-void updateDisplay() {
-  display.clearDisplay();
-  
-  // Display title header
-  display.setTextSize(2);
-  display.setCursor(0, 0);
-  display.println(F("ROOM"));
-  display.println(F("MONITOR"));
-  
-  // Reset text size for data display
-  display.setTextSize(1);
-  
-  // Display appropriate content based on sensor status
-  if (sensorConnected) {
-    displaySensorData();
-    displayComfortStatus();
-  } else {
-    displayErrorMessage();
+void logTask(void *parameter) {
+  for (;;) {
+    logCycle();
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
   }
-  
-  // Always show system uptime
-  displayUptime();
-  
-  // Update the physical display
-  display.display();
 }
 
 /**
- * Display current sensor readings with warning indicators
+ * One pass of the log task (also driven directly by the native
+ * simulator): handle console input, then print the queued log lines,
+ * or in binary mode frame them together with the telemetry batch
  */
-void displaySensorData() {
-  // Display temperature with out-of-range warning
-  display.setCursor(0, 32);
-  display.printf("Temp: %.1f C", temperature);
-  if (temperature < TEMP_MIN || temperature > TEMP_MAX) {
-    display.print(" !"); // Warning indicator for temperature
+void logCycle() {
+  pollSerialCommands();
+  if (!telemetryBinary.load(std::memory_order_relaxed)) {
+    telemetrySynced = false;
+    Logger::drain([](const char *line, size_t length) {
+      Serial.write((const uint8_t *)line, length);
+      Serial.println();
+    }, LOG_RING_RECORDS);
+    return;
   }
   
-  // Display humidity with out-of-range warning
-  display.setCursor(0, 42);
-  display.printf("Humidity: %.1f%%", humidity);
-  if (humidity < HUMIDITY_MIN || humidity > HUMIDITY_MAX) {
-    display.print(" !"); // Warning indicator for humidity
+  // Terminate whatever text preceded the first frame
+  if (!telemetrySynced) {
+    Serial.write((uint8_t)0);
+    telemetrySynced = true;
   }
+  Logger::drain(writeLogFrame, LOG_RING_RECORDS, TELEMETRY_LOG_LEVEL);
+  flushTelemetry();
 }
 
 /**
- * Display error message when sensor is not connected
+ * Modbus gateway task
+ * Answers PLC requests from the register image; woken by the UART driver
+ * when a request has gone quiet, so it costs nothing between requests
  */
-void displayErrorMessage() {
-  display.setCursor(0, 35);
-  display.println("Sensor Error!");
-  display.setCursor(0, 45);
-  display.println("Check Connection");
+void gatewayTask(void *parameter) {
+  TickType_t wait = portMAX_DELAY;
+  for (;;) {
+    bool lineIdle = ulTaskNotifyTake(pdTRUE, wait) > 0;
+    wait = gatewayCycle(lineIdle);
+  }
 }
 
 /**
- * Display comfort status based on temperature and humidity ranges
+ * One pass of the gateway task (also driven directly by the native
+ * simulator)
+ * 
+ * @param lineIdle Woken by the UART RX timeout: the request has ended
+ * @return Ticks to wait unless woken by the next request
  */
-void displayComfortStatus() {
-  display.setCursor(0, 52);
+TickType_t gatewayCycle(bool lineIdle) {
+  uint32_t startUs = micros();
+  if (gatewaySlave.poll(startUs, lineIdle)) {
+    gatewayAnswerTime.record(gatewaySlave.lastAnswerDelayUs() +
+                             (micros() - startUs));
+  }
   
-  // Determine comfort status based on both temperature and humidity
-  bool tempOK = (temperature >= TEMP_MIN && temperature <= TEMP_MAX);
-  bool humidityOK = (humidity >= HUMIDITY_MIN && humidity <= HUMIDITY_MAX);
+  // The slave's own stats are single-threaded; hand on what changed
+  const ModbusSlaveStats &stats = gatewaySlave.stats();
+  gatewayRequests.increment(stats.requests - gatewayStatsCopied.requests);
+  gatewayExceptions.increment(stats.exceptions - gatewayStatsCopied.exceptions);
+  gatewayCrcErrors.increment(stats.crcErrors - gatewayStatsCopied.crcErrors);
+  gatewayIgnored.increment(stats.ignored - gatewayStatsCopied.ignored);
+  gatewayStatsCopied = stats;
   
-  if (tempOK && humidityOK) {
-    display.println("Status: COMFORT");
-  } else {
-    // Prioritize temperature issues over humidity issues in display
-    if (temperature < TEMP_MIN) {
-      display.println("Status: TOO COLD");
-    } else if (temperature > TEMP_MAX) {
-      display.println("Status: TOO HOT");
-    } else if (humidity < HUMIDITY_MIN) {
-      display.println("Status: TOO DRY");
-    } else if (humidity > HUMIDITY_MAX) {
-      display.println("Status: TOO HUMID");
-    } else {
-      display.println("Status: CHECK");
-    }
+  // A partial request or an answer still on the wire: poll again soon
+  return gatewaySlave.busy() ? 1 : portMAX_DELAY;
+}
+
+/**
+ * HTTP status task
+ * Serves the status documents; waits in select() between requests
+ */
+void httpTask(void *parameter) {
+  for (;;) {
+    httpCycle(HTTP_POLL_INTERVAL_MS);
   }
 }
 
 /**
- * Display system uptime in top-right corner
+ * One pass of the HTTP task (also driven directly by the native
+ * simulator): re-serialize whatever changed, then serve clients for up
+ * to waitMs
  */
-void displayUptime() {
-  display.setTextSize(1);
-  
-  // Calculate uptime and format string
-  char uptimeStr[16];
-  unsigned long uptimeSeconds = millis() / 1000;
-  snprintf(uptimeStr, sizeof(uptimeStr), "Up: %lus", uptimeSeconds);
+void httpCycle(uint32_t waitMs) {
+  uint32_t version = sampleVersion.load(std::memory_order_acquire);
+  if (version != statusVersion &&
+      publishDocument(statusDocument, writeStatusJson)) {
+    statusVersion = version;
+  }
+  if (version != historyVersion &&
+      publishDocument(historyDocument, writeHistoryJson)) {
+    historyVersion = version;
+  }
   
-  // Calculate text bounds for right alignment
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(uptimeStr, 0, 0, &x1, &y1, &w, &h);
+  // Health counters change between samples; refresh them at a fixed rate
+  uint32_t nowMs = millis();
+  if ((!healthDocument.ready() ||
+       nowMs - healthRefreshMs >= HTTP_HEALTH_INTERVAL) &&
+      publishDocument(healthDocument, writeHealthJson)) {
+    healthRefreshMs = nowMs;
+  }
   
-  // Position text with 2px padding from right edge
-  display.setCursor(SCREEN_WIDTH - w - 2, 0);
-  display.print(uptimeStr);
+  statusServer.poll(nowMs, waitMs);
 }
 
-// ==================== UTILITY FUNCTIONS ====================
+/**
+ * MQTT task: sleeps between passes while the broker is unreachable,
+ * otherwise waits on the socket
+ */
+void mqttTask(void *parameter) {
+  for (;;) {
+    TickType_t delay = mqttCycle(MQTT_POLL_INTERVAL_MS);
+    if (delay > 0) {
+      vTaskDelay(delay);
+    }
+  }
+}
 
 /**
- * Validate Modbus RTU response from XY-MD02 sensor
- * 
- * @param response Pointer to response data array
- * @param expectedLength Expected length of valid response
- * @return true if response is valid, false otherwise
- */
-bool validateModbusResponse(uint8_t *response, uint8_t expectedLength) {
-  // Verify response length
-  if (expectedLength < 5) {
-    Serial.println("ERROR: Response too short for validation");
-    return false;
+ * One pass of the MQTT task (also driven directly by the native
+ * simulator): batch the queued records when the interval is up, advance
+ * the connection and publish the oldest batch if the broker is ready
+ *
+ * @return Ticks to sleep before the next pass
+ */
+TickType_t mqttCycle(uint32_t waitMs) {
+  uint32_t nowMs = millis();
+  if (nowMs - mqttBatchMs >= MQTT_PUBLISH_INTERVAL) {
+    mqttBatchMs = nowMs;
+    batchMqttSamples();
   }
   
-  // Verify device address and function code
-  // Expected format: [DeviceID][Function][ByteCount][Data...][CRC]
-  if (response[0] != SENSOR_ADDRESS) {
-    Serial.printf("ERROR: Wrong device address - Expected: %02X, Got: %02X\n", 
-                 SENSOR_ADDRESS, response[0]);
-    return false;
+  // While waiting out the reconnect delay there is no socket to wait on
+  bool idle = mqttClient.state() == MQTT_DISCONNECTED;
+  mqttClient.poll(nowMs, idle ? 0 : waitMs);
+  drainMqttOutbox(millis());
+  return mqttClient.state() == MQTT_DISCONNECTED ? pdMS_TO_TICKS(waitMs) : 0;
+}
+
+/**
+ * Encode the records queued since the last batch as telemetry frames
+ * and append them to the outbox as one payload (several if they do not
+ * fit MQTT_PAYLOAD_MAX)
+ */
+void batchMqttSamples() {
+  uint8_t payload[MQTT_PAYLOAD_MAX];
+  size_t length = 0;
+  TelemetryRecord record;
+  while (mqttSamples.pop(record)) {
+    if (mqttEncoder.add(record)) {
+      continue;
+    }
+    length += mqttEncoder.finish(payload + length);
+    if (length + TELEMETRY_MAX_FRAME > sizeof(payload)) {
+      mqttOutbox.push(payload, length);
+      length = 0;
+    }
+    mqttEncoder.add(record);
   }
-  
-  if (response[1] != 0x04) {
-    Serial.printf("ERROR: Wrong function code - Expected: 04, Got: %02X\n", 
-                 response[1]);
-    return false;
+  length += mqttEncoder.finish(payload + length);
+  if (length > 0) {
+    mqttOutbox.push(payload, length);
+  }
+}
+
+/**
+ * Retire the acknowledged batch and publish the next one, no faster than
+ * MQTT_DRAIN_RATE per second so a backlog does not flood the broker
+ */
+void drainMqttOutbox(uint32_t nowMs) {
+  if (mqttClient.takeAcknowledged()) {
+    // Unless the outbox already dropped it (oldest first) to make room
+    if (mqttOutbox.dropped() == mqttDropsAtPublish) {
+      mqttOutbox.pop();
+    }
+    mqttBatchesSent.increment();
   }
+  mqttBatchesQueued.store((uint32_t)mqttOutbox.count(),
+                          std::memory_order_relaxed);
+  mqttBatchesDropped.store(mqttOutbox.dropped(), std::memory_order_relaxed);
+  mqttConnects.store(mqttClient.stats().connects, std::memory_order_relaxed);
+  mqttConnected.store(mqttClient.connected(), std::memory_order_relaxed);
   
-  if (response[2] != 0x04) {
-    Serial.printf("ERROR: Wrong byte count - Expected: 04, Got: %02X\n", 
-                 response[2]);
-    return false;
+  if (!mqttClient.connected() || mqttClient.inFlight() ||
+      mqttOutbox.count() == 0 ||
+      nowMs - mqttPublishMs < 1000 / MQTT_DRAIN_RATE) {
+    return;
   }
+  uint8_t payload[MQTT_PAYLOAD_MAX];
+  size_t length = mqttOutbox.front(payload);
+  if (mqttClient.publish(MQTT_TOPIC, payload, length, nowMs)) {
+    mqttPublishMs = nowMs;
+    mqttDropsAtPublish = mqttOutbox.dropped();
+  }
+}
+
+// ==================== HARDWARE INITIALIZATION ====================
+
+/**
+ * Register the periodic and event-driven jobs of each task
+ * Page rotation is added before the display refresh so that, when both
+ * fall due together, the refresh already shows the new page
+ */
+void initializeSchedules() {
+  uint32_t nowUs = micros();
   
-  // Verify CRC integrity
-  uint16_t receivedCRC = response[expectedLength-2] | (response[expectedLength-1] << 8);
-  uint16_t calculatedCRC = calculateCRC(response, expectedLength - 2);
+  sensorPollJob = acquisitionJobs.add(pollSensorJob, 0, nowUs);
+  acquisitionJobs.add(reportAcquisitionTiming, TIMING_REPORT_INTERVAL * 1000UL,
+                      nowUs + TIMING_REPORT_INTERVAL * 1000UL);
   
-  if (receivedCRC != calculatedCRC) {
-    Serial.printf("ERROR: CRC mismatch - Received: %04X, Calculated: %04X\n", 
-                 receivedCRC, calculatedCRC);
-    return false;
+  if (SENSOR_COUNT > 1) {
+    renderJobs.add(rotateDisplayedSensor, DISPLAY_ROTATE_INTERVAL * 1000UL,
+                   nowUs + DISPLAY_ROTATE_INTERVAL * 1000UL);
   }
-  
-  return true;
+  displayUpdateJob = renderJobs.add(updateDisplay,
+                                    DISPLAY_UPDATE_INTERVAL * 1000UL, nowUs);
+  renderJobs.add(reportDisplayStats, DISPLAY_STATS_INTERVAL * 1000UL,
+                 nowUs + DISPLAY_STATS_INTERVAL * 1000UL);
 }
 
 /**
- * Clear all remaining bytes from Serial2 receive buffer
- * Prevents buffer overflow and ensures clean communication
+ * Let the idle task enter light sleep whenever no task is due
+ * Only when the SDK is built with power management and tickless idle.
+ * UART2 cannot wake the ESP32 (only UART0/1 on their IO_MUX pins can),
+ * so instead a PM lock keeps the chip awake while a Modbus transaction
+ * is on the wire; between transactions the sensors send nothing
  */
-void clearSerialBuffer() {
-  while (Serial2.available()) {
-    Serial2.read();
+void configureLightSleep() {
+#ifdef LIGHT_SLEEP_SUPPORTED
+  esp_pm_config_esp32_t pm = {};
+  pm.max_freq_mhz = getCpuFrequencyMhz();
+  pm.min_freq_mhz = pm.max_freq_mhz;  // No frequency scaling: UART timing
+  pm.light_sleep_enable = true;
+  if (esp_pm_configure(&pm) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "rs485",
+                         &busAwakeLock) != ESP_OK) {
+    Serial.println("Light sleep unavailable");
+    return;
   }
+  Serial.println("Light sleep enabled between deadlines");
+#else
+  Serial.println("Light sleep not supported by this build");
+#endif
 }
 
 /**
- * Calculate CRC-16 for Modbus RTU protocol
- * Uses polynomial 0xA001 (reversed representation of 0x8005)
- * 
- * @param data Pointer to data array for CRC calculation
- * @param length Number of bytes to include in CRC calculation
- * @return 16-bit CRC value
+ * Keep the chip out of light sleep for the duration of a transaction
  */
-uint16_t calculateCRC(uint8_t *data, uint8_t length) {
-  uint16_t crc = 0xFFFF; // Initialize CRC register
-  
-  // Process each byte in the data array
-  for (uint8_t i = 0; i < length; i++) {
-    crc ^= data[i]; // XOR byte with CRC register
-    
-    // Process each bit in the current byte
-    for (uint8_t j = 0; j < 8; j++) {
-      if (crc & 0x0001) {
-        // If LSB is 1, shift right and XOR with polynomial
-        crc = (crc >> 1) ^ 0xA001;
-      } else {
-        // If LSB is 0, just shift right
-        crc >>= 1;
-      }
+void holdBusAwake(bool hold) {
+#ifdef LIGHT_SLEEP_SUPPORTED
+  if (busAwakeLock != nullptr) {
+    if (hold) {
+      esp_pm_lock_acquire(busAwakeLock);
+    } else {
+      esp_pm_lock_release(busAwakeLock);
     }
   }
-  
-  return crc;
+#else
+  (void)hold;
+#endif
+}
+
+/**
+ * Initialize the Modbus slave interface towards the PLC on UART1
+ * A slave has to hear the first byte of every request, which a UART
+ * wake-up from light sleep would lose, so the bus lock is held for good
+ */
+void initializeModbusGateway() {
+  if (!GATEWAY_ENABLED) {
+    return;
+  }
+  
+  Serial1.begin(GATEWAY_BAUD_RATE, SERIAL_8N1, GATEWAY_RX_PIN, GATEWAY_TX_PIN);
+  if (GATEWAY_DE_PIN >= 0) {
+    pinMode(GATEWAY_DE_PIN, OUTPUT);
+    digitalWrite(GATEWAY_DE_PIN, LOW);
+  }
+  gatewaySlave.begin(&gatewayPort, GATEWAY_BAUD_RATE, GATEWAY_ADDRESS,
+                     &gatewayRegisters);
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    publishSample(i, sensorSamples[i]);  // Addresses before the first poll
+  }
+  
+  // Requests are far smaller than the RX FIFO threshold, so the callback
+  // only runs once the line has been idle for the timeout: end of frame
+  Serial1.setRxTimeout(GATEWAY_RX_TIMEOUT_SYMBOLS);
+  Serial1.onReceive([]() {
+    if (gatewayTaskHandle != nullptr) {
+      xTaskNotifyGive(gatewayTaskHandle);
+    }
+  }, true);
+  
+  holdBusAwake(true);
+  Serial.println("Modbus gateway listening on UART1");
+}
+
+/**
+ * Join WiFi in the background (HTTP and MQTT)
+ */
+void initializeWiFi() {
+  if (WIFI_SSID[0] == '\0') {
+    return;
+  }
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+}
+
+/**
+ * Start the HTTP status server
+ * The server listens from the start and becomes reachable once the
+ * station has an address
+ */
+void initializeStatusServer() {
+  if (!HTTP_ENABLED || (WIFI_SSID[0] == '\0' && !HTTP_BIND_LOOPBACK)) {
+    return;
+  }
+  
+  if (!statusServer.begin(HTTP_PORT, HTTP_BIND_LOOPBACK)) {
+    Serial.println("HTTP status server could not listen");
+    return;
+  }
+  statusServer.route("/status", &statusDocument);
+  statusServer.route("/history", &historyDocument);
+  statusServer.route("/health", &healthDocument);
+  Serial.printf("HTTP status server on port %u\n", statusServer.port());
+}
+
+/**
+ * Set up the MQTT publisher; the MQTT task connects and keeps retrying
+ * until the broker answers
+ */
+void initializeMqtt() {
+  if (!MQTT_ENABLED || MQTT_BROKER[0] == '\0') {
+    return;
+  }
+  if (!mqttClient.begin(MQTT_BROKER, MQTT_PORT, MQTT_CLIENT_ID,
+                        MQTT_KEEPALIVE, MQTT_RETRY_MIN, MQTT_RETRY_MAX)) {
+    Serial.println("MQTT broker must be an IPv4 address");
+    return;
+  }
+  mqttBatchMs = millis();
+  mqttActive = true;
+  Serial.printf("MQTT publishing to %s:%u\n", MQTT_BROKER, MQTT_PORT);
+}
+
+/**
+ * Initialize RS485 communication interface
+ * Configures Serial2 for communication with XY-MD02 sensor
+ */
+void initializeRS485Communication() {
+  Serial.println("Initializing RS485 communication...");
+  
+  // Configure Serial2 for RS485 communication
+  Serial2.begin(SENSOR_BAUD_RATE, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
+  
+  // Configure direction control pin if defined
+  if (RS485_DE_PIN >= 0) {
+    pinMode(RS485_DE_PIN, OUTPUT);
+    digitalWrite(RS485_DE_PIN, LOW); // Set to receive mode initially
+    Serial.println("RS485 initialized with manual direction control");
+  } else {
+    Serial.println("RS485 initialized with automatic direction control");
+  }
+  
+  sensorTransaction.begin(&sensorPort, SENSOR_BAUD_RATE);
+  
+  // Wake the acquisition task as soon as response bytes arrive
+  Serial2.onReceive([]() {
+    if (acquisitionTaskHandle != nullptr) {
+      xTaskNotifyGive(acquisitionTaskHandle);
+    }
+  });
+  
+  // Declare the registers we need; adjacent ones share one request
+  measurementPlan.begin(SENSOR_READ_MAX_GAP);
+  measurementPlan.add(MODBUS_INPUT_REGISTERS, XYMD02_REG_TEMPERATURE);
+  measurementPlan.add(MODBUS_INPUT_REGISTERS, XYMD02_REG_HUMIDITY);
+  measurementPlan.plan();
+  configurationPlan.begin(SENSOR_READ_MAX_GAP);
+  configurationPlan.add(MODBUS_HOLDING_REGISTERS, XYMD02_REG_ADDRESS);
+  configurationPlan.add(MODBUS_HOLDING_REGISTERS, XYMD02_REG_BAUD);
+  configurationPlan.add(MODBUS_HOLDING_REGISTERS, XYMD02_REG_TEMP_CORR);
+  configurationPlan.add(MODBUS_HOLDING_REGISTERS, XYMD02_REG_HUM_CORR);
+  configurationPlan.plan();
+  
+  // Start every sensor at its last negotiated rate, or the factory one
+  const size_t rateCount = sizeof(sensorBaudRates) / sizeof(sensorBaudRates[0]);
+  uint8_t factoryRate = 0;
+  for (size_t i = 0; i < rateCount; i++) {
+    if (sensorBaudRates[i] == SENSOR_BAUD_RATE) {
+      factoryRate = (uint8_t)i;
+    }
+  }
+  sensorBaud.begin(sensorBaudRates, rateCount, SENSOR_COUNT, factoryRate,
+                   SENSOR_BAUD_PROBE_BURST, SENSOR_BAUD_SCAN_AFTER,
+                   SENSOR_BAUD_RETRY_INTERVAL);
+  sensorSettings.begin("rs485", false);
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    char key[8];
+    snprintf(key, sizeof(key), "baud%02x", sensorAddresses[i]);
+    sensorBaud.setRate((int)i, sensorSettings.getUChar(key, factoryRate));
+    sensorLinkMetrics[i].baudRate.store(sensorBaud.baudRate((int)i),
+                                        std::memory_order_relaxed);
+    Serial.printf("Sensor %02X expected at %lu baud\n", sensorAddresses[i],
+                  (unsigned long)sensorBaud.baudRate((int)i));
+  }
+  
+  // Poll every configured sensor round-robin with only the Modbus
+  // inter-frame silence between consecutive transactions. The gap is that
+  // of the slowest rate so sensors left at it always see a frame boundary.
+  sensorBus.begin(sensorAddresses, SENSOR_COUNT, SENSOR_READ_INTERVAL,
+                  SENSOR_TIMEOUT_MIN, SENSOR_TIMEOUT,
+                  ModbusTransaction::silenceForBaudRate(sensorBaudRates[0]));
+  
+  // Retry garbled replies at once, back off on timeouts and park a
+  // sensor that stays silent so it only costs a probe now and then
+  sensorHealth.begin(SENSOR_COUNT, SENSOR_FAST_RETRIES, SENSOR_RETRY_INTERVAL,
+                     SENSOR_RETRY_INTERVAL_MAX, SENSOR_OFFLINE_AFTER,
+                     SENSOR_PROBE_INTERVAL);
+  
+  // Poll fast while readings move or sit near a comfort limit, back off
+  // while they are flat
+  const AdaptiveChannel channels[] = {
+    {toDeci(SENSOR_DEADBAND_TEMP), TEMP_MIN_DECI, TEMP_MAX_DECI,
+     toDeci(SENSOR_MARGIN_TEMP)},
+    {toDeci(SENSOR_DEADBAND_HUMIDITY), HUMIDITY_MIN_DECI, HUMIDITY_MAX_DECI,
+     toDeci(SENSOR_MARGIN_HUMIDITY)}
+  };
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    sensorSamplers[i].begin(SENSOR_READ_INTERVAL, SENSOR_READ_INTERVAL_MAX,
+                            channels, sizeof(channels) / sizeof(channels[0]));
+    initializeSensorFilter(temperatureFilters[i],
+                           toDeci(FILTER_SPIKE_RATE_TEMP),
+                           toDeci(FILTER_SPIKE_SLACK_TEMP),
+                           toDeciVariance(FILTER_KALMAN_DRIFT_TEMP),
+                           toDeciVariance(FILTER_KALMAN_NOISE_TEMP));
+    initializeSensorFilter(humidityFilters[i],
+                           toDeci(FILTER_SPIKE_RATE_HUMIDITY),
+                           toDeci(FILTER_SPIKE_SLACK_HUMIDITY),
+                           toDeciVariance(FILTER_KALMAN_DRIFT_HUMIDITY),
+                           toDeciVariance(FILTER_KALMAN_NOISE_HUMIDITY));
+  }
+  
+  // Expand the comfort rules per sensor once; samples only walk the table
+  size_t rules = comfortRules.compile(
+    comfortRuleTable, sizeof(comfortRuleTable) / sizeof(comfortRuleTable[0]),
+    sensorAddresses, SENSOR_COUNT, logComfortRuleEvent);
+  Serial.printf("Polling %d sensor(s) on the RS485 bus, %d comfort rules\n",
+                (int)SENSOR_COUNT, (int)rules);
+}
+
+/**
+ * Set up one channel's filter stages and link those enabled in
+ * FILTER_STAGES, in pipeline order
+ *
+ * @param maxRate Largest plausible change per second (deci-units)
+ * @param slack Change always allowed between readings (deci-units)
+ * @param drift Kalman process noise per second (toDeciVariance())
+ * @param noise Kalman measurement noise (toDeciVariance())
+ */
+void initializeSensorFilter(SensorFilter &filter, int16_t maxRate,
+                            int16_t slack, uint32_t drift, uint32_t noise) {
+  filter.spike.begin(maxRate, slack, FILTER_SPIKE_CONFIRM);
+  filter.ema.begin(FILTER_EMA_SHIFT);
+  filter.kalman.begin(drift, noise);
+  
+  if (FILTER_STAGES & FILTER_SPIKE) {
+    filter.chain.add(&filter.spike);
+  }
+  if (FILTER_STAGES & FILTER_MEDIAN) {
+    filter.chain.add(&filter.median);
+  }
+  if (FILTER_STAGES & FILTER_EMA) {
+    filter.chain.add(&filter.ema);
+  }
+  if (FILTER_STAGES & FILTER_KALMAN) {
+    filter.chain.add(&filter.kalman);
+  }
+}
+
+/**
+ * Initialize OLED display
+ * Sets up I2C communication and display parameters, and shows the
+ * startup screen until the render task replaces it (see updateDisplay())
+ * 
+ * @return false if no display answers; the monitor then runs headless
+ */
+bool initializeOLEDDisplay() {
+  Serial.println("Initializing OLED display...");
+  
+  // Initialize I2C communication for OLED
+  Wire.begin(OLED_SDA_PIN, OLED_SCL_PIN);
+  
+  // The driver does not check for the panel itself: probe its address
+  Wire.beginTransmission(SCREEN_ADDRESS);
+  if (Wire.endTransmission() != 0 ||
+      !display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+    Serial.println(F("WARNING: SSD1306 display not found, running headless"));
+    Serial.println(F("Check wiring and I2C address"));
+    return false;
+  }
+  
+  // Display startup message
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(0, 0);
+  display.println(F("Room Climate Monitor"));
+  display.println(F("v1.0"));
+  display.println();
+  display.println(F("Initializing..."));
+  display.println(F("Starting sensors..."));
+  display.display();
+  
+  // Incremental flushes take over from here; resend everything once
+  displayFlush.begin(&displayBus, SCREEN_WIDTH, SCREEN_HEIGHT);
+  displayFlush.invalidate();
+  
+  Serial.println("OLED display initialized successfully");
+  return true;
+}
+
+// ==================== SENSOR COMMUNICATION ====================
+
+/**
+ * Start the next read of the XY-MD02 sensor that is due according to the
+ * bus scheduler
+ * Uses Modbus RTU protocol over RS485
+ * The first contact reads the configuration holding registers
+ * (0x0101-0x0104, function 0x03); every poll after that reads the
+ * measurement input registers (0x0001-0x0002, function 0x04). Each plan
+ * is sent as the fewest frames the read planner could merge it into.
+ * 
+ * Only queues the request; serviceSensorTransaction() collects the response
+ */
+void readXYMD02Sensor() {
+  // Skip this cycle if the previous request is still in flight
+  if (sensorTransaction.busy()) {
+    return;
+  }
+  
+  int sensor = sensorBus.nextSlave(millis(), micros());
+  if (sensor < 0) {
+    return; // No sensor due yet
+  }
+  
+  selectSensorLineBaudRate(sensorBaud.lineBaudRate(sensor));
+  
+  const ModbusReadPlanner &plan = sensorConfigurations[sensor].known ?
+                                  measurementPlan : configurationPlan;
+  uint8_t command[MODBUS_READ_REQUEST_LENGTH];
+  size_t length;
+  activeIsBaudWrite = sensorBaud.writePending(sensor);
+  if (activeIsBaudWrite) {
+    // Write Single Register (0x06): the sensor echoes the request back
+    uint8_t code = sensorBaud.rateToWrite(sensor);
+    uint8_t write[6] = {sensorAddresses[sensor], 0x06,
+                        (uint8_t)(XYMD02_REG_BAUD >> 8),
+                        (uint8_t)XYMD02_REG_BAUD, 0x00, code};
+    memcpy(activeBaudWrite, write, sizeof(write));
+    ModbusCRC::append(activeBaudWrite, sizeof(write));
+    memcpy(command, activeBaudWrite, sizeof(activeBaudWrite));
+    length = sizeof(activeBaudWrite);
+    activeReplyLength = length; // The reply echoes the request
+    LOG_INFO("Sensor %x: switching from %u to %u baud",
+             sensorAddresses[sensor], sensorBaud.lineBaudRate(sensor),
+             sensorBaud.rate(code));
+  } else {
+    const ModbusReadFrame &frame = plan.frame(sensorNextFrame[sensor]);
+    length = ModbusReadPlanner::buildRequest(frame, sensorAddresses[sensor],
+                                             command);
+    activeReplyLength = 5 + 2 * (size_t)frame.count; // Header, data, CRC
+  }
+  activeFunction = command[1];
+  
+  LOG_DEBUG_HEX("TX:", command, length);
+  
+  // Queue the command with this sensor's learned response timeout;
+  // the UART shifts it out in the background
+  holdBusAwake(true);
+  sensorTransaction.reset();
+  sensorTransaction.start(command, length,
+                          sensorBus.slave(sensor).timeoutMs, micros());
+  sensorBus.beginPoll(sensor, millis());
+  activeSensor = sensor;
+  activePlan = &plan;
+}
+
+/**
+ * Advance the in-flight sensor transaction
+ * Called on every acquisition pass; returns immediately while waiting
+ * 
+ * @return true if a transaction completed or timed out
+ */
+bool serviceSensorTransaction() {
+  unsigned long nowUs = micros();
+  ModbusTransactionState state = sensorTransaction.poll(nowUs);
+  
+  if (state == MODBUS_COMPLETE) {
+    uint32_t responseUs = sensorTransaction.responseTimeUs();
+    busTransactions.increment();
+    busResponseTime.record(responseUs);
+    const uint8_t *response = sensorTransaction.response();
+    size_t length = sensorTransaction.responseLength();
+    LOG_DEBUG("RX: %u bytes after %u ms", length, responseUs / 1000);
+    ModbusFrameView frame;
+    if ((!sensorTransaction.crcValid() ||
+         ModbusFrameDecoder::frameLength(response, length) != length) &&
+        extractSensorFrame(activeSensor, response, length, frame)) {
+      LOG_DEBUG("RX: %u-byte reply recovered from %u bytes", frame.length,
+                length);
+      busResyncs.increment();
+      response = frame.data;
+      length = frame.length;
+    }
+    bool valid = activeIsBaudWrite ?
+      processBaudRateWrite(activeSensor, response, length) :
+      processSensorResponse(activeSensor, response, length);
+    if (valid) {
+      sensorBus.recordSuccess(activeSensor, responseUs, nowUs);
+      sensorLinkMetrics[activeSensor].successes.increment();
+    } else {
+      sensorBus.recordFailure(activeSensor, false, nowUs);
+      sensorLinkMetrics[activeSensor].failures.increment();
+    }
+    updateSensorBaudRate(activeSensor, valid);
+    updateSensorHealth(activeSensor, valid, false);
+    sensorTransaction.reset();
+    holdBusAwake(false);
+    return true;
+  } else if (state == MODBUS_TIMEOUT) {
+    busTransactions.increment();
+    busTimeouts.increment();
+    LOG_ERROR("No response from XY-MD02 sensor %x (timeout)",
+              sensorAddresses[activeSensor]);
+    queueTelemetry(activeSensor, TELEMETRY_LOST,
+                   sensorSamples[activeSensor].temperature,
+                   sensorSamples[activeSensor].humidity);
+    sensorNextFrame[activeSensor] = 0;
+    sensorSamplers[activeSensor].reset();  // Poll fast once it is back
+    sensorBus.recordFailure(activeSensor, true, nowUs);
+    sensorLinkMetrics[activeSensor].failures.increment();
+    updateSensorBaudRate(activeSensor, false);
+    updateSensorHealth(activeSensor, false, true);
+    sensorTransaction.reset();
+    holdBusAwake(false);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Find the active sensor's reply in a response that is not one clean
+ * frame: a turnaround glitch before it, an echo of the request, a late
+ * reply to an earlier request or noise after it
+ * 
+ * A late reply can come from the same sensor, so a frame must also match
+ * the function code and reply length of the request in flight; of
+ * several such frames the last one is the answer to this request.
+ * 
+ * @return true with the last CRC-valid frame that answers the request
+ */
+bool extractSensorFrame(int sensor, const uint8_t *response, size_t length,
+                        ModbusFrameView &frame) {
+  sensorFrameDecoder.reset();
+  sensorFrameDecoder.feed(response, length);
+  sensorFrameDecoder.endOfFrame();
+  bool found = false;
+  ModbusFrameView candidate;
+  while (sensorFrameDecoder.next(candidate)) {
+    if (candidate.address == sensorAddresses[sensor] &&
+        candidate.function == activeFunction &&
+        (candidate.exception || candidate.length == activeReplyLength)) {
+      frame = candidate; // Views stay valid until the next feed()
+      found = true;
+    }
+  }
+  return found;
+}
+
+/**
+ * Publish a sensor's sample to the render task and the gateway image
+ * (acquisition task); the gateway registers are laid out here so that
+ * answering a request is a plain copy
+ */
+void publishSample(int sensor, const SensorSample &sample) {
+  sensorSnapshots[sensor].write(sample);
+  
+  GatewayBlock block;
+  block.registers[GATEWAY_REG_TEMPERATURE] = (uint16_t)sample.temperature;
+  block.registers[GATEWAY_REG_HUMIDITY] = (uint16_t)sample.humidity;
+  block.registers[GATEWAY_REG_DEW_POINT] = (uint16_t)sample.derived.dewPoint;
+  block.registers[GATEWAY_REG_HEAT_INDEX] = (uint16_t)sample.derived.heatIndex;
+  block.registers[GATEWAY_REG_ABSOLUTE_HUMIDITY] =
+    (uint16_t)sample.derived.absoluteHumidity;
+  block.registers[GATEWAY_REG_STATUS] =
+    (sample.health == MODBUS_HEALTH_ONLINE ? GATEWAY_STATUS_CONNECTED : 0) |
+    (sample.activeRules != 0 ? GATEWAY_STATUS_ALERT : 0);
+  block.registers[GATEWAY_REG_ADDRESS] = sensorAddresses[sensor];
+  block.registers[GATEWAY_REG_AGE] = GATEWAY_AGE_UNKNOWN; // Set when read
+  block.timestampMs = sample.timestampMs;
+  block.hasReading = sample.timestampMs != 0;
+  gatewayImage[sensor].write(block);
+  
+  sampleVersion.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Decode a complete response frame from an XY-MD02 sensor
+ * Samples are filtered and published once the last frame of the
+ * measurement plan has been read; earlier frames ask the scheduler for
+ * an immediate follow-up
+ * 
+ * @param sensor Index of the sensor the request was sent to
+ * @param response Pointer to the received frame
+ * @param length Number of bytes in the frame
+ * @return true if the frame was a valid reply
+ */
+bool processSensorResponse(int sensor, const uint8_t *response, size_t length) {
+  SensorSample &reading = sensorSamples[sensor];
+  const ModbusReadFrame &frame = activePlan->frame(sensorNextFrame[sensor]);
+  
+  LOG_DEBUG_HEX("RX:", response, length);
+  
+  ModbusReadResponse registers = ModbusReadPlanner::decode(
+    frame, sensorAddresses[sensor], response, length);
+  if (registers.status != MODBUS_READ_OK) {
+    logReadFailure(sensor, registers, response, length);
+    sensorNextFrame[sensor] = 0;
+    
+    // Firmware without the configuration registers: measure anyway
+    if (activePlan == &configurationPlan &&
+        registers.status == MODBUS_READ_EXCEPTION &&
+        (registers.exceptionCode == 0x01 || registers.exceptionCode == 0x02)) {
+      LOG_WARN("Sensor %x has no configuration registers",
+               sensorAddresses[sensor]);
+      sensorConfigurations[sensor].known = true;
+      sensorBus.requestFollowUp(sensor);
+      return false;
+    }
+    
+    sensorSamplers[sensor].reset();  // Poll fast once it is back
+    queueTelemetry(sensor, TELEMETRY_LOST, reading.temperature,
+                   reading.humidity);
+    return false;
+  }
+  
+  if (activePlan == &configurationPlan) {
+    processSensorConfiguration(sensor, frame, registers);
+  } else {
+    // Parse temperature (two's complement) and humidity, both 0.1 units
+    uint16_t value;
+    if (ModbusReadPlanner::lookup(frame, registers, MODBUS_INPUT_REGISTERS,
+                                  XYMD02_REG_TEMPERATURE, value)) {
+      temperatureFilters[sensor].raw = (int16_t)value;
+    }
+    if (ModbusReadPlanner::lookup(frame, registers, MODBUS_INPUT_REGISTERS,
+                                  XYMD02_REG_HUMIDITY, value)) {
+      humidityFilters[sensor].raw = (int16_t)value;
+    }
+  }
+  
+  // Send the rest of a multi-frame plan back to back
+  if (++sensorNextFrame[sensor] < activePlan->frameCount()) {
+    sensorBus.requestFollowUp(sensor);
+    return true;
+  }
+  sensorNextFrame[sensor] = 0;
+  
+  if (activePlan == &configurationPlan) {
+    sensorConfigurations[sensor].known = true;
+    sensorBus.requestFollowUp(sensor); // First measurement right away
+    return true;
+  }
+  
+  // Filter both channels; a CRC-valid but implausible reading keeps the
+  // last published sample and is retried at the fast interval
+  uint32_t nowMs = millis();
+  int16_t temperature = temperatureFilters[sensor].raw;
+  int16_t humidity = humidityFilters[sensor].raw;
+  bool plausible = temperatureFilters[sensor].chain.apply(temperature, nowMs);
+  plausible = humidityFilters[sensor].chain.apply(humidity, nowMs) && plausible;
+  if (!plausible) {
+    LOG_WARN("Sensor %x: implausible reading %D°C, %D%% rejected",
+             sensorAddresses[sensor], temperatureFilters[sensor].raw,
+             humidityFilters[sensor].raw);
+    sensorRejectedReadings[sensor]++;
+    queueTelemetry(sensor, TELEMETRY_REJECTED, temperatureFilters[sensor].raw,
+                   humidityFilters[sensor].raw);
+    sensorBus.setPollInterval(sensor, sensorSamplers[sensor].reset());
+    return true;
+  }
+  
+  // Unsmoothed readings decide how soon this sensor is polled again, so
+  // a real change speeds polling up without waiting for the filters
+  const int16_t values[] = {temperatureFilters[sensor].raw,
+                            humidityFilters[sensor].raw};
+  uint32_t previousInterval = sensorSamplers[sensor].intervalMs();
+  reading.intervalMs = sensorSamplers[sensor].update(values);
+  sensorBus.setPollInterval(sensor, reading.intervalMs);
+  if (reading.intervalMs != previousInterval) {
+    LOG_DEBUG("Sensor %x: next read in %u ms", sensorAddresses[sensor],
+              reading.intervalMs);
+  }
+  
+  reading.temperature = temperature;
+  reading.humidity = humidity;
+  reading.derived = Psychrometrics::derive(temperature, humidity);
+  
+  // Comfort rules only run when a sample arrives (order of RuleMetric)
+  const int16_t metrics[RULE_METRIC_COUNT] = {
+    temperature, humidity, reading.derived.dewPoint,
+    reading.derived.heatIndex, reading.derived.absoluteHumidity
+  };
+  reading.activeRules = comfortRules.update(sensor, metrics, nowMs);
+  reading.health = MODBUS_HEALTH_ONLINE;
+  reading.timestampMs = nowMs;
+  
+  // Publish temperature and humidity together as one consistent sample
+  publishSample(sensor, reading);
+  if (firstReadingMs.load(std::memory_order_relaxed) == 0) {
+    uint32_t bootMs = nowMs > 0 ? nowMs : 1;  // 0 means none yet
+    firstReadingMs.store(bootMs, std::memory_order_release);
+    LOG_INFO("First reading %u ms after boot", bootMs);
+  }
+  queueTelemetry(sensor, reading.activeRules != 0 ?
+                         TELEMETRY_VALID | TELEMETRY_ALERT : TELEMETRY_VALID,
+                 reading.temperature, reading.humidity);
+  
+  // Append to the history; minute/hour aggregates roll up incrementally
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  sensorHistory[sensor].add(reading.timestampMs, reading.temperature,
+                            reading.humidity);
+  xSemaphoreGive(historyMutex);
+  
+  queueSampleForLog(sensor);
+  
+  LOG_INFO("SUCCESS! Sensor %x Temperature: %D°C, Humidity: %D%%",
+           sensorAddresses[sensor], reading.temperature, reading.humidity);
+  LOG_DEBUG("Sensor %x: dew point %D°C, heat index %D°C, %D g/m3",
+            sensorAddresses[sensor], reading.derived.dewPoint,
+            reading.derived.heatIndex, reading.derived.absoluteHumidity);
+  return true;
+}
+
+/**
+ * Check the echo of a baud rate write
+ * 
+ * @return true if the sensor acknowledged the new rate
+ */
+bool processBaudRateWrite(int sensor, const uint8_t *response, size_t length) {
+  LOG_DEBUG_HEX("RX:", response, length);
+  
+  if (length == sizeof(activeBaudWrite) &&
+      memcmp(response, activeBaudWrite, length) == 0) {
+    return true;
+  }
+  if (length == 5 && response[1] == 0x86) {
+    busExceptions.increment();
+    LOG_WARN("Modbus Exception - Sensor: %x, Function: 06, Code: %x",
+             sensorAddresses[sensor], response[2]);
+  } else {
+    LOG_WARN_HEX("Bad baud rate write echo:", response, length);
+  }
+  return false;
+}
+
+/**
+ * Advance a sensor's baud rate negotiation after a transaction
+ * Persists the new rate whenever the sensor was moved to one, and keeps
+ * the bus on this sensor while a switch is being written or probed
+ */
+void updateSensorBaudRate(int sensor, bool valid) {
+  uint32_t lineBaud = sensorBaud.lineBaudRate(sensor);
+  if (sensorBaud.recordResult(sensor, valid, millis())) {
+    char key[8];
+    snprintf(key, sizeof(key), "baud%02x", sensorAddresses[sensor]);
+    sensorSettings.putUChar(key, sensorBaud.slave(sensor).rate);
+    LOG_INFO("Sensor %x now at %u baud", sensorAddresses[sensor],
+             sensorBaud.baudRate(sensor));
+  } else if (sensorBaud.slave(sensor).state == MODBUS_BAUD_SCANNING &&
+             sensorBaud.lineBaudRate(sensor) != lineBaud) {
+    LOG_WARN("Sensor %x lost, trying %u baud", sensorAddresses[sensor],
+             sensorBaud.lineBaudRate(sensor));
+  }
+  sensorLinkMetrics[sensor].baudRate.store(sensorBaud.baudRate(sensor),
+                                           std::memory_order_relaxed);
+  
+  if (sensorBaud.negotiating(sensor)) {
+    sensorBus.requestFollowUp(sensor);
+  }
+}
+
+/**
+ * Feed a transaction's outcome to the retry policy: a garbled reply is
+ * retried at once, failed polls back off, and a sensor that stays
+ * silent is parked and only probed every SENSOR_PROBE_INTERVAL
+ *
+ * @param valid true if the sensor sent a valid reply
+ * @param timedOut true if it sent nothing at all
+ */
+void updateSensorHealth(int sensor, bool valid, bool timedOut) {
+  if (valid) {
+    uint8_t failedPolls = sensorHealth.slave(sensor).failedPolls;
+    if (sensorHealth.recordSuccess(sensor)) {
+      LOG_INFO("Sensor %x back online after %u failed polls",
+               sensorAddresses[sensor], failedPolls);
+    }
+    return; // Published with the next complete sample
+  }
+
+  ModbusHealthState previous = sensorHealth.state(sensor);
+  if (sensorHealth.recordFailure(sensor, timedOut, millis())) {
+    sensorBus.requestFollowUp(sensor);
+  }
+  sensorBus.setPollInterval(sensor, sensorHealth.retryInterval(sensor));
+  const ModbusHealthStatus &health = sensorHealth.slave(sensor);
+  sensorLinkMetrics[sensor].fastRetries.store(health.fastRetries,
+                                              std::memory_order_relaxed);
+  sensorLinkMetrics[sensor].trips.store(health.trips,
+                                        std::memory_order_relaxed);
+
+  SensorSample &reading = sensorSamples[sensor];
+  reading.health = sensorHealth.state(sensor);
+  publishSample(sensor, reading);
+  if (reading.health == MODBUS_HEALTH_OFFLINE &&
+      previous != MODBUS_HEALTH_OFFLINE) {
+    LOG_WARN("Sensor %x offline after %u failed polls, probing every %u s",
+             sensorAddresses[sensor], health.failedPolls,
+             SENSOR_PROBE_INTERVAL / 1000);
+  }
+}
+
+/**
+ * Retune Serial2 and the frame timings when the next sensor uses a
+ * different rate than the last one
+ */
+void selectSensorLineBaudRate(uint32_t baudRate) {
+  if (baudRate == sensorLineBaud) {
+    return;
+  }
+  Serial2.updateBaudRate(baudRate);
+  sensorTransaction.setBaudRate(baudRate);
+  sensorLineBaud = baudRate;
+}
+
+/**
+ * Store the holding registers covered by one configuration frame
+ * 
+ * @return true if the frame held any configuration register
+ */
+bool processSensorConfiguration(int sensor, const ModbusReadFrame &frame,
+                                const ModbusReadResponse &registers) {
+  SensorConfiguration &config = sensorConfigurations[sensor];
+  uint16_t value;
+  bool found = false;
+  
+  if (ModbusReadPlanner::lookup(frame, registers, MODBUS_HOLDING_REGISTERS,
+                                XYMD02_REG_ADDRESS, value)) {
+    config.address = value;
+    found = true;
+  }
+  if (ModbusReadPlanner::lookup(frame, registers, MODBUS_HOLDING_REGISTERS,
+                                XYMD02_REG_BAUD, value)) {
+    config.baudCode = value;
+    found = true;
+  }
+  if (ModbusReadPlanner::lookup(frame, registers, MODBUS_HOLDING_REGISTERS,
+                                XYMD02_REG_TEMP_CORR, value)) {
+    config.temperatureCorrection = (int16_t)value;
+    found = true;
+  }
+  if (ModbusReadPlanner::lookup(frame, registers, MODBUS_HOLDING_REGISTERS,
+                                XYMD02_REG_HUM_CORR, value)) {
+    config.humidityCorrection = (int16_t)value;
+    found = true;
+  }
+  
+  if (found) {
+    LOG_INFO("Sensor %x config: baud code %u, corrections %D°C %D%%",
+             sensorAddresses[sensor], config.baudCode,
+             config.temperatureCorrection, config.humidityCorrection);
+  }
+  return found;
+}
+
+/**
+ * Log why a response was rejected and count it in the metrics
+ */
+void logReadFailure(int sensor, const ModbusReadResponse &result,
+                    const uint8_t *response, size_t length) {
+  switch (result.status) {
+    case MODBUS_READ_EXCEPTION:
+      busExceptions.increment();
+      LOG_WARN("Modbus Exception - Sensor: %x, Function: %x, Code: %x",
+               sensorAddresses[sensor], response[1] & 0x7F,
+               result.exceptionCode);
+      break;
+    case MODBUS_READ_TOO_SHORT:
+    case MODBUS_READ_WRONG_LENGTH:
+      busPartialFrames.increment();
+      LOG_WARN_HEX("Partial response:", response, length);
+      break;
+    case MODBUS_READ_WRONG_ADDRESS:
+      LOG_ERROR("Wrong device address - Expected: %x, Got: %x",
+                sensorAddresses[sensor], response[0]);
+      break;
+    case MODBUS_READ_WRONG_FUNCTION:
+      LOG_ERROR("Wrong function code - Expected: %x, Got: %x",
+                activePlan->frame(sensorNextFrame[sensor]).space, response[1]);
+      break;
+    case MODBUS_READ_CRC_ERROR:
+      busCrcErrors.increment();
+      LOG_ERROR("CRC mismatch from sensor %x", sensorAddresses[sensor]);
+      break;
+    default:
+      LOG_ERROR("Invalid sensor response");
+      break;
+  }
+}
+
+// ==================== DISPLAY FUNCTIONS ====================
+
+/**
+ * Main display update function
+ * Orchestrates the complete display update cycle
+ * Runs on the render task and only reads published sensor snapshots
+ */
+void updateDisplay() {
+  refreshJitter.record(
+    renderJobs.stats(displayUpdateJob).lastLatenessUs);
+  unsigned long currentTime = millis();
+  
+  // Leave the startup screen up until the first reading arrives, or
+  // DISPLAY_SPLASH_TIME has passed, checking back every few ticks so the
+  // reading appears as soon as there is one
+  if (firstReadingMs.load(std::memory_order_acquire) == 0 &&
+      currentTime < DISPLAY_SPLASH_TIME) {
+    renderJobs.reschedule(displayUpdateJob,
+                          micros() + DISPLAY_SPLASH_POLL_MS * 1000UL);
+    return;
+  }
+  SensorSample reading = sensorSnapshots[displayedSensor].read();
+  bool fresh = reading.health == MODBUS_HEALTH_ONLINE &&
+               currentTime - reading.timestampMs <=
+                 SENSOR_STALE_TIMEOUT + reading.intervalMs;
+  
+  // Title header is drawn once and left untouched in the framebuffer
+  if (!staticLayoutDrawn) {
+    drawStaticLayout();
+    staticLayoutDrawn = true;
+  }
+  
+  // Clear only the dynamic regions: uptime/ID block right of "ROOM",
+  // and the data area below the header
+  display.fillRect(48, 0, SCREEN_WIDTH - 48, 16, SSD1306_BLACK);
+  display.fillRect(0, 32, SCREEN_WIDTH, SCREEN_HEIGHT - 32, SSD1306_BLACK);
+  
+  // Reset text size for data display
+  display.setTextSize(1);
+  
+  // Display appropriate content based on sensor status
+  if (fresh) {
+    displaySensorData(displayedSensor, reading);
+    displayComfortStatus(displayedSensor, reading);
+  } else {
+    displayErrorMessage(reading.health);
+  }
+  
+  // Identify the sensor on multi-sensor buses
+  if (SENSOR_COUNT > 1) {
+    displaySensorLabel(sensorAddresses[displayedSensor]);
+  }
+  
+  // Always show system uptime
+  displayUptime();
+  
+  // Update the physical display
+  flushDisplay();
+}
+
+/**
+ * Draw the static title header into a cleared framebuffer
+ */
+void drawStaticLayout() {
+  display.clearDisplay();
+  display.setTextSize(2);
+  display.setCursor(0, 0);
+  display.println(F("ROOM"));
+  display.println(F("MONITOR"));
+}
+
+/**
+ * Push the changed parts of the framebuffer to the OLED
+ * Tracks I2C bytes and flush time per frame for reportDisplayStats()
+ */
+void flushDisplay() {
+  // Adafruit_SSD1306 drops the bus clock after its own transfers
+  Wire.setClock(OLED_I2C_CLOCK);
+  
+  unsigned long startUs = micros();
+  size_t bytes = displayFlush.flush(display.getBuffer());
+  uint32_t elapsedUs = micros() - startUs;
+  displayFlushTime.record(elapsedUs);
+  
+  flushFrames++;
+  flushBytesTotal += bytes;
+  flushTimeTotalUs += elapsedUs;
+  if (elapsedUs > flushTimeMaxUs) {
+    flushTimeMaxUs = elapsedUs;
+  }
+}
+
+/**
+ * Render job: show the next sensor when more than one is configured
+ */
+void rotateDisplayedSensor() {
+  displayedSensor = (displayedSensor + 1) % SENSOR_COUNT;
+}
+
+/**
+ * Render job: report flush statistics and refresh timing
+ */
+void reportDisplayStats() {
+  if (flushFrames > 0) {
+    LOG_INFO("Display: %u frames, avg %u bytes/frame (full frame %u)",
+             flushFrames, flushBytesTotal / flushFrames,
+             displayFlush.fullFrameBytes());
+    LOG_INFO("Display: avg flush %u us, max %u us",
+             flushTimeTotalUs / flushFrames, flushTimeMaxUs);
+  }
+  const DeadlineJobStats &refresh = renderJobs.stats(displayUpdateJob);
+  LOG_INFO("Display: refresh late avg %u us, max %u us",
+           refresh.runs > 0 ? refresh.totalLatenessUs / refresh.runs : 0,
+           refresh.maxLatenessUs);
+  renderJobs.resetStats(displayUpdateJob);
+  flushFrames = 0;
+  flushBytesTotal = 0;
+  flushTimeTotalUs = 0;
+  flushTimeMaxUs = 0;
+}
+
+/**
+ * Display current sensor readings with warning indicators
+ * A reading is flagged while a comfort rule on its metric is active
+ * 
+ * @param sensor Index of the displayed sensor
+ * @param reading Sample with temperature and humidity in 0.1 units
+ */
+void displaySensorData(size_t sensor, const SensorSample &reading) {
+  char line[24];
+  
+  // Display temperature with out-of-range warning
+  TextBuilder tempLine(line, sizeof(line));
+  tempLine.text("Temp: ").deci(reading.temperature).text(" C");
+  if (reading.activeRules & comfortRules.metricMask(sensor, RULE_TEMPERATURE)) {
+    tempLine.text(" !"); // Warning indicator for temperature
+  }
+  display.setCursor(0, 32);
+  display.print(line);
+  
+  // Display humidity with out-of-range warning
+  TextBuilder humidityLine(line, sizeof(line));
+  humidityLine.text("Humidity: ").deci(reading.humidity).text("%");
+  if (reading.activeRules & comfortRules.metricMask(sensor, RULE_HUMIDITY)) {
+    humidityLine.text(" !"); // Warning indicator for humidity
+  }
+  display.setCursor(0, 42);
+  display.print(line);
+}
+
+/**
+ * Display why there is no reading: not answered yet, failing and being
+ * retried, parked as offline, or answering but out of date
+ * 
+ * @param health Link state of the displayed sensor
+ */
+void displayErrorMessage(ModbusHealthState health) {
+  display.setCursor(0, 35);
+  switch (health) {
+    case MODBUS_HEALTH_UNKNOWN:
+      display.println("Waiting for Sensor");
+      return;
+    case MODBUS_HEALTH_RETRYING:
+      display.println("Sensor Error!");
+      display.setCursor(0, 45);
+      display.println("Retrying...");
+      return;
+    case MODBUS_HEALTH_OFFLINE:
+      display.println("Sensor Offline");
+      break;
+    default:
+      display.println("Sensor Error!");
+      break;
+  }
+  display.setCursor(0, 45);
+  display.println("Check Connection");
+}
+
+/**
+ * Display the comfort status: the label of the highest-priority active
+ * comfort rule, as last evaluated by the acquisition task
+ * 
+ * @param sensor Index of the displayed sensor
+ * @param reading Sample carrying the active rule mask
+ */
+void displayComfortStatus(size_t sensor, const SensorSample &reading) {
+  char line[24];
+  TextBuilder status(line, sizeof(line));
+  status.text("Status: ");
+  
+  const RuleDefinition *rule = nullptr;
+  for (uint8_t bit = 0; bit < RULE_SENSOR_RULES_MAX && rule == nullptr; bit++) {
+    if (reading.activeRules & (1UL << bit)) {
+      rule = comfortRules.definition(sensor, bit);
+    }
+  }
+  status.text(rule != nullptr ? rule->label : "COMFORT");
+  
+  display.setCursor(0, 52);
+  display.print(line);
+}
+
+/**
+ * Log comfort rule transitions (RuleEngine event handler)
+ */
+void logComfortRuleEvent(const RuleEvent &event) {
+  if (event.active) {
+    LOG_WARN("Sensor %x: comfort rule %u active (value %D)",
+             sensorAddresses[event.sensor], event.rule, event.value);
+  } else {
+    LOG_INFO("Sensor %x: comfort rule %u cleared (value %D)",
+             sensorAddresses[event.sensor], event.rule, event.value);
+  }
+}
+
+/**
+ * Display the Modbus address of the shown sensor below the uptime
+ * 
+ * @param address Modbus address of the sensor
+ */
+void displaySensorLabel(uint8_t address) {
+  char label[8];
+  TextBuilder builder(label, sizeof(label));
+  builder.text("ID ").hex(address);
+  
+  // Fixed-width font: right-align without measuring glyph bounds
+  display.setCursor(SCREEN_WIDTH - builder.length() * FONT_CHAR_WIDTH - 2, 8);
+  display.print(label);
+}
+
+/**
+ * Display system uptime in top-right corner
+ */
+void displayUptime() {
+  display.setTextSize(1);
+  
+  // Calculate uptime and format string
+  char uptimeStr[16];
+  unsigned long uptimeSeconds = millis() / 1000;
+  TextBuilder builder(uptimeStr, sizeof(uptimeStr));
+  builder.text("Up: ").unsignedNumber(uptimeSeconds).character('s');
+  
+  // Position text with 2px padding from right edge (fixed-width font)
+  display.setCursor(SCREEN_WIDTH - builder.length() * FONT_CHAR_WIDTH - 2, 0);
+  display.print(uptimeStr);
+}
+
+// ==================== SERIAL CONSOLE ====================
+
+/**
+ * Collect characters typed on the serial console and run each complete
+ * line as a command (log task; never waits for input)
+ */
+void pollSerialCommands() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    if (c == '\r' || c == '\n') {
+      if (serialCommandLength > 0) {
+        serialCommand[serialCommandLength] = '\0';
+        runSerialCommand(serialCommand);
+        serialCommandLength = 0;
+      }
+    } else if (c >= 0 && serialCommandLength < SERIAL_COMMAND_LENGTH - 1) {
+      serialCommand[serialCommandLength++] = (char)c;
+    }
+  }
+}
+
+/**
+ * Execute one console command:
+ *   metrics           - report counters and latency histograms
+ *   metrics reset     - report, then start a new measurement window
+ *   telemetry binary  - switch the console to COBS telemetry frames
+ *   telemetry text    - switch back to text log lines
+ *   history raw       - print the raw history tier as CSV
+ */
+void runSerialCommand(const char *command) {
+  if (strcmp(command, "metrics") == 0) {
+    reportMetrics(false);
+  } else if (strcmp(command, "metrics reset") == 0) {
+    reportMetrics(true);
+  } else if (strcmp(command, "telemetry binary") == 0) {
+    telemetryBinary.store(true, std::memory_order_relaxed);
+  } else if (strcmp(command, "telemetry text") == 0) {
+    telemetryBinary.store(false, std::memory_order_relaxed);
+  } else if (strcmp(command, "history raw") == 0) {
+    dumpRawHistory();
+  } else {
+    Logger::message(LOG_LEVEL_WARN,
+                    "Unknown command; try \"metrics\" or \"telemetry text\"");
+  }
+}
+
+/**
+ * Print every sample in the raw history tier as CSV on the console
+ * Samples are copied out in small batches, newer than the last one
+ * printed, so historyMutex is never held while the UART drains
+ */
+void dumpRawHistory() {
+  if (telemetryBinary.load(std::memory_order_relaxed)) {
+    LOG_WARN("Raw history dump needs \"telemetry text\"");
+    return;
+  }
+  
+  static const size_t DUMP_BATCH = 32;
+  Serial.println("address,timestamp_ms,temperature,humidity");
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    HistorySample batch[DUMP_BATCH];
+    bool started = false;
+    uint32_t lastMs = 0;
+    size_t count;
+    do {
+      count = 0;
+      xSemaphoreTake(historyMutex, portMAX_DELAY);
+      sensorHistory[i].forEachRaw([&](const HistorySample &sample) {
+        if (count < DUMP_BATCH &&
+            (!started || (int32_t)(sample.timestampMs - lastMs) > 0)) {
+          batch[count++] = sample;
+        }
+      });
+      xSemaphoreGive(historyMutex);
+      
+      for (size_t n = 0; n < count; n++) {
+        char line[48];
+        TextBuilder(line, sizeof(line))
+            .unsignedNumber(sensorAddresses[i]).character(',')
+            .unsignedNumber(batch[n].timestampMs).character(',')
+            .deci(batch[n].temperature).character(',')
+            .deci(batch[n].humidity);
+        Serial.println(line);
+      }
+      if (count > 0) {
+        started = true;
+        lastMs = batch[count - 1].timestampMs;
+      }
+    } while (count == DUMP_BATCH);
+  }
+}
+
+/**
+ * Queue a snapshot of the runtime metrics for the serial console
+ * Written at INFO level whatever LOG_LEVEL is, since it was asked for
+ * 
+ * @param clear Zero counters and histograms after reading them
+ */
+void reportMetrics(bool clear) {
+  Logger::message(LOG_LEVEL_INFO,
+    "Metrics: %u transactions, %u timeouts, %u CRC errors, %u exceptions",
+    clear ? busTransactions.take() : busTransactions.value(),
+    clear ? busTimeouts.take() : busTimeouts.value(),
+    clear ? busCrcErrors.take() : busCrcErrors.value(),
+    clear ? busExceptions.take() : busExceptions.value());
+  Logger::message(LOG_LEVEL_INFO,
+    "Metrics: %u partial frames, %u resynced replies, %u log records dropped",
+    clear ? busPartialFrames.take() : busPartialFrames.value(),
+    clear ? busResyncs.take() : busResyncs.value(), Logger::dropped());
+  uint32_t healthCounts[MODBUS_HEALTH_OFFLINE + 1] = {};
+  uint32_t trips = 0;
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    healthCounts[sensorSnapshots[i].read().health]++;
+    trips += sensorLinkMetrics[i].trips.load(std::memory_order_relaxed);
+  }
+  Logger::message(LOG_LEVEL_INFO,
+    "Sensors: %u online, %u retrying, %u offline, %u offline trips",
+    healthCounts[MODBUS_HEALTH_ONLINE], healthCounts[MODBUS_HEALTH_RETRYING],
+    healthCounts[MODBUS_HEALTH_OFFLINE], trips);
+  Logger::message(LOG_LEVEL_INFO,
+    "Metrics: heap %u free, %u min; first reading %u ms after boot",
+    ESP.getFreeHeap(), ESP.getMinFreeHeap(), firstReadingMs.load());
+  reportLatency("Modbus response: %u, p50 %u us, p99 %u us, max %u us",
+                busResponseTime, clear);
+  reportLatency("Display flush: %u, p50 %u us, p99 %u us, max %u us",
+                displayFlushTime, clear);
+  reportLatency("Poll jitter: %u, p50 %u us, p99 %u us, max %u us",
+                pollJitter, clear);
+  reportLatency("Refresh jitter: %u, p50 %u us, p99 %u us, max %u us",
+                refreshJitter, clear);
+  if (GATEWAY_ENABLED) {
+    Logger::message(LOG_LEVEL_INFO,
+      "Gateway: %u requests, %u exceptions, %u CRC errors, %u ignored",
+      clear ? gatewayRequests.take() : gatewayRequests.value(),
+      clear ? gatewayExceptions.take() : gatewayExceptions.value(),
+      clear ? gatewayCrcErrors.take() : gatewayCrcErrors.value(),
+      clear ? gatewayIgnored.take() : gatewayIgnored.value());
+    reportLatency("Gateway answer: %u, p50 %u us, p99 %u us, max %u us",
+                  gatewayAnswerTime, clear);
+  }
+  if (mqttActive) {
+    Logger::message(LOG_LEVEL_INFO,
+      "MQTT: %u batches sent, %u queued, %u dropped, %u connects",
+      mqttBatchesSent.value(),
+      mqttBatchesQueued.load(std::memory_order_relaxed),
+      mqttBatchesDropped.load(std::memory_order_relaxed),
+      mqttConnects.load(std::memory_order_relaxed));
+  }
+}
+
+/**
+ * Queue one histogram line: sample count, median, 99th percentile, max
+ * 
+ * @param format Constant format with four %u fields
+ */
+void reportLatency(const char *format, LatencyHistogram &histogram,
+                   bool clear) {
+  LatencySnapshot latency = histogram.snapshot(clear);
+  Logger::message(LOG_LEVEL_INFO, format, latency.count,
+                  latency.percentile(50), latency.percentile(99),
+                  latency.maxUs);
+}
+
+// ==================== TELEMETRY ====================
+
+/**
+ * Queue a telemetry record for the log task and the MQTT task
+ * (acquisition task; never blocks). Nothing goes to the log task while
+ * the console is in text mode, nothing to MQTT without a broker
+ * 
+ * @param flags TELEMETRY_VALID, TELEMETRY_LOST, ...
+ */
+void queueTelemetry(int sensor, uint8_t flags, int16_t temperature,
+                    int16_t humidity) {
+  bool binary = telemetryBinary.load(std::memory_order_relaxed);
+  if (!binary && !mqttActive) {
+    return;
+  }
+  TelemetryRecord record = {(uint32_t)millis(), sensorAddresses[sensor],
+                            temperature, humidity, flags};
+  if (binary && !telemetryQueue.push(record)) {
+    telemetryDrops.increment();
+  }
+  if (mqttActive) {
+    mqttRecords.increment();
+    if (!mqttSamples.push(record)) {
+      mqttSampleDrops.increment();
+    }
+  }
+}
+
+/**
+ * Send the queued records as one frame per TELEMETRY_MAX_RECORDS
+ * (log task)
+ */
+void flushTelemetry() {
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  TelemetryRecord record;
+  while (telemetryQueue.pop(record)) {
+    if (!telemetryEncoder.add(record)) {
+      Serial.write(frame, telemetryEncoder.finish(frame));
+      telemetryEncoder.add(record);
+    }
+  }
+  size_t length = telemetryEncoder.finish(frame);
+  if (length > 0) {
+    Serial.write(frame, length);
+  }
+}
+
+/**
+ * Log sink for binary mode: each line becomes a log frame
+ */
+void writeLogFrame(const char *line, size_t length) {
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  Serial.write(frame, telemetryEncoder.encodeLog(line, length, frame));
+}
+
+// ==================== HTTP STATUS ====================
+
+/**
+ * Serialize a document into the cache's spare buffer and serve it
+ * (HTTP task)
+ * 
+ * @return false if clients still hold both buffers; retry next pass
+ */
+bool publishDocument(HttpResponseCache &cache,
+                     void (*serialize)(TextBuilder &json)) {
+  char *body = cache.draft();
+  if (body == nullptr) {
+    return false;
+  }
+  TextBuilder json(body, cache.draftCapacity());
+  serialize(json);
+  if (json.overflowed()) {
+    // Keep serving the previous version rather than truncated JSON
+    LOG_WARN("HTTP document exceeds %u bytes", HTTP_RESPONSE_CAPACITY);
+    return true;
+  }
+  cache.publish(json.length());
+  return true;
+}
+
+/**
+ * /status: latest published sample of every sensor
+ * {"uptime_ms":..,"sensors":[{"address":1,"connected":true,
+ *  "health":"online","timestamp_ms":..,"temperature":23.5,...,"alerts":["TOO HOT"]}]}
+ */
+void writeStatusJson(TextBuilder &json) {
+  json.text("{\"uptime_ms\":").unsignedNumber(millis()).text(",\"sensors\":[");
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    SensorSample reading = sensorSnapshots[i].read();
+    json.text(i > 0 ? ",{" : "{")
+        .text("\"address\":").unsignedNumber(sensorAddresses[i])
+        .text(",\"connected\":")
+        .text(reading.health == MODBUS_HEALTH_ONLINE ? "true" : "false")
+        .text(",\"health\":\"")
+        .text(ModbusRetryPolicy::stateName(reading.health)).character('"');
+    if (reading.timestampMs == 0) {
+      json.text(",\"timestamp_ms\":null}");  // Never read
+      continue;
+    }
+    json.text(",\"timestamp_ms\":").unsignedNumber(reading.timestampMs)
+        .text(",\"temperature\":").deci(reading.temperature)
+        .text(",\"humidity\":").deci(reading.humidity)
+        .text(",\"dew_point\":").deci(reading.derived.dewPoint)
+        .text(",\"heat_index\":").deci(reading.derived.heatIndex)
+        .text(",\"absolute_humidity\":").deci(reading.derived.absoluteHumidity)
+        .text(",\"alerts\":[");
+    // Labels in priority order, each once (several rules share a label)
+    bool first = true;
+    for (uint8_t bit = 0; bit < RULE_SENSOR_RULES_MAX; bit++) {
+      const RuleDefinition *rule = (reading.activeRules & (1UL << bit)) ?
+                                   comfortRules.definition(i, bit) : nullptr;
+      bool repeated = false;
+      for (uint8_t earlier = 0; rule != nullptr && earlier < bit; earlier++) {
+        const RuleDefinition *other =
+          (reading.activeRules & (1UL << earlier)) ?
+          comfortRules.definition(i, earlier) : nullptr;
+        repeated = repeated ||
+                   (other != nullptr && strcmp(other->label, rule->label) == 0);
+      }
+      if (rule != nullptr && !repeated) {
+        json.text(first ? "\"" : ",\"").text(rule->label).character('"');
+        first = false;
+      }
+    }
+    json.text("]}");
+  }
+  json.text("]}");
+}
+
+/**
+ * /history: min/avg/max over the last hour and the last day per sensor
+ */
+void writeHistoryJson(TextBuilder &json) {
+  json.text("{\"sensors\":[");
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    // Summaries are computed under the lock, formatted outside it
+    uint32_t nowMs = millis();
+    xSemaphoreTake(historyMutex, portMAX_DELAY);
+    HistoryAggregate hour = sensorHistory[i].summarizeMinutes(60, nowMs);
+    HistoryAggregate day = sensorHistory[i].summarizeHours(24, nowMs);
+    xSemaphoreGive(historyMutex);
+    
+    json.text(i > 0 ? ",{" : "{")
+        .text("\"address\":").unsignedNumber(sensorAddresses[i])
+        .text(",\"last_hour\":");
+    writeAggregateJson(json, hour);
+    json.text(",\"last_day\":");
+    writeAggregateJson(json, day);
+    json.character('}');
+  }
+  json.text("]}");
+}
+
+/**
+ * {"samples":N,"temperature":{"min":..,"avg":..,"max":..},"humidity":{..}},
+ * or null for an empty window
+ */
+void writeAggregateJson(TextBuilder &json, const HistoryAggregate &aggregate) {
+  if (aggregate.count == 0) {
+    json.text("null");
+    return;
+  }
+  json.text("{\"samples\":").unsignedNumber(aggregate.count)
+      .text(",\"temperature\":{\"min\":").deci(aggregate.temperatureMin)
+      .text(",\"avg\":").deci(aggregate.temperatureAverage())
+      .text(",\"max\":").deci(aggregate.temperatureMax)
+      .text("},\"humidity\":{\"min\":").deci(aggregate.humidityMin)
+      .text(",\"avg\":").deci(aggregate.humidityAverage())
+      .text(",\"max\":").deci(aggregate.humidityMax)
+      .text("}}");
+}
+
+/**
+ * /health: link state per sensor, bus and queue counters, heap
+ */
+void writeHealthJson(TextBuilder &json) {
+  uint32_t firstMs = firstReadingMs.load(std::memory_order_relaxed);
+  json.text("{\"uptime_ms\":").unsignedNumber(millis())
+      .text(",\"first_reading_ms\":");
+  if (firstMs != 0) {
+    json.unsignedNumber(firstMs);
+  } else {
+    json.text("null");
+  }
+  json.text(",\"free_heap\":").unsignedNumber(ESP.getFreeHeap())
+      .text(",\"min_free_heap\":").unsignedNumber(ESP.getMinFreeHeap())
+      .text(",\"bus\":{\"transactions\":").unsignedNumber(busTransactions.value())
+      .text(",\"timeouts\":").unsignedNumber(busTimeouts.value())
+      .text(",\"crc_errors\":").unsignedNumber(busCrcErrors.value())
+      .text(",\"exceptions\":").unsignedNumber(busExceptions.value())
+      .text(",\"partial_frames\":").unsignedNumber(busPartialFrames.value())
+      .text(",\"resynced\":").unsignedNumber(busResyncs.value())
+      .text("},\"sensors\":[");
+  for (size_t i = 0; i < SENSOR_COUNT; i++) {
+    const SensorLinkMetrics &link = sensorLinkMetrics[i];
+    ModbusHealthState state = sensorSnapshots[i].read().health;
+    json.text(i > 0 ? ",{" : "{")
+        .text("\"address\":").unsignedNumber(sensorAddresses[i])
+        .text(",\"connected\":")
+        .text(state == MODBUS_HEALTH_ONLINE ? "true" : "false")
+        .text(",\"health\":\"").text(ModbusRetryPolicy::stateName(state))
+        .text("\",\"successes\":").unsignedNumber(link.successes.value())
+        .text(",\"failures\":").unsignedNumber(link.failures.value())
+        .text(",\"fast_retries\":")
+        .unsignedNumber(link.fastRetries.load(std::memory_order_relaxed))
+        .text(",\"offline_trips\":")
+        .unsignedNumber(link.trips.load(std::memory_order_relaxed))
+        .text(",\"baud\":")
+        .unsignedNumber(link.baudRate.load(std::memory_order_relaxed))
+        .character('}');
+  }
+  const HttpServerStats &http = statusServer.stats();
+  json.text("],\"log_dropped\":").unsignedNumber(Logger::dropped())
+      .text(",\"samples_dropped\":").unsignedNumber(sampleLogDrops.value())
+      .text(",\"telemetry_dropped\":").unsignedNumber(telemetryDrops.value())
+      .text(",\"gateway_requests\":")
+      .unsignedNumber(gatewayRequests.value())
+      .text(",\"http\":{\"connections\":").unsignedNumber(http.connections)
+      .text(",\"requests\":").unsignedNumber(http.requests)
+      .text(",\"errors\":").unsignedNumber(http.errors)
+      .text("},\"mqtt\":{\"connected\":")
+      .text(mqttConnected.load(std::memory_order_relaxed) ? "true" : "false")
+      .text(",\"batches_sent\":").unsignedNumber(mqttBatchesSent.value())
+      .text(",\"batches_queued\":")
+      .unsignedNumber(mqttBatchesQueued.load(std::memory_order_relaxed))
+      .text(",\"batches_dropped\":")
+      .unsignedNumber(mqttBatchesDropped.load(std::memory_order_relaxed))
+      .text(",\"records_dropped\":").unsignedNumber(mqttSampleDrops.value())
+      .text("}}");
+}
+
+// ==================== UTILITY FUNCTIONS ====================
+
+/**
+ * Hand the sensor's latest reading to the storage task without blocking
+ * Samples are dropped (and counted) if the storage task falls behind
+ */
+void queueSampleForLog(int sensor) {
+  QueueHandle_t queue = sampleLogQueue.load(std::memory_order_acquire);
+  if (queue == nullptr) {
+    return;
+  }
+  const SensorSample &reading = sensorSamples[sensor];
+  LoggedSample sample = {reading.timestampMs, sensorAddresses[sensor],
+                         reading.temperature, reading.humidity};
+  if (xQueueSend(queue, &sample, 0) != pdTRUE) {
+    sampleLogDrops.increment();
+  }
 }
@@ -0,0 +1,908 @@
+/**
+ * ESP32 Room Climate Monitor - Native Simulator
+ *
+ * Runs the unmodified firmware in src/main.cpp on Linux against
+ * simulated XY-MD02 sensors and a simulated SSD1306, in virtual time.
+ * The FreeRTOS tasks are not started; instead this driver calls each
+ * task's per-cycle function when it would have woken on the device:
+ * - acquisitionCycle() after its returned wait, or earlier when reply
+ *   bytes arrive (the UART RX notification)
+ * - renderCycle() after its returned wait, unless the firmware found no
+ *   display and runs headless
+ * - the log drain every LOG_DRAIN_INTERVAL_MS (logCycle() when capturing
+ *   binary telemetry)
+ * - gatewayCycle() when a simulated PLC request has gone quiet for the
+ *   UART RX timeout, and every tick while the reply is on the wire
+ * - httpCycle() without waiting on every log drain, serving real
+ *   loopback clients on HTTP_PORT while the simulation runs
+ * - mqttCycle() without waiting every MQTT_POLL_INTERVAL_MS, publishing
+ *   to a simulated broker on MQTT_PORT (lib/NativeHal/SimulatedMqttBroker.h)
+ * and jumps the virtual clock straight to the next wake-up.
+ *
+ * Every gateway reply is checked against the simulated sensors: a
+ * connected sensor's registers must match its true readings and be no
+ * older than the slowest poll interval. At the end it compares what the
+ * devices did with what the firmware counted, checks that the panel
+ * shows the framebuffer, and reports throughput and simulation speed.
+ * Every record queued for MQTT must reach the broker exactly once
+ * (duplicate deliveries aside), including those batched while the broker
+ * was down, and the backlog must drain no faster than MQTT_DRAIN_RATE.
+ * The first valid reading must arrive within SIM_FIRST_READING_LIMIT_MS
+ * of boot. While the first sensor is unplugged it must be parked as offline and
+ * polled no more than the retry policy allows, and be back online soon
+ * after it is reconnected.
+ *
+ * Usage (after `pio run -e native`):
+ *   .pio/build/native/program [--hours N] [--seed N] [--latency-us N]
+ *       [--jitter-us N] [--dropout P] [--crc-errors P] [--exceptions P]
+ *       [--glitches P] [--noise P] [--max-baud N] [--temperature C]
+ *       [--humidity P] [--telemetry FILE] [--serve SECONDS]
+ *       [--broker-outage MINUTES] [--unplug MINUTES] [--external-broker]
+ *       [--no-display] [--verbose]
+ *
+ * --telemetry switches the console to binary mode and writes the frames
+ * to FILE, for tools/telemetry_decode.cpp.
+ * --serve keeps the status server running in real time for SECONDS
+ * after the simulation, on the final readings, for load tests with
+ * tools/http_load.cpp. Each document is also fetched once over loopback
+ * at the end and checked.
+ * --broker-outage takes the simulated broker offline for MINUTES
+ * (default 10) starting a third of the way into the run.
+ * --unplug disconnects the first sensor for MINUTES (default 30)
+ * starting two thirds of the way into the run; 0 keeps it connected.
+ * --no-display leaves the I2C bus empty, as with a missing or broken
+ * SSD1306: the firmware must start headless and keep measuring.
+ * --external-broker publishes to whatever listens on MQTT_PORT, e.g.
+ * `mosquitto -p 18830`, instead; its deliveries are not checked.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <Adafruit_SSD1306.h>
+#include "config.h"
+#include "AdaptiveSampler.h"
+#include "HttpStatusServer.h"
+#include "Logger.h"
+#include "ModbusBaudNegotiator.h"
+#include "ModbusBusScheduler.h"
+#include "ModbusRetryPolicy.h"
+#include "ModbusSlave.h"
+#include "RuleEngine.h"
+#include "RuntimeMetrics.h"
+#include "SampleHistory.h"
+#include "MqttClient.h"
+#include "MqttOutbox.h"
+#include "SimulatedModbusMaster.h"
+#include "SimulatedMqttBroker.h"
+#include "SimulatedSSD1306.h"
+#include "SimulatedXYMD02.h"
+#include "TelemetryFrame.h"
+#include "VirtualClock.h"
+#include "Wire.h"
+
+// Firmware entry points and state (src/main.cpp)
+TickType_t acquisitionCycle();
+TickType_t renderCycle();
+void logCycle();
+TickType_t gatewayCycle(bool lineIdle);
+void httpCycle(uint32_t waitMs);
+TickType_t mqttCycle(uint32_t waitMs);
+extern Adafruit_SSD1306 display;
+extern bool displayPresent;
+extern std::atomic<uint32_t> firstReadingMs;
+extern ModbusBusScheduler sensorBus;
+extern ModbusBaudNegotiator sensorBaud;
+extern ModbusRetryPolicy sensorHealth;
+extern AdaptiveSampler sensorSamplers[];
+extern RuleEngine comfortRules;
+extern ModbusSlave gatewaySlave;
+extern MetricCounter gatewayRequests;
+extern MetricCounter gatewayExceptions;
+extern MetricCounter gatewayIgnored;
+extern HttpStatusServer statusServer;
+extern HttpResponseCache statusDocument;
+extern HttpResponseCache historyDocument;
+extern MetricCounter busTransactions;
+extern MetricCounter busResyncs;
+extern MetricCounter telemetryDrops;
+extern bool mqttActive;
+extern MqttClient mqttClient;
+extern MqttOutbox mqttOutbox;
+extern MetricCounter mqttRecords;
+extern MetricCounter mqttSampleDrops;
+void runSerialCommand(const char *command);
+QueueHandle_t openSampleLogQueue();
+extern MetricCounter sampleLogDrops;
+extern uint32_t sensorRejectedReadings[];
+typedef SampleHistory<HISTORY_RAW_BYTES, HISTORY_MINUTE_SLOTS,
+                      HISTORY_HOUR_SLOTS> SensorHistory;
+extern SensorHistory sensorHistory[];
+
+// Gateway register layout (GatewayRegister in src/main.cpp)
+#define SIM_GATEWAY_REGISTERS    8     // Per sensor
+#define SIM_GATEWAY_TEMPERATURE  0
+#define SIM_GATEWAY_HUMIDITY     1
+#define SIM_GATEWAY_STATUS       5
+#define SIM_GATEWAY_ADDRESS      6
+#define SIM_GATEWAY_AGE          7
+#define SIM_GATEWAY_POLL_US      1000000 // PLC reads the whole map every second
+#define SIM_GATEWAY_PROBE_EVERY  16      // Bad-address and foreign requests
+
+// Readings must follow the device within filter lag (0.1 units)
+#define SIM_GATEWAY_TEMP_TOLERANCE      5
+#define SIM_GATEWAY_HUMIDITY_TOLERANCE  20
+
+// Boot to first valid reading, with the sensor's saved rate unknown
+#define SIM_FIRST_READING_LIMIT_MS  500
+
+// Longest wait for the MQTT backlog to reach the broker after the run
+#define SIM_MQTT_DRAIN_LIMIT_MS  600000
+
+struct SimulatorOptions {
+  double hours;
+  uint32_t seed;
+  bool verbose;
+  const char *telemetryPath;     // Binary console capture, or nullptr
+  double serveSeconds;           // Real-time HTTP serving after the run
+  double brokerOutageMinutes;
+  double unplugMinutes;          // First sensor disconnected for this long
+  bool externalBroker;           // No simulated broker on MQTT_PORT
+  bool noDisplay;                // Nothing answers on the I2C bus
+  XYMD02Behavior behavior;
+};
+
+static uint32_t logLines = 0;
+
+static void printLogLine(const char *line, size_t length) {
+  printf("%.*s\n", (int)length, line);
+  logLines++;
+}
+
+static void countLogLine(const char *line, size_t length) {
+  (void)line;
+  (void)length;
+  logLines++;
+}
+
+/**
+ * Compare a gateway reply with the simulated sensors
+ *
+ * @return Number of sensors whose registers are wrong
+ */
+static uint32_t checkGatewayReply(const SimulatedModbusMaster &master,
+                                  SimulatedXYMD02 *const *sensors,
+                                  size_t sensorCount, uint64_t nowUs,
+                                  bool report) {
+  uint32_t mismatches = 0;
+  const std::vector<uint16_t> &registers = master.registers();
+  for (size_t i = 0; i < sensorCount; i++) {
+    const uint16_t *block = &registers[i * SIM_GATEWAY_REGISTERS];
+    int temperature = (int16_t)block[SIM_GATEWAY_TEMPERATURE];
+    int humidity = (int16_t)block[SIM_GATEWAY_HUMIDITY];
+    int trueTemperature = sensors[i]->temperatureDeci(nowUs);
+    int trueHumidity = sensors[i]->humidityDeci(nowUs);
+    bool wrong = block[SIM_GATEWAY_ADDRESS] != sensors[i]->address();
+    if (block[SIM_GATEWAY_STATUS] & 0x0001) {
+      wrong = wrong ||
+        abs(temperature - trueTemperature) > SIM_GATEWAY_TEMP_TOLERANCE ||
+        abs(humidity - trueHumidity) > SIM_GATEWAY_HUMIDITY_TOLERANCE ||
+        block[SIM_GATEWAY_AGE] > SENSOR_READ_INTERVAL_MAX / 1000 + 2;
+    }
+    if (wrong) {
+      if (report) {
+        printf("FAIL: gateway shows sensor %02X as %d/%d (status %04X, "
+               "age %u s), device reads %d/%d\n", sensors[i]->address(),
+               temperature, humidity, block[SIM_GATEWAY_STATUS],
+               block[SIM_GATEWAY_AGE], trueTemperature, trueHumidity);
+      }
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+/**
+ * GET a path from the firmware's status server over loopback, running
+ * the HTTP task until the response is complete
+ *
+ * @return false unless a 200 response with a complete JSON object came back
+ */
+static bool fetchStatusDocument(const char *path, size_t &bodyLength) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(statusServer.port());
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  char request[96];
+  int requestLength = snprintf(request, sizeof(request),
+    "GET %s HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n", path);
+  send(fd, request, (size_t)requestLength, 0);
+
+  // The server closes the connection after the response
+  static char response[HTTP_RESPONSE_CAPACITY + 1];
+  size_t length = 0;
+  for (int pass = 0; pass < 1000; pass++) {
+    httpCycle(1);
+    ssize_t received = recv(fd, response + length,
+                            sizeof(response) - 1 - length, MSG_DONTWAIT);
+    if (received == 0) {
+      break;
+    }
+    if (received > 0) {
+      length += (size_t)received;
+    }
+  }
+  close(fd);
+  response[length] = '\0';
+
+  const char *body = strstr(response, "\r\n\r\n");
+  const char *declared = strstr(response, "Content-Length: ");
+  if (strncmp(response, "HTTP/1.1 200 ", 13) != 0 || body == nullptr ||
+      declared == nullptr) {
+    return false;
+  }
+  body += 4;
+  bodyLength = length - (size_t)(body - response);
+  return strtoul(declared + 16, nullptr, 10) == bodyLength &&
+         body[0] == '{' && response[length - 1] == '}';
+}
+
+/**
+ * Decode what the simulated broker received and compare it with what
+ * the firmware queued
+ *
+ * @return false if records went missing without being counted as
+ *         dropped, or the backlog was drained too fast
+ */
+static bool checkMqttDelivery(const SimulatedMqttBroker &broker,
+                              bool verbose) {
+  bool ok = true;
+  std::set<std::pair<uint32_t, uint8_t>> frames; // Base time, sequence
+  uint32_t records = 0;
+  uint32_t duplicates = 0;
+  uint32_t badFrames = 0;
+  uint32_t minSpacingMs = UINT32_MAX;
+  uint32_t maxBatchBytes = 0;
+  const std::vector<MqttMessage> &messages = broker.messages();
+  for (size_t m = 0; m < messages.size(); m++) {
+    const MqttMessage &message = messages[m];
+    if (message.topic != MQTT_TOPIC) {
+      badFrames++;
+      continue;
+    }
+    if (m > 0 && message.receivedMs - messages[m - 1].receivedMs <
+                 minSpacingMs) {
+      minSpacingMs = message.receivedMs - messages[m - 1].receivedMs;
+    }
+    if (message.payload.size() > maxBatchBytes) {
+      maxBatchBytes = (uint32_t)message.payload.size();
+    }
+    // Telemetry frames, each ended by a zero delimiter
+    const uint8_t *data = message.payload.data();
+    size_t start = 0;
+    for (size_t i = 0; i < message.payload.size(); i++) {
+      if (data[i] != 0) {
+        continue;
+      }
+      uint8_t buffer[TELEMETRY_MAX_FRAME];
+      TelemetryFrame frame;
+      size_t length = i - start;
+      if (length > 0 && length <= sizeof(buffer) &&
+          TelemetryDecoder::parse(data + start, length, buffer, frame) &&
+          frame.type == TELEMETRY_FRAME_SAMPLES) {
+        if (frames.insert(std::make_pair(frame.baseTimeMs,
+                                         frame.sequence)).second) {
+          records += frame.recordCount;
+        } else {
+          duplicates++;
+        }
+      } else if (length > 0) {
+        badFrames++;
+      }
+      start = i + 1;
+    }
+  }
+
+  const MqttBrokerStats &stats = broker.stats();
+  uint32_t dropped = mqttOutbox.dropped();
+  printf("      broker: %u messages (largest %u bytes), %u records, "
+         "%u duplicate frames; %u batches dropped, %u records lost to a "
+         "full queue\n", stats.publishes, maxBatchBytes, records, duplicates,
+         dropped, mqttSampleDrops.value());
+  if (verbose) {
+    printf("      broker: %u connections, %u pings, closest messages %u ms "
+           "apart\n", stats.connections, stats.pings, minSpacingMs);
+  }
+  if (badFrames > 0 || stats.protocolErrors > 0) {
+    printf("FAIL: broker saw %u bad frames and %u protocol errors\n",
+           badFrames, stats.protocolErrors);
+    ok = false;
+  }
+  if (dropped == 0 && mqttSampleDrops.value() == 0 &&
+      records != mqttRecords.value()) {
+    printf("FAIL: broker received %u of %u records with none dropped\n",
+           records, mqttRecords.value());
+    ok = false;
+  } else if (records > mqttRecords.value()) {
+    printf("FAIL: broker received %u records but only %u were queued\n",
+           records, mqttRecords.value());
+    ok = false;
+  }
+  if (messages.size() > 1 && minSpacingMs < 1000 / MQTT_DRAIN_RATE) {
+    printf("FAIL: batches %u ms apart, faster than %u per second\n",
+           minSpacingMs, MQTT_DRAIN_RATE);
+    ok = false;
+  }
+  return ok;
+}
+
+static bool parseOptions(int argc, char **argv, SimulatorOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *name = argv[i];
+    if (strcmp(name, "--verbose") == 0) {
+      options.verbose = true;
+      continue;
+    }
+    if (strcmp(name, "--external-broker") == 0) {
+      options.externalBroker = true;
+      continue;
+    }
+    if (strcmp(name, "--no-display") == 0) {
+      options.noDisplay = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "Missing value for %s\n", name);
+      return false;
+    }
+    const char *value = argv[++i];
+    if (strcmp(name, "--hours") == 0) {
+      options.hours = atof(value);
+    } else if (strcmp(name, "--seed") == 0) {
+      options.seed = (uint32_t)strtoul(value, nullptr, 0);
+    } else if (strcmp(name, "--latency-us") == 0) {
+      options.behavior.latencyUs = (uint32_t)strtoul(value, nullptr, 0);
+    } else if (strcmp(name, "--jitter-us") == 0) {
+      options.behavior.jitterUs = (uint32_t)strtoul(value, nullptr, 0);
+    } else if (strcmp(name, "--dropout") == 0) {
+      options.behavior.dropoutRate = atof(value);
+    } else if (strcmp(name, "--crc-errors") == 0) {
+      options.behavior.crcErrorRate = atof(value);
+    } else if (strcmp(name, "--exceptions") == 0) {
+      options.behavior.exceptionRate = atof(value);
+    } else if (strcmp(name, "--glitches") == 0) {
+      options.behavior.glitchRate = atof(value);
+    } else if (strcmp(name, "--noise") == 0) {
+      options.behavior.noiseRate = atof(value);
+    } else if (strcmp(name, "--temperature") == 0) {
+      options.behavior.temperature = atof(value);
+    } else if (strcmp(name, "--humidity") == 0) {
+      options.behavior.humidity = atof(value);
+    } else if (strcmp(name, "--serve") == 0) {
+      options.serveSeconds = atof(value);
+    } else if (strcmp(name, "--broker-outage") == 0) {
+      options.brokerOutageMinutes = atof(value);
+    } else if (strcmp(name, "--unplug") == 0) {
+      options.unplugMinutes = atof(value);
+    } else if (strcmp(name, "--telemetry") == 0) {
+      options.telemetryPath = value;
+    } else if (strcmp(name, "--max-baud") == 0) {
+      options.behavior.maxBaudRate = (uint32_t)strtoul(value, nullptr, 0);
+    } else {
+      fprintf(stderr, "Unknown option %s\n", name);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  SimulatorOptions options = {};
+  options.hours = 24.0;
+  options.seed = 1;
+  options.behavior.latencyUs = 15000;   // Typical XY-MD02 turnaround
+  options.behavior.jitterUs = 10000;
+  options.behavior.temperature = 23.0;
+  options.behavior.humidity = 50.0;
+  options.behavior.dailySwing = 4.0;
+  options.brokerOutageMinutes = 10.0;
+  options.unplugMinutes = 30.0;
+  if (!parseOptions(argc, argv, options)) {
+    return 2;
+  }
+
+  // Wire up the simulated hardware before the firmware initializes it
+  const uint8_t addresses[] = SENSOR_ADDRESSES;
+  const size_t sensorCount = sizeof(addresses) / sizeof(addresses[0]);
+  SimulatedModbusBus bus(SENSOR_BAUD_RATE);
+  SimulatedXYMD02 *sensors[sizeof(addresses)];
+  for (size_t i = 0; i < sensorCount; i++) {
+    sensors[i] = new SimulatedXYMD02(addresses[i], options.behavior,
+                                     options.seed + (uint32_t)i);
+    bus.addDevice(sensors[i]);
+  }
+  Serial2.attach(&bus);
+  SimulatedModbusMaster plc(GATEWAY_ADDRESS,
+                            (uint16_t)(sensorCount * SIM_GATEWAY_REGISTERS),
+                            SIM_GATEWAY_POLL_US, SIM_GATEWAY_PROBE_EVERY);
+  if (GATEWAY_ENABLED) {
+    Serial1.attach(&plc);
+  }
+  SimulatedSSD1306 panel(SCREEN_ADDRESS);
+  if (!options.noDisplay) {
+    Wire.attach(&panel);
+  }
+  SimulatedMqttBroker broker(MQTT_PORT);
+  if (!options.externalBroker && MQTT_ENABLED && !broker.setOnline(true)) {
+    fprintf(stderr, "MQTT port %u is in use (try --external-broker)\n",
+            MQTT_PORT);
+    return 2;
+  }
+
+  setup();
+  QueueHandle_t sampleLogQueue = openSampleLogQueue(); // No storage task
+
+  // Capture the console from here on, as a collector would
+  FILE *telemetryFile = nullptr;
+  if (options.telemetryPath != nullptr) {
+    telemetryFile = fopen(options.telemetryPath, "wb");
+    if (telemetryFile == nullptr) {
+      perror(options.telemetryPath);
+      return 2;
+    }
+    Serial.setEchoFile(telemetryFile);
+    runSerialCommand("telemetry binary");
+  }
+
+  LogSink sink = options.verbose ? printLogLine : countLogLine;
+  uint64_t startUs = VirtualClock::nowUs();
+  uint64_t endUs = startUs + (uint64_t)(options.hours * 3600.0 * 1e6);
+  uint64_t nextAcquisitionUs = startUs;
+  uint64_t nextRenderUs = displayPresent ? startUs : UINT64_MAX;
+  uint64_t nextLogUs = startUs;
+  uint64_t nextMqttUs = mqttActive ? startUs : UINT64_MAX;
+  uint64_t outageStartUs = startUs + (endUs - startUs) / 3;
+  uint64_t outageEndUs = outageStartUs +
+                         (uint64_t)(options.brokerOutageMinutes * 60e6);
+  uint64_t unplugStartUs = startUs + (endUs - startUs) * 2 / 3;
+  uint64_t unplugEndUs = unplugStartUs +
+                         (uint64_t)(options.unplugMinutes * 60e6);
+  uint32_t unpluggedPolls = 0;
+  uint64_t nextPlcUs = GATEWAY_ENABLED ? startUs : UINT64_MAX;
+  uint64_t nextGatewayUs = UINT64_MAX;
+  uint64_t gatewayIdleUs = 0;           // Pending RX timeout notification
+  uint32_t gatewayMismatches = 0;
+  uint32_t samplesQueued = 0;
+  uint32_t acquisitionPasses = 0;
+  auto wallStart = std::chrono::steady_clock::now();
+
+  while (VirtualClock::nowUs() < endUs) {
+    uint64_t nowUs = VirtualClock::nowUs();
+    bool plugged = nowUs < unplugStartUs || nowUs >= unplugEndUs;
+    if (plugged != sensors[0]->connected()) {
+      // Polls of the first sensor while it is unplugged, at any rate
+      const ModbusSlaveStatus &first = sensorBus.slave(0);
+      uint32_t polls = first.successCount + first.failureCount;
+      unpluggedPolls = plugged ? polls - unpluggedPolls : polls;
+      sensors[0]->setConnected(plugged);
+    }
+
+    if (nowUs >= nextAcquisitionUs) {
+      nextAcquisitionUs = nowUs + (uint64_t)acquisitionCycle() * 1000;
+      acquisitionPasses++;
+      // Serial2.onReceive() wakes the task as soon as reply bytes arrive
+      uint64_t arrivalUs = bus.nextArrivalUs();
+      if (arrivalUs > nowUs && arrivalUs < nextAcquisitionUs) {
+        nextAcquisitionUs = arrivalUs;
+      }
+    }
+
+    if (nowUs >= nextRenderUs) {
+      nextRenderUs = nowUs + (uint64_t)renderCycle() * 1000;
+    }
+
+    if (nowUs >= nextPlcUs) {
+      nextPlcUs = plc.poll(nowUs);
+      // Serial1.onReceive() fires once the request has gone quiet
+      gatewayIdleUs = plc.requestEndUs() +
+                      (uint64_t)GATEWAY_RX_TIMEOUT_SYMBOLS * plc.charTimeUs();
+      if (gatewayIdleUs < nextGatewayUs) {
+        nextGatewayUs = gatewayIdleUs;
+      }
+    }
+
+    if (nowUs >= nextGatewayUs) {
+      bool lineIdle = gatewayIdleUs != 0 && nowUs >= gatewayIdleUs;
+      if (lineIdle) {
+        gatewayIdleUs = 0;
+      }
+      uint32_t replies = plc.replyCount();
+      TickType_t wait = gatewayCycle(lineIdle);
+      nextGatewayUs = wait == portMAX_DELAY ?
+                      UINT64_MAX : nowUs + (uint64_t)wait * 1000;
+      if (gatewayIdleUs != 0 && gatewayIdleUs < nextGatewayUs) {
+        nextGatewayUs = gatewayIdleUs;
+      }
+      if (plc.replyCount() != replies) {
+        gatewayMismatches += checkGatewayReply(plc, sensors, sensorCount,
+                                               nowUs, gatewayMismatches == 0);
+      }
+    }
+
+    if (nowUs >= nextLogUs) {
+      if (telemetryFile != nullptr) {
+        logCycle();
+      } else {
+        Logger::drain(sink, LOG_RING_RECORDS);
+      }
+      httpCycle(0);
+      // Stand in for the storage task so the sample queue never backs up
+      uint8_t sample[64]; // Larger than any queued item
+      while (xQueueReceive(sampleLogQueue, sample, 0) == pdTRUE) {
+        samplesQueued++;
+      }
+      nextLogUs += (uint64_t)LOG_DRAIN_INTERVAL_MS * 1000;
+    }
+
+    if (nowUs >= nextMqttUs) {
+      if (!options.externalBroker) {
+        broker.setOnline(nowUs < outageStartUs || nowUs >= outageEndUs);
+        broker.poll();
+      }
+      mqttCycle(0);
+      nextMqttUs += (uint64_t)MQTT_POLL_INTERVAL_MS * 1000;
+    }
+
+    uint64_t nextUs = nextAcquisitionUs;
+    if (nextRenderUs < nextUs) {
+      nextUs = nextRenderUs;
+    }
+    if (nextLogUs < nextUs) {
+      nextUs = nextLogUs;
+    }
+    if (nextMqttUs < nextUs) {
+      nextUs = nextMqttUs;
+    }
+    if (nextPlcUs < nextUs) {
+      nextUs = nextPlcUs;
+    }
+    if (nextGatewayUs < nextUs) {
+      nextUs = nextGatewayUs;
+    }
+    VirtualClock::advanceTo(nextUs);
+  }
+  if (telemetryFile != nullptr) {
+    logCycle();
+    runSerialCommand("telemetry text");
+    Serial.setEchoFile(stdout);
+    printf("Telemetry: %ld bytes written to %s, %u records dropped\n",
+           ftell(telemetryFile), options.telemetryPath, telemetryDrops.value());
+    fclose(telemetryFile);
+  }
+  Logger::drain(sink, LOG_RING_RECORDS);
+
+  // Let the MQTT task send the last batch and whatever is still queued
+  if (mqttActive) {
+    uint64_t drainEndUs = VirtualClock::nowUs() +
+                          (uint64_t)SIM_MQTT_DRAIN_LIMIT_MS * 1000;
+    uint64_t batchDueUs = VirtualClock::nowUs() +
+                          (uint64_t)MQTT_PUBLISH_INTERVAL * 1000;
+    while (VirtualClock::nowUs() < drainEndUs &&
+           (VirtualClock::nowUs() <= batchDueUs || mqttOutbox.count() > 0)) {
+      if (!options.externalBroker) {
+        broker.poll();
+      }
+      mqttCycle(0);
+      VirtualClock::advanceUs((uint64_t)MQTT_POLL_INTERVAL_MS * 1000);
+    }
+  }
+
+  if (options.serveSeconds > 0 && statusServer.listening()) {
+    printf("Serving http://127.0.0.1:%u/status for %.0f s\n",
+           statusServer.port(), options.serveSeconds);
+    fflush(stdout);
+    auto serveStart = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         serveStart).count() <
+           options.serveSeconds) {
+      httpCycle(HTTP_POLL_INTERVAL_MS);
+    }
+  }
+
+  double wallSeconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - wallStart).count();
+  double simSeconds = (double)(VirtualClock::nowUs() - startUs) / 1e6;
+
+  // ==================== REPORT ====================
+  bool ok = true;
+  printf("\n=== Simulation: %.1f h in %.2f s (%.0f simulated h per minute) ===\n",
+         simSeconds / 3600.0, wallSeconds,
+         wallSeconds > 0 ? simSeconds / 3600.0 / wallSeconds * 60.0 : 0.0);
+
+  uint32_t totalPolls = 0;
+  uint32_t totalNoisy = 0;
+  for (size_t i = 0; i < sensorCount; i++) {
+    const XYMD02Stats &device = sensors[i]->stats();
+    const ModbusSlaveStatus &firmware = sensorBus.slave((int)i);
+    uint32_t polls = firmware.successCount + firmware.failureCount;
+    uint32_t injected = device.dropouts + device.crcErrors + device.exceptions +
+                        device.unpluggedPolls;
+    totalPolls += polls;
+    totalNoisy += device.noisyReplies;
+
+    printf("Sensor %02X: %u polls (%.2f/s), %u ok, %u failed; "
+           "device: %u valid, %u dropped, %u corrupted, %u exceptions\n",
+           addresses[i], polls, polls / simSeconds, firmware.successCount,
+           firmware.failureCount, device.validReplies, device.dropouts,
+           device.crcErrors, device.exceptions);
+    printf("           response %.1f ms (dev %.1f ms), timeout %u ms\n",
+           firmware.smoothedResponseUs / 1000.0,
+           firmware.responseDeviationUs / 1000.0, firmware.timeoutMs);
+    printf("           %u baud (device %u), %u rate changes\n",
+           sensorBaud.baudRate((int)i), sensors[i]->baudRate(),
+           sensorBaud.slave((int)i).changes);
+    printf("           sampling: %u active, %u flat readings, interval %u ms\n",
+           sensorSamplers[i].activeReadings(), sensorSamplers[i].flatReadings(),
+           sensorSamplers[i].intervalMs());
+    printf("           filters: %u readings rejected, %u glitches injected\n",
+           sensorRejectedReadings[i], device.glitches);
+    if (device.noisyReplies > 0) {
+      printf("           %u replies with stray bytes\n", device.noisyReplies);
+    }
+    const ModbusHealthStatus &health = sensorHealth.slave((int)i);
+    printf("           health: %s, %u fast retries, %u times offline\n",
+           ModbusRetryPolicy::stateName(health.state), health.fastRetries,
+           health.trips);
+
+    // The firmware must end up talking at the rate the device is set to
+    if (sensorBaud.baudRate((int)i) != sensors[i]->baudRate()) {
+      printf("FAIL: sensor %02X is at %u baud but polled at %u\n",
+             addresses[i], sensors[i]->baudRate(), sensorBaud.baudRate((int)i));
+      ok = false;
+    }
+
+    // Spike rejection must drop every glitched reading and nothing else
+    if (sensorRejectedReadings[i] != device.glitches) {
+      printf("FAIL: sensor %02X rejected %u readings for %u glitches\n",
+             addresses[i], sensorRejectedReadings[i], device.glitches);
+      ok = false;
+    }
+
+    // Every valid reply must be accepted and every fault must be caught;
+    // late replies beyond the adaptive timeout show up as extra failures
+    if (firmware.successCount > device.validReplies) {
+      printf("FAIL: sensor %02X accepted %u more replies than were valid\n",
+             addresses[i], firmware.successCount - device.validReplies);
+      ok = false;
+    } else if (firmware.failureCount < injected) {
+      printf("FAIL: sensor %02X missed %u injected faults\n", addresses[i],
+             injected - firmware.failureCount);
+      ok = false;
+    } else if (firmware.successCount < device.validReplies) {
+      printf("           %u valid replies arrived after the timeout\n",
+             device.validReplies - firmware.successCount);
+    }
+  }
+
+  // An unplugged sensor is parked: the backoff steps, then one probe per
+  // SENSOR_PROBE_INTERVAL, instead of a poll every SENSOR_READ_INTERVAL
+  if (options.unplugMinutes > 0 && unplugStartUs < endUs) {
+    uint64_t unpluggedUs = (unplugEndUs < endUs ? unplugEndUs : endUs) -
+                           unplugStartUs;
+    const ModbusSlaveStatus &first = sensorBus.slave(0);
+    uint32_t polls = sensors[0]->connected() ? unpluggedPolls :
+      first.successCount + first.failureCount - unpluggedPolls;
+    uint32_t limit = SENSOR_OFFLINE_AFTER + 1 +
+      (uint32_t)(unpluggedUs / 1000 / SENSOR_PROBE_INTERVAL);
+    printf("Unplugged: sensor %02X for %.0f min, %u polls (limit %u), "
+           "at most %.0f s of bus time\n", addresses[0], unpluggedUs / 60e6, polls,
+           limit, polls * (SENSOR_TIMEOUT / 1000.0));
+    if (polls > limit) {
+      printf("FAIL: unplugged sensor %02X polled %u times, limit %u\n",
+             addresses[0], polls, limit);
+      ok = false;
+    }
+    // Each probe may be at the wrong rate while the negotiator scans
+    uint64_t recoveryUs = (uint64_t)(sensorBaud.rateCount() + 1) *
+                          SENSOR_PROBE_INTERVAL * 1000;
+    if (unplugEndUs < endUs && endUs - unplugEndUs > recoveryUs &&
+        sensorHealth.state(0) != MODBUS_HEALTH_ONLINE) {
+      printf("FAIL: sensor %02X still %s after it was reconnected\n",
+             addresses[0], ModbusRetryPolicy::stateName(sensorHealth.state(0)));
+      ok = false;
+    }
+  }
+
+  // What the "metrics" console command reports at the end of the run
+  uint32_t transactions = busTransactions.value();
+  runSerialCommand("metrics");
+  Logger::drain(printLogLine, LOG_RING_RECORDS);
+  if (transactions != totalPolls) {
+    printf("FAIL: metrics counted %u transactions for %u polls\n",
+           transactions, totalPolls);
+    ok = false;
+  }
+
+  // "history raw" must print every sample the raw tier holds, in order
+  FILE *dump = tmpfile();
+  Serial.setEchoFile(dump);
+  runSerialCommand("history raw");
+  Serial.setEchoFile(stdout);
+  rewind(dump);
+  uint32_t held = 0;
+  uint32_t dumped = 0;
+  uint32_t unordered = 0;
+  for (size_t i = 0; i < sensorCount; i++) {
+    held += sensorHistory[i].rawCount();
+  }
+  char line[64];
+  unsigned lastAddress = 0;
+  unsigned long lastMs = 0;
+  while (fgets(line, sizeof(line), dump) != nullptr) {
+    unsigned address;
+    unsigned long timestampMs;
+    if (sscanf(line, "%u,%lu,", &address, &timestampMs) != 2) {
+      continue; // Header
+    }
+    if (dumped > 0 && address == lastAddress && timestampMs <= lastMs) {
+      unordered++;
+    }
+    lastAddress = address;
+    lastMs = timestampMs;
+    dumped++;
+  }
+  fclose(dump);
+  printf("History: %u raw samples held, %u dumped\n", held, dumped);
+  if (dumped != held || unordered > 0) {
+    printf("FAIL: history dump printed %u of %u raw samples, %u out of "
+           "order\n", dumped, held, unordered);
+    ok = false;
+  }
+
+  // Every reply with stray bytes must be recovered, and nothing else
+  if (busResyncs.value() != totalNoisy) {
+    printf("FAIL: %u replies recovered from stray bytes, %u injected\n",
+           busResyncs.value(), totalNoisy);
+    ok = false;
+  }
+
+  if (GATEWAY_ENABLED) {
+    const ModbusMasterStats &master = plc.stats();
+    const ModbusSlaveStats &slave = gatewaySlave.stats();
+    uint32_t answered = master.replies + master.exceptions;
+    printf("Gateway: %u requests, %u replies, %u exceptions, %u ignored; "
+           "turnaround avg %.2f ms, max %.2f ms\n", master.requests,
+           master.replies, master.exceptions, master.ignored,
+           answered > 0 ? master.totalTurnaroundUs / 1000.0 / answered : 0.0,
+           master.maxTurnaroundUs / 1000.0);
+    if (master.badReplies > 0 || master.missingReplies > 0 ||
+        master.unexpectedReplies > 0) {
+      printf("FAIL: gateway sent %u bad and %u unexpected replies, "
+             "missed %u requests\n", master.badReplies,
+             master.unexpectedReplies, master.missingReplies);
+      ok = false;
+    }
+    if (slave.ignored != master.ignored ||
+        slave.exceptions != master.exceptions ||
+        slave.requests != master.requests - master.ignored) {
+      printf("FAIL: gateway counted %u requests, %u exceptions, %u ignored\n",
+             slave.requests, slave.exceptions, slave.ignored);
+      ok = false;
+    }
+    // What the log and HTTP tasks see must be the gateway task's counts
+    if (gatewayRequests.value() != slave.requests ||
+        gatewayExceptions.value() != slave.exceptions ||
+        gatewayIgnored.value() != slave.ignored) {
+      printf("FAIL: gateway metrics show %u requests, %u exceptions, "
+             "%u ignored\n", gatewayRequests.value(),
+             gatewayExceptions.value(), gatewayIgnored.value());
+      ok = false;
+    }
+    if (gatewayMismatches > 0) {
+      printf("FAIL: %u gateway readings disagreed with the sensors\n",
+             gatewayMismatches);
+      ok = false;
+    }
+  }
+
+  if (statusServer.listening()) {
+    const char *const paths[] = {"/status", "/history", "/health"};
+    for (const char *path : paths) {
+      size_t length = 0;
+      if (!fetchStatusDocument(path, length)) {
+        printf("FAIL: GET %s did not return a complete JSON document\n", path);
+        ok = false;
+      } else if (options.verbose) {
+        printf("      GET %s: %zu bytes\n", path, length);
+      }
+    }
+    const HttpServerStats &http = statusServer.stats();
+    printf("HTTP: %u status and %u history serializations for %u polls; "
+           "%u requests on %u connections, %u errors\n",
+           statusDocument.versions(), historyDocument.versions(),
+           transactions, http.requests, http.connections, http.errors);
+  } else if (HTTP_ENABLED && HTTP_BIND_LOOPBACK) {
+    printf("FAIL: HTTP status server is not listening on port %u\n",
+           HTTP_PORT);
+    ok = false;
+  }
+
+  if (mqttActive) {
+    const MqttClientStats &client = mqttClient.stats();
+    printf("MQTT: %u records queued, %u batches published, %u acknowledged; "
+           "%u connects, %u failed attempts, %u disconnects\n",
+           mqttRecords.value(), client.published, client.acknowledged,
+           client.connects, client.failures, client.disconnects);
+    if (!options.externalBroker &&
+        !checkMqttDelivery(broker, options.verbose)) {
+      ok = false;
+    }
+  } else if (MQTT_ENABLED && MQTT_BROKER[0] != '\0') {
+    printf("FAIL: MQTT publisher did not start for broker %s\n", MQTT_BROKER);
+    ok = false;
+  }
+
+  printf("Comfort rules: %u evaluations, %u state changes\n",
+         comfortRules.evaluations(), comfortRules.transitions());
+
+  const TwoWireStats &i2c = Wire.stats();
+  printf("Bus: %u frames sent, %.2f polls/s total; acquisition woke "
+         "%.2f times/s\n", bus.framesSent(), totalPolls / simSeconds,
+         acquisitionPasses / simSeconds);
+  printf("Display: %u I2C transactions, %u bytes, %.1f s on the wire, "
+         "%u overflows\n", i2c.transactions, i2c.bytes,
+         i2c.busTimeUs / 1e6, i2c.overflows);
+  printf("Logging: %u lines, %u records dropped; %u samples queued, "
+         "%u dropped\n", logLines, Logger::dropped(), samplesQueued,
+         sampleLogDrops.value());
+
+  // A startup that blocks on the display or the splash screen shows up
+  // here as seconds instead of one or two transactions
+  uint32_t firstMs = firstReadingMs.load();
+  printf("Boot: first reading %u ms after boot, display %s\n", firstMs,
+         displayPresent ? "present" : "missing (headless)");
+  if (firstMs == 0 || firstMs > SIM_FIRST_READING_LIMIT_MS) {
+    printf("FAIL: first reading took %u ms, limit %u ms\n", firstMs,
+           SIM_FIRST_READING_LIMIT_MS);
+    ok = false;
+  }
+  if (displayPresent == options.noDisplay) {
+    printf("FAIL: display %s but firmware reports it %s\n",
+           options.noDisplay ? "missing" : "attached",
+           displayPresent ? "present" : "missing");
+    ok = false;
+  } else if (!displayPresent && i2c.transactions > 1) {
+    printf("FAIL: %u I2C transactions after the display probe failed\n",
+           i2c.transactions - 1);
+    ok = false;
+  }
+  if (displayPresent && !panel.matches(display.getBuffer())) {
+    printf("FAIL: panel RAM differs from the framebuffer\n");
+    ok = false;
+  }
+  if (i2c.overflows > 0) {
+    printf("FAIL: I2C transactions exceeded the %d-byte buffer\n",
+           I2C_BUFFER_LENGTH);
+    ok = false;
+  }
+
+  printf(ok ? "PASS\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
@@ -5,11 +5,11 @@
  */
 
 #include <Arduino.h>
+#include "ModbusCRC.h"
 
 // Function declarations
 void testSensor(uint8_t address);
 void loopbackTest();
-uint16_t calculateCRC(uint8_t *data, uint8_t length);
 
 // Pin definitions (same as your main project)
 #define RS485_RX_PIN 16     // GPIO16 - Connect to RXD of RS485 module
@@ -53,7 +53,7 @@ void loop() {
 void testSensor(uint8_t address) {
   // Calculate CRC for the command
   uint8_t command[6] = {address, 0x03, 0x00, 0x00, 0x00, 0x02};
-  uint16_t crc = calculateCRC(command, 6);
+  uint16_t crc = ModbusCRC::compute(command, 6);
   
   uint8_t fullCommand[8];
   memcpy(fullCommand, command, 6);
@@ -127,19 +127,3 @@ void loopbackTest() {
     Serial.println("❌ No loopback detected");
   }
 }
-
-// Simple CRC calculation for Modbus
-uint16_t calculateCRC(uint8_t *data, uint8_t length) {
-  uint16_t crc = 0xFFFF;
-  for (uint8_t i = 0; i < length; i++) {
-    crc ^= data[i];
-    for (uint8_t j = 0; j < 8; j++) {
-      if (crc & 0x0001) {
-        crc = (crc >> 1) ^ 0xA001;
-      } else {
-        crc >>= 1;
-      }
-    }
-  }
-  return crc;
-}
@@ -0,0 +1,99 @@
+/**
+ * ESP32 Room Climate Monitor - CRC-16/Modbus Host Microbenchmark
+ *
+ * Compares the bitwise, table-driven and slice-by-4/8 CRC engines from
+ * lib/ModbusRTU on large buffers and checks that they all agree.
+ *
+ * Build and run on Linux from the project root:
+ *   g++ -O2 -std=c++17 -Ilib/ModbusRTU tools/crc_bench.cpp \
+ *       lib/ModbusRTU/ModbusCRC.cpp -o crc_bench && ./crc_bench
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "ModbusCRC.h"
+
+typedef uint16_t (*CrcFunction)(uint16_t, const uint8_t *, size_t);
+
+struct Variant {
+  const char *name;
+  CrcFunction function;
+};
+
+/**
+ * Time one CRC variant over the buffer and print its throughput
+ *
+ * @return CRC of the buffer, used to cross-check the variants
+ */
+static uint16_t runVariant(const Variant &variant,
+                           const std::vector<uint8_t> &buffer, int rounds) {
+  uint16_t crc = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    crc = variant.function(MODBUS_CRC_INITIAL, buffer.data(), buffer.size());
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  double megabytes = (double)buffer.size() * rounds / (1024.0 * 1024.0);
+  printf("%-8s  CRC %04X  %8.1f MB/s  %6.2f ns/byte\n", variant.name, crc,
+         megabytes / seconds,
+         seconds * 1e9 / ((double)buffer.size() * rounds));
+  return crc;
+}
+
+int main(int argc, char **argv) {
+  size_t bufferSize = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1 << 20;
+  int rounds = argc > 2 ? atoi(argv[2]) : 64;
+
+  // Standard check value: CRC-16/MODBUS("123456789") = 0x4B37
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  if (ModbusCRC::compute(check, sizeof(check)) != 0x4B37) {
+    printf("FAIL: check value mismatch\n");
+    return 1;
+  }
+
+  std::vector<uint8_t> buffer(bufferSize);
+  srand(12345);
+  for (auto &value : buffer) {
+    value = (uint8_t)rand();
+  }
+
+  const Variant variants[] = {
+    {"bitwise", ModbusCRC::updateBitwise},
+    {"table", static_cast<CrcFunction>(ModbusCRC::update)},
+    {"slice4", ModbusCRC::updateSlice4},
+    {"slice8", ModbusCRC::updateSlice8},
+  };
+
+  printf("Buffer: %zu bytes x %d rounds\n", bufferSize, rounds);
+  uint16_t reference = 0;
+  bool agree = true;
+  for (size_t i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+    uint16_t crc = runVariant(variants[i], buffer, rounds);
+    if (i == 0) {
+      reference = crc;
+    } else if (crc != reference) {
+      agree = false;
+    }
+  }
+
+  // Unaligned tails must match too
+  for (size_t length = 0; length < 64; length++) {
+    const uint8_t *data = buffer.data() + 1;
+    uint16_t expected = ModbusCRC::updateBitwise(MODBUS_CRC_INITIAL, data, length);
+    if (ModbusCRC::updateSlice4(MODBUS_CRC_INITIAL, data, length) != expected ||
+        ModbusCRC::updateSlice8(MODBUS_CRC_INITIAL, data, length) != expected) {
+      agree = false;
+    }
+  }
+
+  printf(agree ? "All variants agree\n" : "FAIL: variants disagree\n");
+  return agree ? 0 : 1;
+}
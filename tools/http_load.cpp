@@ -0,0 +1,162 @@
+/**
+ * ESP32 Room Climate Monitor - HTTP Status Load Generator
+ *
+ * Hammers one path of the status server with keep-alive GETs from
+ * several connections at once, each sending its next request as soon as
+ * the previous response is complete, and reports requests per second
+ * and response latency. Point it at the native build serving loopback:
+ *
+ *   .pio/build/native/program --hours 1 --serve 30 &
+ *   g++ -O2 -std=c++17 tools/http_load.cpp -o http_load
+ *   ./http_load [port] [path] [connections] [seconds]
+ *
+ * Defaults: 8080 /status 4 10. Use no more connections than the
+ * server's HTTP_MAX_CLIENTS; the rest would wait in its backlog.
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+struct Connection {
+  int fd;
+  std::vector<char> response;
+  Clock::time_point sentAt;
+};
+
+static int openConnection(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+    perror("connect");
+    exit(2);
+  }
+  int noDelay = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  return fd;
+}
+
+/**
+ * Length of the first complete response in the buffer, 0 if incomplete
+ */
+static size_t completeResponse(const std::vector<char> &data) {
+  const char *begin = data.data();
+  const char *end = begin + data.size();
+  const char marker[] = "\r\n\r\n";
+  const char *body = std::search(begin, end, marker, marker + 4);
+  if (body == end) {
+    return 0;
+  }
+  body += 4;
+  const char field[] = "Content-Length: ";
+  const char *declared = std::search(begin, body, field, field + 16);
+  size_t length = declared == body ? 0 : strtoul(declared + 16, nullptr, 10);
+  size_t total = (size_t)(body - begin) + length;
+  return data.size() >= total ? total : 0;
+}
+
+int main(int argc, char **argv) {
+  uint16_t port = argc > 1 ? (uint16_t)atoi(argv[1]) : 8080;
+  const char *path = argc > 2 ? argv[2] : "/status";
+  int connectionCount = argc > 3 ? atoi(argv[3]) : 4;
+  double seconds = argc > 4 ? atof(argv[4]) : 10.0;
+
+  char request[256];
+  int requestLength = snprintf(request, sizeof(request),
+    "GET %s HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", path);
+
+  std::vector<Connection> connections(connectionCount);
+  std::vector<struct pollfd> fds(connectionCount);
+  for (int i = 0; i < connectionCount; i++) {
+    connections[i].fd = openConnection(port);
+    fds[i].fd = connections[i].fd;
+    fds[i].events = POLLIN;
+  }
+
+  std::vector<double> latenciesUs;
+  uint32_t errors = 0;
+  uint64_t bytes = 0;
+  auto start = Clock::now();
+  auto end = start + std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double>(seconds));
+  for (Connection &connection : connections) {
+    connection.sentAt = Clock::now();
+    send(connection.fd, request, (size_t)requestLength, MSG_NOSIGNAL);
+  }
+
+  char buffer[4096];
+  while (Clock::now() < end) {
+    if (::poll(fds.data(), fds.size(), 100) <= 0) {
+      continue;
+    }
+    for (int i = 0; i < connectionCount; i++) {
+      if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+        continue;
+      }
+      Connection &connection = connections[i];
+      ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+      if (received <= 0) {
+        // Closed by the server: count it and reconnect
+        errors++;
+        close(connection.fd);
+        connection.fd = fds[i].fd = openConnection(port);
+        connection.response.clear();
+      } else {
+        connection.response.insert(connection.response.end(), buffer,
+                                   buffer + received);
+        size_t length = completeResponse(connection.response);
+        if (length == 0) {
+          continue;
+        }
+        auto now = Clock::now();
+        latenciesUs.push_back(
+          std::chrono::duration<double, std::micro>(now - connection.sentAt)
+            .count());
+        if (strncmp(connection.response.data(), "HTTP/1.1 200 ", 13) != 0) {
+          errors++;
+        }
+        bytes += length;
+        connection.response.erase(connection.response.begin(),
+                                  connection.response.begin() + length);
+      }
+      connection.sentAt = Clock::now();
+      send(connection.fd, request, (size_t)requestLength, MSG_NOSIGNAL);
+    }
+  }
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::sort(latenciesUs.begin(), latenciesUs.end());
+  size_t count = latenciesUs.size();
+  printf("%s: %zu responses in %.1f s = %.0f requests/s, %.1f MB/s, "
+         "%u errors\n", path, count, elapsed, count / elapsed,
+         bytes / elapsed / 1e6, errors);
+  if (count > 0) {
+    printf("latency p50 %.0f us, p99 %.0f us, max %.0f us\n",
+           latenciesUs[count / 2], latenciesUs[count * 99 / 100],
+           latenciesUs[count - 1]);
+  }
+  for (Connection &connection : connections) {
+    close(connection.fd);
+  }
+  return errors == 0 ? 0 : 1;
+}
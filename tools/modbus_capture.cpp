@@ -0,0 +1,474 @@
+/**
+ * ESP32 Room Climate Monitor - RS485 Capture and Decoder Replay
+ *
+ * Records the raw bytes on an RS485 line (USB adapter listening on the
+ * sensor bus) to a capture file, or generates a synthetic one, and
+ * replays captures through ModbusFrameDecoder at full speed to measure
+ * frames per second and how well it resynchronizes:
+ *
+ *   modbus_capture record DEVICE BAUD SECONDS FILE
+ *   modbus_capture generate FILE [FRAMES] [NOISE]
+ *   modbus_capture replay FILE [PASSES]
+ *
+ * A capture keeps the bytes in the chunks they were read in, each with
+ * the line silence before it, so replay feeds the decoder exactly as the
+ * UART delivered them and reports the 3.5-character gaps it saw.
+ *
+ * generate writes FRAMES XY-MD02 style replies (reads, write echoes and
+ * exceptions) and, with probability NOISE (default 0.2) before each,
+ * something the decoder must skip: random bytes, a request echo, a
+ * truncated or a corrupted frame. Frames often follow each other
+ * without a gap. Each good frame carries its index, so replay of a
+ * generated capture counts recovered, missed and false frames exactly;
+ * for recorded captures it reports what it found.
+ *
+ * File layout (little-endian): "MBCAP1\0\0", baud u32, generated frames
+ * u32 (0 for recordings), exceptions u32; then per chunk the silence
+ * before it in microseconds u32, length u16 and the bytes.
+ *
+ * Build on Linux from the project root:
+ *   g++ -O2 -std=c++17 -Ilib/ModbusRTU tools/modbus_capture.cpp \
+ *       lib/ModbusRTU/ModbusFrameDecoder.cpp \
+ *       lib/ModbusRTU/ModbusTransaction.cpp lib/ModbusRTU/ModbusCRC.cpp \
+ *       -o modbus_capture
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#include "ModbusCRC.h"
+#include "ModbusFrameDecoder.h"
+#include "ModbusTransaction.h"
+
+#define CAPTURE_MAGIC        "MBCAP1\0\0"
+#define CAPTURE_MAGIC_LENGTH 8
+#define GENERATED_ADDRESS    0x01
+#define MAX_CHUNK            64
+
+typedef std::chrono::steady_clock Clock;
+
+struct CaptureHeader {
+  uint32_t baudRate;
+  uint32_t frames;           // Indexed frames generated (0 = recording)
+  uint32_t exceptions;       // Exception frames generated
+};
+
+struct Chunk {
+  uint32_t silenceUs;        // Line idle time before the first byte
+  std::vector<uint8_t> bytes;
+};
+
+// ==================== FILE FORMAT ====================
+
+static void putU32(FILE *file, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static bool getU32(FILE *file, uint32_t &value) {
+  uint8_t bytes[4];
+  if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) {
+    return false;
+  }
+  value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+          ((uint32_t)bytes[3] << 24);
+  return true;
+}
+
+static void writeHeader(FILE *file, const CaptureHeader &header) {
+  fwrite(CAPTURE_MAGIC, 1, CAPTURE_MAGIC_LENGTH, file);
+  putU32(file, header.baudRate);
+  putU32(file, header.frames);
+  putU32(file, header.exceptions);
+}
+
+static void writeChunk(FILE *file, uint32_t silenceUs, const uint8_t *bytes,
+                       size_t length) {
+  putU32(file, silenceUs);
+  uint8_t size[2] = {(uint8_t)length, (uint8_t)(length >> 8)};
+  fwrite(size, 1, sizeof(size), file);
+  fwrite(bytes, 1, length, file);
+}
+
+static bool readCapture(const char *path, CaptureHeader &header,
+                        std::vector<Chunk> &chunks) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    perror(path);
+    return false;
+  }
+  char magic[CAPTURE_MAGIC_LENGTH];
+  bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+            memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) == 0 &&
+            getU32(file, header.baudRate) && getU32(file, header.frames) &&
+            getU32(file, header.exceptions);
+  if (!ok) {
+    fprintf(stderr, "%s: not a capture file\n", path);
+  }
+  Chunk chunk;
+  uint8_t size[2];
+  while (ok && getU32(file, chunk.silenceUs) &&
+         fread(size, 1, sizeof(size), file) == sizeof(size)) {
+    chunk.bytes.resize(size[0] | (size[1] << 8));
+    if (fread(chunk.bytes.data(), 1, chunk.bytes.size(), file) !=
+        chunk.bytes.size()) {
+      fprintf(stderr, "%s: truncated chunk\n", path);
+      break;
+    }
+    chunks.push_back(chunk);
+  }
+  fclose(file);
+  return ok;
+}
+
+// ==================== RECORD ====================
+
+static speed_t termiosSpeed(uint32_t baudRate) {
+  switch (baudRate) {
+    case 4800: return B4800;
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    default: return 0;
+  }
+}
+
+static int record(const char *device, uint32_t baudRate, double seconds,
+                  const char *path) {
+  speed_t speed = termiosSpeed(baudRate);
+  if (speed == 0) {
+    fprintf(stderr, "Unsupported baud rate %u\n", baudRate);
+    return 2;
+  }
+  int fd = open(device, O_RDONLY | O_NOCTTY);
+  struct termios settings;
+  if (fd < 0 || tcgetattr(fd, &settings) < 0) {
+    perror(device);
+    return 2;
+  }
+  cfmakeraw(&settings);
+  cfsetispeed(&settings, speed);
+  cfsetospeed(&settings, speed);
+  settings.c_cflag |= CLOCAL | CREAD;
+  settings.c_cc[VMIN] = 0;
+  settings.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &settings);
+  tcflush(fd, TCIFLUSH);
+
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    perror(path);
+    return 2;
+  }
+  CaptureHeader header = {baudRate, 0, 0};
+  writeHeader(file, header);
+
+  uint32_t charTimeUs = ModbusTransaction::charTimeForBaudRate(baudRate);
+  uint64_t bytes = 0;
+  uint32_t chunks = 0;
+  auto start = Clock::now();
+  auto lastByte = start;
+  while (std::chrono::duration<double>(Clock::now() - start).count() <
+         seconds) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(fd, &readable);
+    struct timeval timeout = {0, 100000};
+    if (select(fd + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+      continue;
+    }
+    uint8_t buffer[MAX_CHUNK];
+    ssize_t received = read(fd, buffer, sizeof(buffer));
+    if (received <= 0) {
+      continue;
+    }
+    // The bytes were on the wire just before the read returned
+    auto now = Clock::now();
+    int64_t idleUs = std::chrono::duration_cast<std::chrono::microseconds>(
+      now - lastByte).count() - (int64_t)received * charTimeUs;
+    writeChunk(file, idleUs > 0 ? (uint32_t)idleUs : 0, buffer,
+               (size_t)received);
+    lastByte = now;
+    bytes += (uint64_t)received;
+    chunks++;
+  }
+  fclose(file);
+  close(fd);
+  printf("Recorded %llu bytes in %u chunks to %s\n",
+         (unsigned long long)bytes, chunks, path);
+  return 0;
+}
+
+// ==================== GENERATE ====================
+
+static uint32_t rngState = 1;
+
+static uint32_t randomBelow(uint32_t limit) {
+  // xorshift32
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState % limit;
+}
+
+static void appendFrame(std::vector<uint8_t> &stream,
+                        std::vector<uint8_t> frame) {
+  frame.resize(frame.size() + 2);
+  ModbusCRC::append(frame.data(), frame.size() - 2);
+  stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+/**
+ * One frame the decoder must find; the index goes in its first word
+ *
+ * @return true for an exception frame, which carries no index
+ */
+static bool appendGoodFrame(std::vector<uint8_t> &stream, uint32_t index) {
+  uint8_t high = (uint8_t)(index >> 8);
+  uint8_t low = (uint8_t)index;
+  uint32_t kind = randomBelow(10);
+  if (kind < 8) {
+    // Temperature and humidity read, sometimes with the configuration
+    uint8_t words = kind < 6 ? 2 : 4;
+    std::vector<uint8_t> frame = {GENERATED_ADDRESS, 0x04,
+                                  (uint8_t)(words * 2), high, low};
+    for (uint8_t i = 1; i < words; i++) {
+      frame.push_back((uint8_t)randomBelow(4));
+      frame.push_back((uint8_t)randomBelow(256));
+    }
+    appendFrame(stream, frame);
+    return false;
+  }
+  if (kind < 9) {
+    appendFrame(stream, {GENERATED_ADDRESS, 0x06, 0x01, 0x02, high, low});
+    return false;
+  }
+  appendFrame(stream, {GENERATED_ADDRESS, 0x84, 0x04});
+  return true;
+}
+
+/**
+ * Bytes the decoder must skip
+ */
+static void appendNoise(std::vector<uint8_t> &stream) {
+  switch (randomBelow(4)) {
+    case 0: { // Line noise
+      uint32_t count = 1 + randomBelow(8);
+      for (uint32_t i = 0; i < count; i++) {
+        stream.push_back((uint8_t)randomBelow(256));
+      }
+      break;
+    }
+    case 1: // Echo of a read request
+      appendFrame(stream, {GENERATED_ADDRESS, 0x04, 0x00, 0x01, 0x00, 0x02});
+      break;
+    case 2: { // Reply cut short
+      std::vector<uint8_t> frame;
+      appendFrame(frame, {GENERATED_ADDRESS, 0x04, 0x04, 0xFF, 0xFF,
+                          (uint8_t)randomBelow(256), 0x00});
+      stream.insert(stream.end(), frame.begin(),
+                    frame.begin() + 1 + randomBelow(frame.size() - 1));
+      break;
+    }
+    default: { // Reply with a bit flipped
+      std::vector<uint8_t> frame;
+      appendFrame(frame, {GENERATED_ADDRESS, 0x04, 0x04, 0xFF, 0xFF,
+                          (uint8_t)randomBelow(256), 0x00});
+      frame[randomBelow(frame.size())] ^= (uint8_t)(1 << randomBelow(8));
+      stream.insert(stream.end(), frame.begin(), frame.end());
+      break;
+    }
+  }
+}
+
+static int generate(const char *path, uint32_t frames, double noise) {
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    perror(path);
+    return 2;
+  }
+  const uint32_t baudRate = 19200;
+  uint32_t gapUs = ModbusTransaction::silenceForBaudRate(baudRate) * 2;
+  CaptureHeader header = {baudRate, frames, 0};
+  writeHeader(file, header);
+  std::vector<uint8_t> stream;
+  uint32_t noisy = 0;
+  uint32_t index = 0;
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    stream.clear();
+    if (randomBelow(1000000) < (uint32_t)(noise * 1000000)) {
+      appendNoise(stream);
+      noisy++;
+    }
+    if (appendGoodFrame(stream, index)) {
+      header.exceptions++;
+    } else {
+      index++;
+    }
+    // Chunks as a UART FIFO hands them out; often no gap before the
+    // next frame
+    bool gap = randomBelow(10) < 7;
+    size_t position = 0;
+    while (position < stream.size()) {
+      size_t length = 1 + randomBelow(16);
+      if (length > stream.size() - position) {
+        length = stream.size() - position;
+      }
+      writeChunk(file, position == 0 && gap ? gapUs : 0,
+                 stream.data() + position, length);
+      position += length;
+    }
+    bytes += stream.size();
+  }
+  // The exception count is known now
+  fseek(file, 0, SEEK_SET);
+  writeHeader(file, header);
+  fclose(file);
+  printf("Generated %u frames (%u exceptions), %u with noise, "
+         "%llu bytes in %s\n", frames, header.exceptions, noisy,
+         (unsigned long long)bytes, path);
+  return 0;
+}
+
+// ==================== REPLAY ====================
+
+struct ReplayResult {
+  uint32_t frames;
+  uint32_t gaps;
+  uint32_t recovered;        // Generated frames found, in order
+  uint32_t missed;
+  uint32_t falseFrames;      // Frames that were never generated
+  uint32_t exceptions;
+};
+
+static void checkFrame(const ModbusFrameView &frame,
+                       const CaptureHeader &header, uint32_t &nextIndex,
+                       ReplayResult &result) {
+  result.frames++;
+  if (header.frames == 0) {
+    return;
+  }
+  if (frame.exception) {
+    result.exceptions++;
+    return;
+  }
+  uint32_t index = frame.function == 0x06 ?
+    (uint32_t)((frame.data[4] << 8) | frame.data[5]) :
+    (uint32_t)((frame.data[3] << 8) | frame.data[4]);
+  // Indices are 16 bits; the generator counts on past 65535
+  uint32_t expected = nextIndex & 0xFFFF;
+  uint32_t skipped = (index - expected) & 0xFFFF;
+  if (frame.address != GENERATED_ADDRESS || skipped > 64) {
+    result.falseFrames++;
+    return;
+  }
+  result.missed += skipped;
+  result.recovered++;
+  nextIndex += skipped + 1;
+}
+
+static ReplayResult replayOnce(const std::vector<Chunk> &chunks,
+                               const CaptureHeader &header,
+                               ModbusFrameDecoder &decoder) {
+  ReplayResult result = {};
+  uint32_t silenceUs = ModbusTransaction::silenceForBaudRate(header.baudRate);
+  uint32_t nextIndex = 0;
+  ModbusFrameView frame;
+  decoder.reset();
+  for (const Chunk &chunk : chunks) {
+    if (chunk.silenceUs >= silenceUs) {
+      decoder.endOfFrame();
+      result.gaps++;
+    }
+    size_t position = 0;
+    do {
+      while (decoder.next(frame)) {
+        checkFrame(frame, header, nextIndex, result);
+      }
+      position += decoder.feed(chunk.bytes.data() + position,
+                               chunk.bytes.size() - position);
+    } while (position < chunk.bytes.size());
+  }
+  decoder.endOfFrame();
+  while (decoder.next(frame)) {
+    checkFrame(frame, header, nextIndex, result);
+  }
+  if (header.frames > 0) {
+    result.missed += header.frames - header.exceptions - nextIndex;
+  }
+  return result;
+}
+
+static int replay(const char *path, int passes) {
+  CaptureHeader header;
+  std::vector<Chunk> chunks;
+  if (!readCapture(path, header, chunks)) {
+    return 2;
+  }
+  uint64_t bytes = 0;
+  for (const Chunk &chunk : chunks) {
+    bytes += chunk.bytes.size();
+  }
+
+  ModbusFrameDecoder decoder;
+  ReplayResult result = {};
+  auto start = Clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    result = replayOnce(chunks, header, decoder);
+  }
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+  const ModbusDecoderStats &stats = decoder.stats();
+  printf("%s: %llu bytes in %zu chunks at %u baud, %u line gaps\n", path,
+         (unsigned long long)bytes, chunks.size(), header.baudRate,
+         result.gaps);
+  printf("Decoded %u frames (%u exceptions), skipped %u bytes in %u "
+         "resyncs per pass\n", result.frames, stats.exceptions / passes,
+         stats.bytesSkipped / passes, stats.resyncs / passes);
+  printf("%d passes in %.3f s: %.0f frames/s, %.1f MB/s\n", passes, elapsed,
+         result.frames * (double)passes / elapsed,
+         bytes * (double)passes / elapsed / 1e6);
+  if (header.frames == 0) {
+    return 0;
+  }
+  printf("Recovered %u of %u frames (%.3f%%) and %u of %u exceptions; "
+         "%u missed, %u false\n", result.recovered,
+         header.frames - header.exceptions,
+         100.0 * result.recovered / (header.frames - header.exceptions),
+         result.exceptions, header.exceptions, result.missed,
+         result.falseFrames);
+  return result.missed == 0 && result.falseFrames == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  const char *mode = argc > 1 ? argv[1] : "";
+  if (strcmp(mode, "record") == 0 && argc > 5) {
+    return record(argv[2], (uint32_t)atoi(argv[3]), atof(argv[4]), argv[5]);
+  }
+  if (strcmp(mode, "generate") == 0 && argc > 2) {
+    return generate(argv[2], argc > 3 ? (uint32_t)atoi(argv[3]) : 100000,
+                    argc > 4 ? atof(argv[4]) : 0.2);
+  }
+  if (strcmp(mode, "replay") == 0 && argc > 2) {
+    return replay(argv[2], argc > 3 ? atoi(argv[3]) : 10);
+  }
+  fprintf(stderr, "Usage: %s record DEVICE BAUD SECONDS FILE\n"
+                  "       %s generate FILE [FRAMES] [NOISE]\n"
+                  "       %s replay FILE [PASSES]\n", argv[0], argv[0],
+          argv[0]);
+  return 2;
+}
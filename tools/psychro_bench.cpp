@@ -0,0 +1,197 @@
+/**
+ * ESP32 Room Climate Monitor - Psychrometrics Accuracy Check and Benchmark
+ *
+ * Evaluates the table-based dew point, heat index and absolute humidity
+ * from lib/Psychrometrics at every 0.1 step of the XY-MD02 range
+ * (-40..60 °C, 0..100 %RH) against the same formulas computed with libm
+ * in double precision, reports the worst errors, and times both the
+ * tables and a single-precision libm version (logf/expf, as firmware
+ * would otherwise call them per sample). A desktop libm is heavily
+ * optimised, so the speed-up measured here is a lower bound for the
+ * ESP32, whose logf/expf are plain software routines.
+ *
+ * Build and run on Linux from the project root:
+ *   g++ -O2 -std=c++17 -Ilib/Psychrometrics tools/psychro_bench.cpp \
+ *       lib/Psychrometrics/Psychrometrics.cpp -o psychro_bench && ./psychro_bench
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "Psychrometrics.h"
+
+#define BENCH_TEMP_MIN      -400   // 0.1 °C
+#define BENCH_TEMP_MAX      600
+#define BENCH_HUMIDITY_MAX  1000   // 0.1 %RH
+
+// Error limits documented in Psychrometrics.h: results in deci-units,
+// saturation pressure relative
+#define LIMIT_DEW_POINT          1.0
+#define LIMIT_HEAT_INDEX         1.0
+#define LIMIT_ABSOLUTE_HUMIDITY  1.0
+#define LIMIT_SATURATION         0.002
+
+// Reference values in plain units
+struct Reference {
+  double dewPoint;
+  double heatIndex;
+  double absoluteHumidity;
+};
+
+static double referenceHeatIndex(double celsius, double rh) {
+  double t = celsius * 1.8 + 32.0;
+  double index = 0.5 * (t + 61.0 + (t - 68.0) * 1.2 + rh * 0.094);
+  if ((index + t) / 2.0 >= 80.0) {
+    index = -42.379 + 2.04901523 * t + 10.14333127 * rh -
+            0.22475541 * t * rh - 0.00683783 * t * t -
+            0.05481717 * rh * rh + 0.00122874 * t * t * rh +
+            0.00085282 * t * rh * rh - 0.00000199 * t * t * rh * rh;
+    if (rh < 13.0 && t >= 80.0 && t <= 112.0) {
+      index -= (13.0 - rh) / 4.0 * std::sqrt((17.0 - std::fabs(t - 95.0)) / 17.0);
+    } else if (rh > 85.0 && t >= 80.0 && t <= 87.0) {
+      index += (rh - 85.0) / 10.0 * ((87.0 - t) / 5.0);
+    }
+  }
+  return (index - 32.0) / 1.8;
+}
+
+static Reference reference(int16_t temperature, int16_t humidity) {
+  double t = temperature / 10.0;
+  double rh = humidity / 10.0;
+  double saturation = PSYCHRO_MAGNUS_A *
+    std::exp(PSYCHRO_MAGNUS_B * t / (PSYCHRO_MAGNUS_C + t));
+  double pressure = saturation * rh / 100.0;
+
+  Reference result;
+  if (pressure > 0) {
+    double gamma = std::log(pressure / PSYCHRO_MAGNUS_A);
+    result.dewPoint = PSYCHRO_MAGNUS_C * gamma / (PSYCHRO_MAGNUS_B - gamma);
+  } else {
+    result.dewPoint = -INFINITY;
+  }
+  result.heatIndex = referenceHeatIndex(t, rh);
+  result.absoluteHumidity = 216.68 * pressure / (t + 273.15);
+  return result;
+}
+
+// What the firmware would run without the tables
+static PsychroMetrics libmDerive(int16_t temperature, int16_t humidity) {
+  float t = temperature * 0.1f;
+  float pressure = (float)PSYCHRO_MAGNUS_A *
+    expf((float)PSYCHRO_MAGNUS_B * t / ((float)PSYCHRO_MAGNUS_C + t)) *
+    humidity * 0.001f;
+  float gamma = logf(pressure / (float)PSYCHRO_MAGNUS_A);
+
+  PsychroMetrics metrics;
+  metrics.dewPoint = (int16_t)lroundf(10.0f * (float)PSYCHRO_MAGNUS_C * gamma /
+                                      ((float)PSYCHRO_MAGNUS_B - gamma));
+  metrics.heatIndex = Psychrometrics::heatIndex(temperature, humidity);
+  metrics.absoluteHumidity = (int16_t)lroundf(2166.8f * pressure /
+                                              (t + 273.15f));
+  return metrics;
+}
+
+typedef PsychroMetrics (*DeriveFunction)(int16_t, int16_t);
+
+/**
+ * Time one implementation over the whole grid
+ *
+ * @return Nanoseconds per reading
+ */
+static double timeVariant(const char *name, DeriveFunction function,
+                          int rounds) {
+  volatile int32_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (int t = BENCH_TEMP_MIN; t <= BENCH_TEMP_MAX; t += 3) {
+      for (int h = 1; h <= BENCH_HUMIDITY_MAX; h += 3) {
+        PsychroMetrics metrics = function((int16_t)t, (int16_t)h);
+        sink += metrics.dewPoint + metrics.absoluteHumidity;
+      }
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  double readings = (double)rounds *
+    ((BENCH_TEMP_MAX - BENCH_TEMP_MIN) / 3 + 1) * (BENCH_HUMIDITY_MAX / 3 + 1);
+  double nanoseconds = seconds * 1e9 / readings;
+  printf("%-8s %8.1f ns/reading\n", name, nanoseconds);
+  return nanoseconds;
+}
+
+int main() {
+  double worstDewPoint = 0, worstHeatIndex = 0, worstAbsolute = 0;
+  double worstSaturation = 0;
+  int16_t worstDewAt[2] = {0, 0};
+  int16_t worstAbsoluteAt[2] = {0, 0};
+  uint32_t clamped = 0;
+
+  for (int t = BENCH_TEMP_MIN; t <= BENCH_TEMP_MAX; t++) {
+    for (int h = 0; h <= BENCH_HUMIDITY_MAX; h++) {
+      PsychroMetrics metrics = Psychrometrics::derive((int16_t)t, (int16_t)h);
+      Reference expected = reference((int16_t)t, (int16_t)h);
+
+      if (expected.dewPoint < PSYCHRO_DEW_POINT_MIN) {
+        clamped += metrics.dewPoint == PSYCHRO_DEW_POINT_MIN * 10 ? 1 : 0;
+      } else {
+        double error = std::fabs(metrics.dewPoint - expected.dewPoint * 10.0);
+        if (error > worstDewPoint) {
+          worstDewPoint = error;
+          worstDewAt[0] = (int16_t)t;
+          worstDewAt[1] = (int16_t)h;
+        }
+      }
+
+      double error = std::fabs(metrics.heatIndex - expected.heatIndex * 10.0);
+      if (error > worstHeatIndex) {
+        worstHeatIndex = error;
+      }
+
+      error = std::fabs(metrics.absoluteHumidity -
+                        expected.absoluteHumidity * 10.0);
+      if (error > worstAbsolute) {
+        worstAbsolute = error;
+        worstAbsoluteAt[0] = (int16_t)t;
+        worstAbsoluteAt[1] = (int16_t)h;
+      }
+    }
+
+    // The table interpolation itself, before any rounding
+    double celsius = t / 10.0;
+    double saturation = PSYCHRO_MAGNUS_A *
+      std::exp(PSYCHRO_MAGNUS_B * celsius / (PSYCHRO_MAGNUS_C + celsius));
+    double relative = std::fabs(Psychrometrics::saturationPressure((int16_t)t) -
+                                saturation) / saturation;
+    if (relative > worstSaturation) {
+      worstSaturation = relative;
+    }
+  }
+
+  printf("Worst error vs libm (double), after rounding to 0.1:\n");
+  printf("  dew point          %.3f °C at %.1f °C %.1f %%RH "
+         "(%u readings below %d °C clamped)\n", worstDewPoint / 10.0,
+         worstDewAt[0] / 10.0, worstDewAt[1] / 10.0, clamped,
+         PSYCHRO_DEW_POINT_MIN);
+  printf("  heat index         %.3f °C\n", worstHeatIndex / 10.0);
+  printf("  absolute humidity  %.3f g/m³ at %.1f °C %.1f %%RH\n",
+         worstAbsolute / 10.0, worstAbsoluteAt[0] / 10.0,
+         worstAbsoluteAt[1] / 10.0);
+  printf("  saturation pressure %.3f %% relative (table interpolation)\n",
+         worstSaturation * 100.0);
+
+  printf("\nTiming over the grid:\n");
+  double tables = timeVariant("tables", Psychrometrics::derive, 20);
+  double libm = timeVariant("libm", libmDerive, 20);
+  printf("Tables are %.1fx faster\n", libm / tables);
+
+  bool ok = worstDewPoint <= LIMIT_DEW_POINT &&
+            worstHeatIndex <= LIMIT_HEAT_INDEX &&
+            worstAbsolute <= LIMIT_ABSOLUTE_HUMIDITY &&
+            worstSaturation <= LIMIT_SATURATION;
+  printf(ok ? "Within documented bounds\n" : "FAIL: error bound exceeded\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+/**
+ * ESP32 Room Climate Monitor - Sample Log Host Simulation
+ *
+ * Runs the flash sample log from lib/SampleLog against a file-backed
+ * block device on Linux. Simulates days of readings from several
+ * sensors with periodic reboots (remounts), then checks that:
+ * - every flushed raw sample in the newest segments survives a remount
+ * - log time continues monotonically across reboots
+ * - compaction keeps the log within the device and produces 10-minute
+ *   and hourly averages for old data
+ * and reports flash wear (erases per block, bytes programmed).
+ *
+ * Build and run on Linux from the project root:
+ *   g++ -O2 -std=c++17 -Ilib/SampleLog -Ilib/ModbusRTU \
+ *       tools/sample_log_sim.cpp lib/SampleLog/SampleLog.cpp \
+ *       lib/SampleLog/FileBlockDevice.cpp lib/ModbusRTU/ModbusCRC.cpp \
+ *       -o sample_log_sim && ./sample_log_sim
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include "FileBlockDevice.h"
+#include "SampleLog.h"
+
+#define SIM_BLOCK_SIZE      4096
+#define SIM_BLOCK_COUNT     48
+#define SIM_SENSORS         3
+#define SIM_INTERVAL_S      2        // Seconds between readings per sensor
+#define SIM_FLUSH_S         60       // Batch flush interval
+#define SIM_REBOOT_S        21600    // Remount every 6 simulated hours
+
+struct QueryResult {
+  uint32_t records[SAMPLE_LOG_LEVELS];
+  uint32_t lastTime;
+  bool ordered;
+};
+
+static void countRecord(const SampleLogRecord &record, void *context) {
+  QueryResult *result = (QueryResult *)context;
+  result->records[record.level]++;
+  if (record.level == 0) {
+    if (record.time < result->lastTime) {
+      result->ordered = false;
+    }
+    result->lastTime = record.time;
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "sample_log.img";
+  uint32_t days = argc > 2 ? strtoul(argv[2], nullptr, 0) : 7;
+  remove(path);
+
+  FileBlockDevice device;
+  if (!device.open(path, SIM_BLOCK_SIZE, SIM_BLOCK_COUNT)) {
+    printf("FAIL: cannot open %s\n", path);
+    return 1;
+  }
+
+  SampleLog log;
+  if (!log.mount(&device)) {
+    printf("FAIL: mount\n");
+    return 1;
+  }
+
+  bool ok = true;
+  uint32_t bootTime = log.nextTime();
+  uint32_t lastFlush = 0;
+  uint32_t reboots = 0;
+  uint64_t samples = 0;
+  uint32_t duration = days * 86400;
+
+  for (uint32_t uptime = 0; uptime < duration; uptime += SIM_INTERVAL_S) {
+    uint32_t time = bootTime + uptime % SIM_REBOOT_S;
+
+    for (uint8_t sensor = 1; sensor <= SIM_SENSORS; sensor++) {
+      int16_t temperature = (int16_t)(220 + sensor * 10 + (uptime / 600) % 30);
+      int16_t humidity = (int16_t)(450 + (uptime / 300) % 50);
+      log.append(time, sensor, temperature, humidity);
+      samples++;
+    }
+
+    if (time - lastFlush >= SIM_FLUSH_S) {
+      log.flush();
+      log.maintain();
+      lastFlush = time;
+    }
+
+    // Simulated reboot: flush, remount and resume from the recovered time
+    if ((uptime + SIM_INTERVAL_S) % SIM_REBOOT_S == 0) {
+      log.flush();
+      uint32_t expected = log.nextTime();
+      if (!log.mount(&device) || log.nextTime() != expected) {
+        printf("FAIL: remount recovered time %u, expected %u\n",
+               log.nextTime(), expected);
+        ok = false;
+      }
+      bootTime = log.nextTime();
+      lastFlush = bootTime;
+      reboots++;
+    }
+  }
+  log.flush();
+
+  // The last hour must be fully present as raw samples
+  QueryResult recent = {};
+  recent.ordered = true;
+  uint32_t end = log.nextTime();
+  log.query(end - 3600, end, countRecord, &recent);
+  uint32_t expectedRecent = (3600 / SIM_INTERVAL_S) * SIM_SENSORS;
+  if (recent.records[0] < expectedRecent - SIM_SENSORS || !recent.ordered) {
+    printf("FAIL: last hour has %u raw records, expected ~%u\n",
+           recent.records[0], expectedRecent);
+    ok = false;
+  }
+
+  QueryResult all = {};
+  all.ordered = true;
+  log.query(0, end, countRecord, &all);
+  SampleLogStats stats = log.stats();
+
+  printf("Simulated %u days, %llu samples, %u reboots\n", days,
+         (unsigned long long)samples, reboots);
+  printf("Records: %u raw, %u 10-min, %u hourly\n", all.records[0],
+         all.records[1], all.records[2]);
+  printf("Segments: %u used, %u free; %u batches, %u compactions, %u dropped\n",
+         stats.segmentsUsed, stats.segmentsFree, stats.batchesWritten,
+         stats.compactions, stats.segmentsDropped);
+  printf("Wear: %u erases (%.1f per block), %.1f KB programmed\n",
+         device.eraseCount(), (double)device.eraseCount() / SIM_BLOCK_COUNT,
+         device.programmedBytes() / 1024.0);
+
+  if (stats.writeErrors > 0) {
+    printf("FAIL: %u write errors\n", stats.writeErrors);
+    ok = false;
+  }
+  if (days >= 2 && (all.records[1] == 0 || all.records[2] == 0)) {
+    printf("FAIL: compaction produced no downsampled records\n");
+    ok = false;
+  }
+
+  printf(ok ? "PASS\n" : "FAIL\n");
+  device.close();
+  remove(path);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/**
+ * ESP32 Room Climate Monitor - Binary Telemetry Decoder
+ *
+ * Turns the console stream of a monitor in binary telemetry mode
+ * ("telemetry binary" command or TELEMETRY_BINARY) into CSV on stdout:
+ *
+ *   time_ms,address,temperature,humidity,status,alert
+ *
+ * Frames are split at 0x00, COBS-decoded and CRC-checked; anything that
+ * does not check out (text printed before the switch, line noise) is
+ * skipped and counted. Log frames go to stderr, and a summary with the
+ * number of bad and missing frames is printed there at the end.
+ *
+ * Build and run on Linux from the project root:
+ *   g++ -O2 -std=c++17 -Ilib/Telemetry -Ilib/ModbusRTU \
+ *       tools/telemetry_decode.cpp lib/Telemetry/TelemetryFrame.cpp \
+ *       lib/ModbusRTU/ModbusCRC.cpp -o telemetry_decode
+ *   stty -F /dev/ttyUSB0 115200 raw && ./telemetry_decode < /dev/ttyUSB0
+ * or decode a capture: ./telemetry_decode capture.bin > samples.csv
+ *
+ * Author: Room Monitor System
+ * Version: 1.0
+ * Date: 2025
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include "TelemetryFrame.h"
+
+struct DecodeStats {
+  uint32_t frames;
+  uint32_t records;
+  uint32_t logLines;
+  uint32_t badFrames;        // Malformed, CRC failure or unknown type
+  uint32_t missingFrames;    // Sequence numbers skipped
+  bool haveSequence;
+  uint8_t nextSequence;
+};
+
+static const char *statusName(uint8_t flags) {
+  if (flags & TELEMETRY_REJECTED) {
+    return "rejected";
+  }
+  if (flags & TELEMETRY_LOST) {
+    return "lost";
+  }
+  return (flags & TELEMETRY_VALID) ? "valid" : "unknown";
+}
+
+static void printDeci(int16_t value) {
+  int32_t magnitude = value < 0 ? -(int32_t)value : value;
+  printf("%s%d.%d", value < 0 ? "-" : "", (int)(magnitude / 10),
+         (int)(magnitude % 10));
+}
+
+static void handleFrame(const uint8_t *encoded, size_t length,
+                        DecodeStats &stats) {
+  if (length == 0) {
+    return; // Back-to-back delimiters
+  }
+  uint8_t buffer[TELEMETRY_MAX_FRAME];
+  TelemetryFrame frame;
+  if (length > TELEMETRY_MAX_FRAME ||
+      !TelemetryDecoder::parse(encoded, length, buffer, frame)) {
+    stats.badFrames++;
+    return;
+  }
+
+  if (stats.haveSequence && frame.sequence != stats.nextSequence) {
+    stats.missingFrames += (uint8_t)(frame.sequence - stats.nextSequence);
+  }
+  stats.haveSequence = true;
+  stats.nextSequence = (uint8_t)(frame.sequence + 1);
+  stats.frames++;
+
+  if (frame.type == TELEMETRY_FRAME_LOG) {
+    fprintf(stderr, "%.*s\n", (int)frame.bodyLength,
+            (const char *)frame.body);
+    stats.logLines++;
+    return;
+  }
+
+  for (size_t i = 0; i < frame.recordCount; i++) {
+    TelemetryRecord record = TelemetryDecoder::record(frame, i);
+    printf("%u,%u,", record.timestampMs, record.address);
+    printDeci(record.temperature);
+    putchar(',');
+    printDeci(record.humidity);
+    printf(",%s,%d\n", statusName(record.flags),
+           (record.flags & TELEMETRY_ALERT) ? 1 : 0);
+    stats.records++;
+  }
+}
+
+int main(int argc, char **argv) {
+  FILE *input = stdin;
+  if (argc > 1) {
+    input = fopen(argv[1], "rb");
+    if (input == nullptr) {
+      perror(argv[1]);
+      return 2;
+    }
+  }
+
+  DecodeStats stats = {};
+  // Oversized frames are still collected up to here, then counted as bad
+  uint8_t frame[TELEMETRY_MAX_FRAME + 1];
+  size_t length = 0;
+
+  printf("time_ms,address,temperature,humidity,status,alert\n");
+  int c;
+  while ((c = fgetc(input)) != EOF) {
+    if (c == 0) {
+      handleFrame(frame, length, stats);
+      length = 0;
+    } else if (length < sizeof(frame)) {
+      frame[length++] = (uint8_t)c;
+    }
+  }
+  if (length > 0) {
+    stats.badFrames++; // Cut off at the end of the capture
+  }
+
+  fprintf(stderr, "Decoded %u frames: %u records, %u log lines; "
+          "%u bad, %u missing\n", stats.frames, stats.records,
+          stats.logLines, stats.badFrames, stats.missingFrames);
+  if (input != stdin) {
+    fclose(input);
+  }
+  return 0;
+}